@@ -315,6 +315,7 @@ void setup() {
  * 
  * The main application loop that handles:
  * - Serial command processing
+ * - Choreography playback
  * - Audio-reactive behavior (when enabled)
  * - State machine updates
  * - Timing management
@@ -329,9 +330,14 @@ void loop() {
         processCommand(input);
     }
     
+    // Stream the running choreography (e.g. singing motion) to the motors
+    billy.updateChoreography();
+    
     // Run audio reactive mode if enabled and not in manual mode
-    // This allows the fish to respond to sound automatically
-    if (fishState.audioReactivityEnabled && !fishState.manualMode) {
+    // This allows the fish to respond to sound automatically. It waits while a
+    // choreography owns the motors.
+    if (fishState.audioReactivityEnabled && !fishState.manualMode &&
+        !billy.isChoreographyPlaying()) {
         updateSoundInput();        // Read and process audio input
         stateMachineBillyBass();   // Update state machine based on audio
     }
@@ -12,13 +12,19 @@
  */
 
 #include "arduinoFFT.h"
+#include "SpectralFeatures.h"
+#include "StreamingSTFT.h"
 
 // ==================== CONFIGURATION ====================
+// FFT frame size; a plain constant so it can also size the buffers below
+const uint16_t FFT_SAMPLES = 64;
+
 // Audio Processing Configuration
 struct {
   // FFT Settings
-  const uint16_t SAMPLES = 64;             // FFT sample size (power of 2)
+  const uint16_t SAMPLES = FFT_SAMPLES;    // FFT sample size (power of 2)
   const uint16_t SAMPLING_FREQUENCY = 1000; // Sampling frequency in Hz
+  const uint16_t HOP = 16;                 // Samples between frames (75% overlap)
   
   // Frequency Thresholds
   const uint8_t SILENCE_THRESHOLD = 10;    // Threshold for detecting silence
@@ -36,13 +42,22 @@ struct {
 struct {
   // Timing (milliseconds)
   const uint16_t BEAT_COOLDOWN_MS = 150;   // Minimum time between beat responses
-  const uint8_t CONSECUTIVE_QUIET_THRESHOLD = 5;  // Frames of quiet before random actions
+  const uint8_t CONSECUTIVE_QUIET_THRESHOLD = 50; // Frames (16 ms each) of quiet before random actions
 } behavior;
 
 // ==================== GLOBAL VARIABLES ====================
-// FFT
-double vReal[64], vImag[64]; 
-ArduinoFFT<double> FFT = ArduinoFFT<double>(vReal, vImag, 64, 1000);
+// Streaming FFT: every sample goes into the ring, a frame is analysed each hop
+double ring[FFT_SAMPLES], vReal[FFT_SAMPLES], vImag[FFT_SAMPLES], windowFactors[FFT_SAMPLES / 2];
+StreamingSTFT<double> STFT = StreamingSTFT<double>(ring, vReal, vImag, windowFactors,
+                                                   audio.SAMPLES, audio.HOP,
+                                                   FFTWindow::Hamming);
+
+// Band features straight from the complex spectrum, one sweep per frame:
+// low band, unused gap, high band
+const uint_fast16_t bandEdges[] = {1, audio.LOW_FREQ_CUTOFF, audio.HIGH_FREQ_START,
+                                   uint_fast16_t(audio.SAMPLES / 2)};
+double bandEnergy[3];
+SpectralFeatures<double> Features = SpectralFeatures<double>(audio.SAMPLES, audio.SAMPLING_FREQUENCY, bandEdges, 3);
 
 // Audio Analysis
 int highFreqMagnitude = 0, lowFreqMagnitude = 0, lastLowMag = 0, soundVolume = 0;
@@ -50,21 +65,21 @@ bool beatDetected = false;
 int consecutiveQuietFrames = 0;
 
 // Timing
-unsigned long currentTime = 0, lastFFTTime = 0, lastBeatTime = 0;
+unsigned long currentTime = 0, lastSampleMicros = 0, lastBeatTime = 0;
 
 // ==================== SETUP & MAIN LOOP ====================
 void setup() {
   pinMode(A0, INPUT);
   Serial.begin(9600);
+  STFT.setCallback(analyzeFrame);
+  lastSampleMicros = micros();
   Serial.println("BTBillyBass Serial Monitor initialized. Waiting for audio input...");
 }
 
 void loop() {
   currentTime = millis();
-  if (currentTime - lastFFTTime > 100) {
-    performFFTAnalysis();
-    lastFFTTime = currentTime;
-  }
+  beatDetected = false;
+  sampleAudio();
   
   // Print status information about what would have happened
   if (beatDetected) {
@@ -92,34 +107,38 @@ void loop() {
 }
 
 // ==================== AUDIO ANALYSIS ====================
-void performFFTAnalysis() {
-  // Sample audio input
-  for (int i = 0; i < audio.SAMPLES; i++) {
-    vReal[i] = analogRead(A0);
-    vImag[i] = 0;
-    delayMicroseconds(1000000/audio.SAMPLING_FREQUENCY);
+// Take one sample when it is due; frames are analysed by analyzeFrame() as
+// the STFT produces them
+void sampleAudio() {
+  const unsigned long period = 1000000UL / audio.SAMPLING_FREQUENCY;
+  unsigned long now = micros();
+  if (now - lastSampleMicros < period) {
+    return;
   }
+  // Samples missed during a stall (e.g. blocking serial output) are dropped:
+  // reading them late in a burst would squeeze them in time and skew the
+  // spectrum, so the grid restarts from now instead
+  lastSampleMicros = (now - lastSampleMicros >= 2 * period) ? now : lastSampleMicros + period;
+  STFT.push(double(analogRead(A0)));
+}
 
-  // Process FFT
-  FFT.windowing(FFT_WIN_TYP_HAMMING, FFT_FORWARD);
-  FFT.compute(FFT_FORWARD);
-  FFT.complexToMagnitude();
-
-  // Calculate frequency bands
-  lowFreqMagnitude = highFreqMagnitude = 0;
-  int lowBandCount = 0, highBandCount = 0;
-  
-  for (int i = 1; i < audio.LOW_FREQ_CUTOFF; i++) {
-    lowFreqMagnitude += vReal[i];
-    lowBandCount++;
+// Mean magnitude of bins first up to last, from the per-bin energies
+// SpectralFeatures leaves in vReal; the thresholds are tuned on this level
+double meanMagnitude(const double *energy, uint_fast16_t first, uint_fast16_t last) {
+  double sum = 0;
+  for (uint_fast16_t i = first; i < last; i++) {
+    sum += sqrt(energy[i]);
   }
-  lowFreqMagnitude = lowBandCount > 0 ? lowFreqMagnitude / lowBandCount : 0;
-  
-  for (int i = audio.HIGH_FREQ_START; i < audio.SAMPLES/2; i++) {
-    highFreqMagnitude += vReal[i];
-    highBandCount++;
-  }
-  highFreqMagnitude = highBandCount > 0 ? highFreqMagnitude / highBandCount : 0;
+  return last > first ? sum / (last - first) : 0;
+}
+
+void analyzeFrame(double *vReal, double *vImag, uint_fast16_t samples, void *context) {
+  // Band levels: one sweep for the energies, sqrt() only over the two bands
+  SpectralFrame<double> features;
+  features.bands = bandEnergy;
+  Features.analyze(vReal, vImag, features);
+  lowFreqMagnitude = meanMagnitude(vReal, bandEdges[0], bandEdges[1]);
+  highFreqMagnitude = meanMagnitude(vReal, bandEdges[2], bandEdges[3]);
 
   // Beat detection
   static int lastHighMag = 0;
@@ -142,7 +161,10 @@ void performFFTAnalysis() {
   
   soundVolume = max(lowFreqMagnitude, highFreqMagnitude);
   
-  // Debug output - this is the main serial monitoring component
+  // Debug output - this is the main serial monitoring component, about 10 lines/s
+  if (STFT.frameCount() % 6 != 0) {
+    return;
+  }
   Serial.print("Low: ");
   Serial.print(lowFreqMagnitude);
   Serial.print(" | High: ");
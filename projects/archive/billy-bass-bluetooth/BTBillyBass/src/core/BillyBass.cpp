@@ -1,4 +1,5 @@
 #include "BillyBass.h"
+#include "ChoreoSinging.h"
 #include "../utils/Debug.h"
 #include <Arduino.h>
 
@@ -12,7 +13,9 @@ BillyBass::BillyBass() :
     _motorSpeed(DEFAULT_SPEED),
     _movementDuration(DEFAULT_DURATION),
     _motorState(0),
-    _bodySpeed(0) {}
+    _bodySpeed(0),
+    _mouthTrackValue(0),
+    _bodyTrackValue(0) {}
 
 // Initialization
 void BillyBass::begin() {
@@ -22,10 +25,10 @@ void BillyBass::begin() {
 }
 
 // Basic Movement Commands
-void BillyBass::openMouth() {
+void BillyBass::openMouth(uint8_t speed) {
     if (!isMouthOpen()) {
         DEBUG_PRINTLN(F("Opening mouth"));
-        mouthMotor.setSpeed(calibration.mouthSpeed);
+        mouthMotor.setSpeed(speed ? speed : calibration.mouthSpeed);
         mouthMotor.forward();
         delay(calibration.mouthOpenTime);
         mouthMotor.halt();
@@ -101,31 +104,73 @@ void BillyBass::resetMotorsToHome() {
 
 void BillyBass::singingMotion() {
     DEBUG_PRINTLN(F("Singing motion"));
-    
-    // Simple singing pattern with safety checks
-    for (int i = 0; i < 3; i++) {
-        if (!mouthMotor.isSafeToMove()) break;
-        
-        openMouth();
-        if (mouthMotor.needsCooldown()) {
-            delay(MOTOR_COOLDOWN_TIME);
-        }
-        
-        closeMouth();
-        if (mouthMotor.needsCooldown()) {
-            delay(MOTOR_COOLDOWN_TIME);
-        }
+    playChoreography(CHOREO_SINGING);
+}
+
+// Choreography Playback
+bool BillyBass::playChoreography(const uint8_t* choreography) {
+    stopChoreography();
+    return _choreography.begin(choreography, millis());
+}
+
+void BillyBass::stopChoreography() {
+    if (!_choreography.isPlaying()) return;
+
+    _choreography.stop();
+    applyTrackValue(mouthMotor, 0, _mouthTrackValue, MOUTH_OPEN_BIT);
+    applyTrackValue(bodyMotor, 0, _bodyTrackValue, BODY_MOVED_BIT);
+}
+
+bool BillyBass::updateChoreography() {
+    if (!_choreography.isPlaying()) return false;
+
+    bool playing = _choreography.update(millis());
+
+    // A two-motor fish flaps its tail by running the body motor backward
+    int16_t body = _choreography.trackValue(CHOREO_TRACK_BODY);
+    if (body == 0) {
+        body = -abs(_choreography.trackValue(CHOREO_TRACK_TAIL));
     }
+
+    applyTrackValue(mouthMotor, _choreography.trackValue(CHOREO_TRACK_MOUTH), _mouthTrackValue,
+                    MOUTH_OPEN_BIT);
+    applyTrackValue(bodyMotor, body, _bodyTrackValue, BODY_MOVED_BIT);
+    return playing;
+}
+
+bool BillyBass::isChoreographyPlaying() const {
+    return _choreography.isPlaying();
+}
+
+void BillyBass::applyTrackValue(BillyBassMotor& motor, int16_t value, int16_t& lastValue,
+                                uint8_t stateBit) {
+    value = constrain(value, -(int16_t)MAX_SPEED, (int16_t)MAX_SPEED);
     
-    if (bodyMotor.isSafeToMove()) {
-        flapTail();
-        if (bodyMotor.needsCooldown()) {
-            delay(MOTOR_COOLDOWN_TIME);
+    // Same protection as the blocking moves; hold the motor until it is safe
+    // again, then the cleared cache lets the keyframe through
+    if (value != 0 && (!motor.isSafeToMove() || motor.needsCooldown())) {
+        if (lastValue != 0) {
+            motor.halt();
+            lastValue = 0;
         }
-        bodyForward();
+        return;
     }
     
-    DEBUG_PRINTLN(F("Singing motion completed"));
+    if (value == lastValue) return;
+    lastValue = value;
+
+    // Forward opens the mouth or moves the body out, backward returns it
+    if (value == 0) {
+        motor.halt();
+    } else if (value > 0) {
+        motor.setSpeed(value);
+        motor.forward();
+        _motorState |= stateBit;
+    } else {
+        motor.setSpeed(-value);
+        motor.backward();
+        _motorState &= ~stateBit;
+    }
 }
 
 // Audio Reactive Methods
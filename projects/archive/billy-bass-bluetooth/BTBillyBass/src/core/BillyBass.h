@@ -2,6 +2,7 @@
 #define BILLYBASS_H
 
 #include "../drivers/BillyBassMotor.h"
+#include "Choreography.h"
 #include "Config.h"
 
 /**
@@ -51,9 +52,11 @@ public:
      * Activates the mouth motor to open the jaw mechanism.
      * Uses calibrated timing and speed settings.
      * 
+     * @param speed Motor speed (0-255), e.g. from the lip-sync engine;
+     *              0 uses the calibrated mouth speed
      * @see setMouthTiming(), setMouthSpeed()
      */
-    void openMouth();
+    void openMouth(uint8_t speed = 0);
     
     /**
      * @brief Close the fish's mouth
@@ -98,9 +101,11 @@ public:
     /**
      * @brief Execute a singing motion sequence
      * 
-     * Performs a coordinated sequence of mouth and body movements
-     * that simulates the fish singing. Combines mouth opening/closing
-     * with body movement for a natural singing appearance.
+     * Starts the built-in singing choreography: a coordinated sequence of
+     * mouth and body movements that simulates the fish singing. Returns
+     * immediately; updateChoreography() advances it from loop().
+     * 
+     * @see playChoreography()
      */
     void singingMotion();
     
@@ -124,6 +129,46 @@ public:
      */
     void articulateBody(bool isTalking);
     
+    // ===== Choreography Playback =====
+    
+    /**
+     * @brief Start playing a compiled choreography
+     * 
+     * Keyframes are streamed from flash while playing, nothing is copied
+     * into RAM. Replaces any choreography that is already running.
+     * 
+     * @param choreography Choreography blob in PROGMEM (see ChoreoFormat.h)
+     * @return True if playback started, false if the blob is invalid
+     * @see updateChoreography(), stopChoreography()
+     */
+    bool playChoreography(const uint8_t* choreography);
+    
+    /**
+     * @brief Stop the running choreography and halt its motors
+     * 
+     * @see playChoreography()
+     */
+    void stopChoreography();
+    
+    /**
+     * @brief Drive the motors from the running choreography
+     * 
+     * Must be called from loop() on every pass while a choreography plays.
+     * Motor commands are only issued when a track's speed changes, so nothing
+     * else should drive the motors until isChoreographyPlaying() is false.
+     * 
+     * @return True while the choreography is still playing
+     * @see playChoreography()
+     */
+    bool updateChoreography();
+    
+    /**
+     * @brief Check if a choreography is playing
+     * 
+     * @return True while a choreography is running
+     */
+    bool isChoreographyPlaying() const;
+    
     // ===== Settings and Configuration =====
     
     /**
@@ -229,10 +274,27 @@ private:
      */
     void moveMotor(BillyBassMotor* motor, uint8_t speed, bool forward, uint16_t duration);
     
+    /**
+     * @brief Apply a signed choreography speed to a motor
+     * 
+     * Holds the motor stopped while isSafeToMove() or needsCooldown() forbid
+     * moving it, and keeps the position bits of _motorState in step.
+     * 
+     * @param motor Motor to drive
+     * @param value Signed speed (positive forward, negative backward, 0 stop)
+     * @param lastValue Previously applied speed, updated when it changes
+     * @param stateBit _motorState bit set by forward and cleared by backward
+     */
+    void applyTrackValue(BillyBassMotor& motor, int16_t value, int16_t& lastValue,
+                         uint8_t stateBit);
+    
     uint8_t _motorSpeed;        ///< Current speed setting for all motors
     uint16_t _movementDuration; ///< Current duration setting for movements
     uint8_t _motorState;        ///< Bit flags tracking motor positions
     uint8_t _bodySpeed;         ///< Specific speed for body articulation
+    ChoreographyPlayer _choreography; ///< Streaming choreography decoder
+    int16_t _mouthTrackValue;   ///< Last speed applied to the mouth by a choreography
+    int16_t _bodyTrackValue;    ///< Last speed applied to the body by a choreography
 };
 
 // Global instance for easy access throughout the application
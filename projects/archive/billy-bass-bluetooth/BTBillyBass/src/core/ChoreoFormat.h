@@ -0,0 +1,68 @@
+#ifndef CHOREOFORMAT_H
+#define CHOREOFORMAT_H
+
+#include <stdint.h>
+
+/**
+ * @file ChoreoFormat.h
+ * @brief Binary layout of compiled choreographies
+ *
+ * A choreography is a read-only byte blob (kept in PROGMEM on the Arduino)
+ * holding one keyframe stream per motor track. This header only describes
+ * the layout so it can be shared by the firmware decoder and the host
+ * compiler in `tools/choreoc/`; it has no Arduino dependencies.
+ *
+ * Layout:
+ * ```
+ * Header
+ *   'B' 'C'            magic
+ *   version            CHOREO_VERSION
+ *   trackCount         1..CHOREO_MAX_TRACKS
+ *   offset[trackCount] uint16 little-endian, start of each track from blob start
+ *
+ * Keyframe (repeated per track, terminated by an end keyframe)
+ *   delta              time since the previous keyframe of this track in ms,
+ *                      unsigned LEB128 varint (7 bits per byte, MSB = more)
+ *   control            bits 0-1 direction, bits 2-3 easing
+ *   speed              target PWM speed 0-255, only present for
+ *                      CHOREO_DIR_FORWARD / CHOREO_DIR_BACKWARD
+ * ```
+ *
+ * Each keyframe is the value a motor reaches at its time stamp; the easing
+ * describes how the speed travels there from the previous keyframe. Speeds
+ * are signed by direction while interpolating, so a linear keyframe from
+ * forward to backward passes through a stop.
+ *
+ * @author Arduino Community
+ * @version 1.0
+ * @date 2024
+ */
+
+const uint8_t CHOREO_MAGIC_0 = 'B';     ///< First magic byte
+const uint8_t CHOREO_MAGIC_1 = 'C';     ///< Second magic byte
+const uint8_t CHOREO_VERSION = 1;       ///< Current format version
+const uint8_t CHOREO_MAX_TRACKS = 3;    ///< Highest track count a player supports
+const uint8_t CHOREO_HEADER_SIZE = 4;   ///< Bytes before the track offset table
+
+// ===== Track Assignment =====
+const uint8_t CHOREO_TRACK_MOUTH = 0;   ///< Mouth/jaw motor
+const uint8_t CHOREO_TRACK_BODY = 1;    ///< Body motor (forward = head, backward = tail)
+const uint8_t CHOREO_TRACK_TAIL = 2;    ///< Dedicated tail motor (three-motor fish only)
+
+// ===== Control Byte =====
+const uint8_t CHOREO_DIR_MASK = 0x03;       ///< Direction bits
+const uint8_t CHOREO_DIR_STOP = 0x00;       ///< Motor stopped, no speed byte
+const uint8_t CHOREO_DIR_FORWARD = 0x01;    ///< Forward at speed
+const uint8_t CHOREO_DIR_BACKWARD = 0x02;   ///< Backward at speed
+const uint8_t CHOREO_DIR_END = 0x03;        ///< End of track, motor stops
+
+const uint8_t CHOREO_EASE_SHIFT = 2;        ///< Position of the easing bits
+const uint8_t CHOREO_EASE_MASK = 0x0C;      ///< Easing bits
+const uint8_t CHOREO_EASE_STEP = 0;         ///< Hold previous speed, jump at the keyframe
+const uint8_t CHOREO_EASE_LINEAR = 1;       ///< Linear ramp from previous keyframe
+const uint8_t CHOREO_EASE_IN = 2;           ///< Quadratic ramp, slow start
+const uint8_t CHOREO_EASE_OUT = 3;          ///< Quadratic ramp, slow finish
+
+const uint8_t CHOREO_VARINT_MORE = 0x80;    ///< Continuation bit of a delta byte
+
+#endif // CHOREOFORMAT_H
@@ -0,0 +1,17 @@
+// Generated by tools/choreoc from choreo/singing.txt - do not edit.
+#ifndef CHOREO_SINGING_H
+#define CHOREO_SINGING_H
+
+#include <Arduino.h>
+
+const uint16_t CHOREO_SINGING_SIZE = 53;
+
+const uint8_t CHOREO_SINGING[] PROGMEM = {
+    0x42, 0x43, 0x01, 0x02, 0x08, 0x00, 0x24, 0x00, 0x00, 0x01, 0x64, 0x90,
+    0x03, 0x02, 0x64, 0x90, 0x03, 0x01, 0x64, 0x90, 0x03, 0x02, 0x64, 0x90,
+    0x03, 0x01, 0x64, 0x90, 0x03, 0x02, 0x64, 0x90, 0x03, 0x00, 0x00, 0x03,
+    0xE0, 0x12, 0x02, 0x64, 0xA0, 0x06, 0x01, 0x64, 0xD8, 0x04, 0x01, 0x64,
+    0xC8, 0x01, 0x04, 0x00, 0x03,
+};
+
+#endif // CHOREO_SINGING_H
@@ -0,0 +1,144 @@
+#include "Choreography.h"
+#include "../utils/Debug.h"
+
+// Constructor
+ChoreographyPlayer::ChoreographyPlayer() : _data(nullptr), _trackCount(0) {}
+
+// Playback Control
+bool ChoreographyPlayer::begin(const uint8_t* data, unsigned long startTime) {
+    stop();
+
+    if (data == nullptr) return false;
+
+    _data = data;
+    if (readByte(0) != CHOREO_MAGIC_0 || readByte(1) != CHOREO_MAGIC_1 ||
+        readByte(2) != CHOREO_VERSION) {
+        DEBUG_PRINTLN(F("Choreography rejected: bad header"));
+        _data = nullptr;
+        return false;
+    }
+
+    // Tracks beyond what this player drives are skipped, not rejected
+    _trackCount = min(readByte(3), CHOREO_MAX_TRACKS);
+
+    for (uint8_t i = 0; i < _trackCount; i++) {
+        TrackState& track = _tracks[i];
+        uint16_t entry = CHOREO_HEADER_SIZE + i * 2;
+        track.cursor = readByte(entry) | (uint16_t(readByte(entry + 1)) << 8);
+        track.toTime = startTime;
+        track.toValue = 0;
+        track.value = 0;
+        track.done = false;
+        readKeyframe(track);
+    }
+
+    DEBUG_PRINT(F("Choreography started, tracks: "));
+    DEBUG_PRINTLN(_trackCount);
+    return true;
+}
+
+void ChoreographyPlayer::stop() {
+    _data = nullptr;
+    _trackCount = 0;
+}
+
+bool ChoreographyPlayer::update(unsigned long now) {
+    bool playing = false;
+
+    for (uint8_t i = 0; i < _trackCount; i++) {
+        TrackState& track = _tracks[i];
+
+        // Consume every keyframe that is already due
+        while (!track.done && (long)(now - track.toTime) >= 0) {
+            if (track.atEnd) {
+                track.done = true;
+            } else {
+                readKeyframe(track);
+            }
+        }
+
+        track.value = track.done ? 0 : interpolate(track, now);
+        playing |= !track.done;
+    }
+
+    if (!playing && _trackCount > 0) {
+        DEBUG_PRINTLN(F("Choreography finished"));
+        stop();
+    }
+    return playing;
+}
+
+// State Queries
+bool ChoreographyPlayer::isPlaying() const {
+    return _trackCount > 0;
+}
+
+uint8_t ChoreographyPlayer::trackCount() const {
+    return _trackCount;
+}
+
+int16_t ChoreographyPlayer::trackValue(uint8_t track) const {
+    if (track >= _trackCount) return 0;
+    return _tracks[track].value;
+}
+
+// Decoding
+void ChoreographyPlayer::readKeyframe(TrackState& track) {
+    // The keyframe we just reached becomes the start of the next segment
+    track.fromTime = track.toTime;
+    track.fromValue = track.toValue;
+
+    // Delta time, LEB128 varint
+    unsigned long delta = 0;
+    uint8_t shift = 0;
+    uint8_t byte;
+    do {
+        byte = readByte(track.cursor++);
+        delta |= (unsigned long)(byte & ~CHOREO_VARINT_MORE) << shift;
+        shift += 7;
+    } while ((byte & CHOREO_VARINT_MORE) && shift < 28);
+
+    uint8_t control = readByte(track.cursor++);
+    uint8_t direction = control & CHOREO_DIR_MASK;
+
+    track.toTime = track.fromTime + delta;
+    track.easing = (control & CHOREO_EASE_MASK) >> CHOREO_EASE_SHIFT;
+    track.atEnd = direction == CHOREO_DIR_END;
+
+    if (direction == CHOREO_DIR_FORWARD) {
+        track.toValue = readByte(track.cursor++);
+    } else if (direction == CHOREO_DIR_BACKWARD) {
+        track.toValue = -int16_t(readByte(track.cursor++));
+    } else {
+        track.toValue = 0;
+    }
+}
+
+int16_t ChoreographyPlayer::interpolate(const TrackState& track, unsigned long now) const {
+    unsigned long span = track.toTime - track.fromTime;
+    if (track.easing == CHOREO_EASE_STEP || span == 0) {
+        return track.fromValue;
+    }
+
+    // Progress through the segment as 0..255 fixed point
+    uint16_t t = (uint16_t)(((now - track.fromTime) << 8) / span);
+    if (t > 255) t = 255;
+
+    switch (track.easing) {
+        case CHOREO_EASE_IN:
+            t = (t * t) >> 8;
+            break;
+        case CHOREO_EASE_OUT:
+            t = 255 - (((255 - t) * (255 - t)) >> 8);
+            break;
+        default:
+            break;
+    }
+
+    int16_t range = track.toValue - track.fromValue;
+    return track.fromValue + (int16_t)(((int32_t)range * t) >> 8);
+}
+
+uint8_t ChoreographyPlayer::readByte(uint16_t offset) const {
+    return pgm_read_byte(_data + offset);
+}
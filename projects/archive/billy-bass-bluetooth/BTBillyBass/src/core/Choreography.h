@@ -0,0 +1,134 @@
+#ifndef CHOREOGRAPHY_H
+#define CHOREOGRAPHY_H
+
+#include <Arduino.h>
+#include "ChoreoFormat.h"
+
+/**
+ * @file Choreography.h
+ * @brief Streaming decoder for compiled choreographies stored in flash
+ *
+ * The player reads keyframes straight out of PROGMEM as playback advances,
+ * so a song of any length costs a few bytes of RAM per track. Only the
+ * current segment (previous and next keyframe) of each track is held.
+ *
+ * @author Arduino Community
+ * @version 1.0
+ * @date 2024
+ *
+ * @example
+ * ```cpp
+ * ChoreographyPlayer player;
+ * player.begin(CHOREO_SINGING, millis());
+ * while (player.update(millis())) {
+ *     int16_t mouth = player.trackValue(CHOREO_TRACK_MOUTH);
+ * }
+ * ```
+ */
+class ChoreographyPlayer {
+public:
+    /**
+     * @brief Default constructor
+     *
+     * Creates an idle player. Call begin() to start a choreography.
+     */
+    ChoreographyPlayer();
+
+    /**
+     * @brief Start playing a choreography
+     *
+     * Validates the header and primes the first keyframe of every track.
+     *
+     * @param data Choreography blob in PROGMEM
+     * @param startTime Time in milliseconds that maps to keyframe time zero
+     * @return True if the blob was accepted, false if the header is invalid
+     */
+    bool begin(const uint8_t* data, unsigned long startTime);
+
+    /**
+     * @brief Stop playback immediately
+     *
+     * All track values drop to zero on the next query.
+     */
+    void stop();
+
+    /**
+     * @brief Advance all tracks to the given time
+     *
+     * Consumes every keyframe that is due and interpolates the current
+     * segment. Call this from loop() as often as possible.
+     *
+     * @param now Current time in milliseconds
+     * @return True while at least one track is still playing
+     */
+    bool update(unsigned long now);
+
+    /**
+     * @brief Check whether a choreography is playing
+     *
+     * @return True until every track has passed its end keyframe
+     */
+    bool isPlaying() const;
+
+    /**
+     * @brief Get the number of tracks in the current choreography
+     *
+     * @return Track count, 0 when idle
+     */
+    uint8_t trackCount() const;
+
+    /**
+     * @brief Get the signed motor speed of a track at the last update()
+     *
+     * @param track Track index (CHOREO_TRACK_MOUTH, CHOREO_TRACK_BODY, ...)
+     * @return Speed -255..255; positive is forward, negative backward, 0 stopped
+     */
+    int16_t trackValue(uint8_t track) const;
+
+private:
+    /**
+     * @brief Decoder state of one track
+     *
+     * Holds the segment between the previous and the next keyframe.
+     */
+    struct TrackState {
+        uint16_t cursor;            ///< Offset of the keyframe after `toTime`
+        unsigned long fromTime;     ///< Time of the previous keyframe (ms)
+        unsigned long toTime;       ///< Time of the next keyframe (ms)
+        int16_t fromValue;          ///< Signed speed at the previous keyframe
+        int16_t toValue;            ///< Signed speed at the next keyframe
+        int16_t value;              ///< Interpolated speed at the last update
+        uint8_t easing;             ///< Easing towards the next keyframe
+        bool atEnd;                 ///< Next keyframe is the end marker
+        bool done;                  ///< End marker has been reached
+    };
+
+    /**
+     * @brief Read the next keyframe of a track into its segment
+     *
+     * @param track Track state to advance
+     */
+    void readKeyframe(TrackState& track);
+
+    /**
+     * @brief Interpolate a track's speed inside its current segment
+     *
+     * @param track Track state
+     * @param now Current time in milliseconds
+     * @return Signed speed at `now`
+     */
+    int16_t interpolate(const TrackState& track, unsigned long now) const;
+
+    /**
+     * @brief Read one byte of the choreography from flash
+     *
+     * @param offset Byte offset from the blob start
+     */
+    uint8_t readByte(uint16_t offset) const;
+
+    const uint8_t* _data;                   ///< Choreography blob in PROGMEM
+    uint8_t _trackCount;                    ///< Tracks in the current blob
+    TrackState _tracks[CHOREO_MAX_TRACKS];  ///< Per-track decoder state
+};
+
+#endif // CHOREOGRAPHY_H
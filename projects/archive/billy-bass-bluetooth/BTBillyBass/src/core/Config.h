@@ -190,6 +190,24 @@ struct MovementCalibration {
  */
 const uint16_t SILENCE_THRESHOLD = 12;
 
+/**
+ * @brief Length of one lip-sync frame (ms)
+ * 
+ * Sound levels read during one frame are reduced to a single RMS value
+ * by the shared LipSync engine (shared/libraries/LipSync), which then
+ * decides whether the mouth opens, stays or closes.
+ */
+const uint16_t LIPSYNC_FRAME_MS = 20;
+
+/**
+ * @brief Sound level that opens the mouth at full speed
+ * 
+ * Frames between SILENCE_THRESHOLD and this level open the mouth at
+ * speeds from LIPSYNC_SPEED_MIN up to 255.
+ */
+const uint16_t LIPSYNC_LEVEL_MAX = 300;
+const uint8_t LIPSYNC_SPEED_MIN = 100;  ///< Mouth speed for the quietest speech
+
 // ===== State Definitions =====
 /**
  * @brief State constants for the fish's behavior state machine
@@ -1,14 +1,42 @@
 #include "StateMachine.h"
 #include "../utils/Debug.h"
 #include <Arduino.h>
+#include <LipSync.h>
+
+/**
+ * Lip-sync tuning for the sound sensor: the engine's defaults are for
+ * 16-bit PCM, the sensor reads a few hundred at most
+ */
+static LipSyncConfig lipSyncConfig() {
+    LipSyncConfig config;
+    config.threshold = SILENCE_THRESHOLD;
+    config.rmsLow = SILENCE_THRESHOLD;
+    config.rmsHigh = LIPSYNC_LEVEL_MAX;
+    config.speedMin = LIPSYNC_SPEED_MIN;
+    config.speedMax = 255;
+    config.headHoldMs = PAUSE_TIME;
+    return config;
+}
+
+static LipSync lipSync(lipSyncConfig());
+static LipSyncCommand lipSyncCommand;    // Command of the frame closed this loop
+static unsigned long frameStart = 0;
 
 /**
  * Updates sound input from analog pin
- * Reads the current sound level and stores it in the global soundVolume variable
+ * Reads the current sound level, stores it in the global soundVolume variable
+ * and feeds it to the lip-sync engine, which closes a frame every LIPSYNC_FRAME_MS
  */
 void updateSoundInput() {
     // Read analog input and update sound volume
     fishState.soundVolume = analogRead(SOUND_PIN);
+    lipSync.push(fishState.soundVolume);
+    
+    lipSyncCommand = LipSyncCommand();
+    if (timing.current - frameStart >= LIPSYNC_FRAME_MS) {
+        lipSyncCommand = lipSync.update(timing.current, calibration.mouthOpenTime);
+        frameStart = timing.current;
+    }
     
     // Only print debug if volume is above threshold and debug mode is on
     if (debugMode && fishState.soundVolume > SILENCE_THRESHOLD) {
@@ -35,10 +63,11 @@ void stateMachineBillyBass() {
     
     switch (fishState.state) {
         case STATE_WAITING: // Waiting for input
-            // Check for sound above threshold
-            if (fishState.soundVolume > SILENCE_THRESHOLD && timing.current > timing.mouthAction) { 
+            // Check for a frame loud enough to open the mouth
+            if (lipSyncCommand.mouth == LIPSYNC_MOUTH_OPEN && timing.current > timing.mouthAction) { 
                 fishState.talking = true; 
                 timing.mouthAction = timing.current + PAUSE_TIME;
+                billy.openMouth(lipSyncCommand.mouthSpeed);
                 fishState.state = STATE_TALKING; // Transition to talking state
             } 
             // Stop motors if beyond scheduled talking time
@@ -56,13 +85,21 @@ void stateMachineBillyBass() {
             break;
 
         case STATE_TALKING: // Talking (mouth moving)
+            // Keep talking while the engine still hears speech
+            if (lipSyncCommand.mouth == LIPSYNC_MOUTH_OPEN) {
+                timing.mouthAction = timing.current + PAUSE_TIME;
+            }
             if (timing.current < timing.mouthAction) { 
                 // If we have a scheduled mouth action in the future
                 if (fishState.talking) { 
-                    // Open mouth and articulate body
-                    billy.openMouth(); 
+                    // Flap the mouth with the syllables and articulate body
+                    if (lipSyncCommand.mouth == LIPSYNC_MOUTH_OPEN) {
+                        billy.openMouth(lipSyncCommand.mouthSpeed);
+                    } else if (lipSyncCommand.mouth == LIPSYNC_MOUTH_STOP) {
+                        billy.closeMouth();
+                    }
                     timing.lastAction = timing.current;
-                    billy.articulateBody(true);
+                    billy.articulateBody(lipSync.talking());
                 }
             }
             else { 
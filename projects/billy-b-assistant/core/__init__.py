@@ -20,6 +20,7 @@ Main Components:
 from .audio import (
     detect_devices,
     ensure_playback_worker_started,
+    load_wake_up_clips,
     play_random_wake_up_clip,
     stop_playback,
     is_billy_speaking,
@@ -3,21 +3,24 @@ Main audio module - provides simplified interface to audio functionality.
 This module consolidates audio device management and playback operations.
 """
 import asyncio
-import base64
 import contextlib
 import json
 import os
-import wave
 from typing import Dict, Any, List, Tuple
 
 import numpy as np
-from scipy.signal import resample
 
 from .audio_device_manager import device_manager
 from .audio_playback import playback_manager
+from .base64_codec import Base64Codec
+from .choreography import load_choreography
 from .config import CHUNK_MS
 from .constants import SONGS_DIR, STATE_PLAYING_SONG, STATE_IDLE
 from .movements import stop_all_motors
+from .pcm_ring import CANCEL, PcmRing
+from .resampler import StreamResampler
+from .stem_index import stem_index
+from .wav_map import open_wav
 
 
 # Expose the main interfaces for backward compatibility
@@ -38,6 +41,13 @@ OUTPUT_CHANNELS = device_manager.output_channels
 OUTPUT_RATE = device_manager.output_rate
 CHUNK_SIZE = device_manager.chunk_size
 
+# Song ring frames at 24 kHz: the decoder runs up to 1 s ahead of the speaker,
+# and the last quarter is kept for the motion thread to catch up on
+SONG_RING_FRAMES = 32768
+
+# What a stem that ended before full.wav yields
+_NO_FRAMES = np.zeros((0, 1), dtype=np.int16)
+
 
 def detect_devices(debug=False):
     """Detect and configure audio devices."""
@@ -73,29 +83,36 @@ def rotate_and_save_response_audio(audio_bytes):
 
 def handle_incoming_audio_chunk(audio_b64, buffer):
     """Handle incoming audio chunk from WebSocket."""
-    audio_chunk = base64.b64decode(audio_b64)
+    audio_chunk = _codec.decode(audio_b64)
     buffer.extend(audio_chunk)
-    playback_queue.put(audio_chunk)
+    playback_queue.put(bytes(audio_chunk))
     return len(audio_chunk)
 
 
+_codec = Base64Codec()
+_mic_resampler = None
+
+
 def send_mic_audio(ws, samples, loop):
     """Send microphone audio to WebSocket."""
-    pcm = (
-        resample(samples, int(len(samples) * 24000 / MIC_RATE))
-        .astype(np.int16)
-        .tobytes()
+    global _mic_resampler
+    if _mic_resampler is None or _mic_resampler.input_rate != MIC_RATE:
+        _mic_resampler = StreamResampler(MIC_RATE, 24000)
+    pcm = _mic_resampler.process(samples)
+    send_mic_message(
+        ws,
+        json.dumps({
+            "type": "input_audio_buffer.append",
+            "audio": _codec.encode(pcm),
+        }),
+        loop,
     )
+
+
+def send_mic_message(ws, message, loop):
+    """Send an encoded input_audio_buffer.append message to WebSocket."""
     try:
-        future = asyncio.run_coroutine_threadsafe(
-            ws.send(
-                json.dumps({
-                    "type": "input_audio_buffer.append",
-                    "audio": base64.b64encode(pcm).decode("utf-8"),
-                })
-            ),
-            loop,
-        )
+        future = asyncio.run_coroutine_threadsafe(ws.send(message), loop)
 
         # Await the result; avoid race conditions.
         future.result()
@@ -108,6 +125,11 @@ def enqueue_wav_to_playback(filepath):
     playback_manager.enqueue_wav_to_playback(filepath)
 
 
+def load_wake_up_clips():
+    """Decode the wake-up clips ahead of the first button press."""
+    playback_manager.load_wake_up_clips()
+
+
 def play_random_wake_up_clip():
     """Select and enqueue a random wake-up WAV file with mouth movement."""
     return playback_manager.play_random_wake_up_clip()
@@ -166,6 +188,36 @@ def load_song_metadata(path: str) -> Dict[str, Any]:
     return metadata
 
 
+def _downmix(frames: np.ndarray) -> np.ndarray:
+    """Mono int16 of a (frames, channels) chunk, as StreamResampler takes it.
+
+    A mono chunk is returned as its own view, so it reaches the native
+    resampler without a copy.
+    """
+    if frames.shape[1] == 1:
+        return frames[:, 0]
+    return frames.mean(axis=1).astype(np.int16)
+
+
+def _fit(samples: np.ndarray, frames: int) -> np.ndarray:
+    """Trim or zero-pad a stem chunk to the main chunk's length."""
+    if len(samples) >= frames:
+        return samples[:frames]
+    return np.pad(samples, (0, frames - len(samples)))
+
+
+async def _write_song_ring(ring: PcmRing, *planes: np.ndarray) -> bool:
+    """Write one chunk of every plane, waiting while the speaker catches up."""
+    done = 0
+    while done < len(planes[0]):
+        if ring.flags & CANCEL:
+            return False
+        done += ring.write(*(plane[done:] for plane in planes))
+        if done < len(planes[0]):
+            await asyncio.sleep(0.005)
+    return True
+
+
 async def play_song(song_name: str):
     """
     Play a full Billy song: main audio, vocals for mouth, drums for tail.
@@ -198,9 +250,22 @@ async def play_song(song_name: str):
     # Set global playback_manager attributes directly if possible, or use the aliases
     playback_manager.compensate_tail_beats = compensate_tail_beats
 
-    head_move_schedule = metadata.get("head_moves", [])
-    for move in head_move_schedule:
-        head_move_queue.put(move)
+    # A precompiled choreo.bbc (tools/choreoc) replaces live stem analysis
+    choreography = load_choreography(SONG_DIR)
+    playback_manager.choreography = choreography
+
+    # Otherwise stem levels indexed once by tools/stemindex replace reading the
+    # vocal and drum stems on every play
+    stems = None
+    if choreography is None:
+        stems = await asyncio.to_thread(stem_index, SONG_DIR, CHUNK_MS, GAIN)
+    playback_manager.stem_index = stems
+    live_stems = choreography is None and stems is None
+
+    if choreography is None:
+        head_move_schedule = metadata.get("head_moves", [])
+        for move in head_move_schedule:
+            head_move_queue.put(move)
 
     playback_manager.beat_length = 60.0 / BPM
     if metadata.get("half_tempo_tail_flap"):
@@ -213,60 +278,81 @@ async def play_song(song_name: str):
     mqtt_publish("billy/state", STATE_PLAYING_SONG)
     print(f"\n🎧 Playing {song_name} with mouth (vocals) and tail (drums) flaps")
 
+    # Stems go through shared memory when tools/pcmring is built: written
+    # once here, read in place by the speaker and the motion thread
+    ring = PcmRing.create(
+        f"/billy-pcm-{os.getpid()}", 3 if live_stems else 1, SONG_RING_FRAMES, 24000
+    )
+    if ring is not None:
+        playback_manager.song_ring = ring
+        playback_queue.put(("song_ring", ring))
+
     try:
         with contextlib.ExitStack() as stack:
-            wf_main = stack.enter_context(wave.open(MAIN_AUDIO, 'rb'))
-            wf_vocals = stack.enter_context(wave.open(VOCALS_AUDIO, 'rb'))
-            wf_drums = stack.enter_context(wave.open(DRUMS_AUDIO, 'rb'))
+            # Chunks are read-only views of the mapped files when tools/wavmap is built
+            wav_main = stack.enter_context(open_wav(MAIN_AUDIO))
+            rate_main = wav_main.sample_rate
+            chunk_size_main = int(rate_main * CHUNK_MS / 1000)
 
-            rate_main = wf_main.getframerate()
-            rate_vocals = wf_vocals.getframerate()
-            rate_drums = wf_drums.getframerate()
+            # One resampler per stem, so filter state carries across chunks
+            resampler_main = StreamResampler(48000, 24000)
+            resampler_vocals = StreamResampler(48000, 24000)
+            resampler_drums = StreamResampler(48000, 24000)
 
-            chunk_size_main = int(rate_main * CHUNK_MS / 1000)
-            chunk_size_vocals = int(rate_vocals * CHUNK_MS / 1000)
-            chunk_size_drums = int(rate_drums * CHUNK_MS / 1000)
+            if live_stems:
+                wav_vocals = stack.enter_context(open_wav(VOCALS_AUDIO))
+                wav_drums = stack.enter_context(open_wav(DRUMS_AUDIO))
 
-            while True:
-                frames_main = wf_main.readframes(chunk_size_main)
-                frames_vocals = wf_vocals.readframes(chunk_size_vocals)
-                frames_drums = wf_drums.readframes(chunk_size_drums)
+                rate_vocals = wav_vocals.sample_rate
+                rate_drums = wav_drums.sample_rate
 
-                if not frames_main:
-                    break
+                chunks_vocals = wav_vocals.chunks(int(rate_vocals * CHUNK_MS / 1000))
+                chunks_drums = wav_drums.chunks(int(rate_drums * CHUNK_MS / 1000))
 
+            for frames_main in wav_main.chunks(chunk_size_main):
                 # --- Main audio (24kHz mono)
-                samples_main = np.frombuffer(frames_main, dtype=np.int16)
-                samples_main = samples_main.reshape((-1, 2)).mean(axis=1)
+                samples_main = _downmix(frames_main)
                 if rate_main == 48000:
-                    samples_main = resample(
-                        samples_main, len(samples_main) // 2
-                    ).astype(np.int16)
+                    samples_main = resampler_main.process(samples_main)
                 samples_main = np.clip(samples_main * GAIN, -32768, 32767).astype(
                     np.int16
                 )
 
+                if not live_stems:
+                    if ring is not None:
+                        if not await _write_song_ring(ring, samples_main):
+                            break
+                    else:
+                        playback_queue.put(("song", samples_main.tobytes(), b"", 0.0))
+                    continue
+
+                frames_vocals = next(chunks_vocals, _NO_FRAMES)
+                frames_drums = next(chunks_drums, _NO_FRAMES)
+
                 # --- Vocals (for mouth flap)
-                samples_vocals = np.frombuffer(frames_vocals, dtype=np.int16)
-                samples_vocals = samples_vocals.reshape((-1, 2)).mean(axis=1)
+                samples_vocals = _downmix(frames_vocals)
                 if rate_vocals == 48000:
-                    samples_vocals = resample(
-                        samples_vocals, len(samples_vocals) // 2
-                    ).astype(np.int16)
+                    samples_vocals = resampler_vocals.process(samples_vocals)
                 samples_vocals = np.clip(samples_vocals * GAIN, -32768, 32767).astype(
                     np.int16
                 )
 
                 # --- Drums (for tail flap)
-                samples_drums = np.frombuffer(frames_drums, dtype=np.int16)
-                samples_drums = samples_drums.reshape((-1, 2)).mean(axis=1)
+                samples_drums = _downmix(frames_drums)
                 if rate_drums == 48000:
-                    samples_drums = resample(
-                        samples_drums, len(samples_drums) // 2
-                    ).astype(np.int16)
+                    samples_drums = resampler_drums.process(samples_drums)
                 samples_drums = np.clip(samples_drums * GAIN, -32768, 32767).astype(
                     np.int16
                 )
+
+                if ring is not None:
+                    frames = len(samples_main)
+                    if not await _write_song_ring(
+                        ring, samples_main, _fit(samples_vocals, frames), _fit(samples_drums, frames)
+                    ):
+                        break
+                    continue
+
                 rms_drums = np.sqrt(np.mean(samples_drums.astype(np.float32) ** 2))
 
                 # --- Enqueue combined chunk
@@ -277,6 +363,8 @@ async def play_song(song_name: str):
                     rms_drums,
                 ))
 
+        if ring is not None:
+            ring.finish()
         print("⌛ Waiting for song playback to complete...")
         await asyncio.to_thread(playback_queue.join)
 
@@ -284,7 +372,14 @@ async def play_song(song_name: str):
         print(f"❌ Playback failed: {e}")
 
     finally:
+        if ring is not None:
+            ring.cancel()
+            await asyncio.to_thread(playback_queue.join)
+            playback_manager.song_ring = None
+            ring.close()
         playback_manager.song_mode = False
+        playback_manager.choreography = None
+        playback_manager.stem_index = None
         stop_all_motors()
         mqtt_publish("billy/state", STATE_IDLE)
         print("🎶 Song finished, waiting for button press.")
@@ -13,7 +13,6 @@ from queue import Queue
 
 import numpy as np
 import sounddevice as sd
-from scipy.signal import resample
 
 from .audio_device_manager import device_manager
 from .config import CHUNK_MS, PLAYBACK_VOLUME, TEXT_ONLY_MODE
@@ -26,7 +25,113 @@ from .constants import (
     WARNING_NO_CUSTOM_CLIPS,
     WARNING_NO_WAKEUP_CLIPS,
 )
-from .movements import flap_from_pcm_chunk, interlude, move_head, move_tail_async, stop_all_motors
+from .choreography import TRACK_BODY, TRACK_MOUTH, TRACK_TAIL
+from .clip_cache import ClipCache
+from .lipsync import MOUTH_OPEN, MOUTH_STOP
+from .pcm_ring import CANCEL, END
+from .resampler import StreamResampler
+from .stem_index import DRUM_ONSET
+from .wav_map import open_wav
+from .movements import (
+    audio_clock,
+    drive_choreography,
+    flap_from_levels,
+    flap_from_pcm_chunk,
+    interlude,
+    move_head,
+    move_mouth,
+    move_tail_async,
+    stop_all_motors,
+    stop_mouth,
+)
+
+
+# Song state shared by the playback worker and the song motion reader
+head_out = False
+
+
+class SongMotion:
+    """
+    Head moves, mouth flaps and tail beats of a song, one chunk at a time.
+    Times are song seconds on the audio clock (frames played / rate), and
+    at_sample is the chunk's frame on movements.audio_clock, so motion keeps
+    to the samples actually heard however far the output buffers run ahead.
+    """
+
+    def __init__(self, manager, chunk_ms):
+        self.manager = manager
+        self.chunk_ms = chunk_ms
+        self.head_move_active = False
+        self.head_move_end_time = 0
+        self.drums_peak = 0
+        self.next_beat_time = 0
+        # Drums that never jump above their own level keep the beat grid
+        index = manager.stem_index
+        self.follow_onsets = index is not None and len(index.onsets()) > 0
+
+    def update_head(self, song_time, at_sample=None):
+        """Start and end the scheduled head moves of the song."""
+        global head_out
+
+        if self.head_move_active and song_time >= self.head_move_end_time:
+            move_head("off", at_sample)
+            head_out = False
+            self.head_move_active = False
+            print("🛑 Head move ended")
+
+        head_move_queue = self.manager.head_move_queue
+        if not self.head_move_active and not head_move_queue.empty():
+            move_time, move_duration = head_move_queue.queue[0]  # peek
+            if song_time >= move_time:
+                head_move_queue.get()
+                move_head("on", at_sample)
+                head_out = True
+                self.head_move_active = True
+                self.head_move_end_time = song_time + move_duration
+                print(f"🐟 Head move started for {move_duration:.2f} seconds")
+
+    def chunk(self, song_time, vocals, rms_drums, at_sample=None):
+        """Move for the chunk starting song_time into the song."""
+        manager = self.manager
+        if manager.choreography is not None:
+            position_ms = song_time * 1000
+            drive_choreography(
+                manager.choreography.value_at(TRACK_MOUTH, position_ms),
+                manager.choreography.value_at(TRACK_BODY, position_ms),
+                manager.choreography.value_at(TRACK_TAIL, position_ms),
+                at_sample=at_sample,
+            )
+            return
+
+        adjusted_now = song_time + manager.compensate_tail_beats * manager.beat_length
+
+        if manager.stem_index is not None:
+            levels = manager.stem_index.at(song_time)
+            rms_drums = 0
+            if levels is not None:
+                flap_from_levels(
+                    levels["vocal_rms"], levels["vocal_peak"],
+                    chunk_ms=self.chunk_ms, at_sample=at_sample,
+                )
+                rms_drums = int(levels["drum_rms"])
+            if self.follow_onsets:
+                # The index marks the drum hits themselves, so the tail lands
+                # on them rather than on a beat grid
+                ahead = manager.stem_index.at(adjusted_now)
+                if ahead is not None and ahead["flags"] & DRUM_ONSET and not head_out:
+                    move_tail_async(duration=0.2, at_sample=at_sample)
+                return
+        else:
+            flap_from_pcm_chunk(vocals, chunk_ms=self.chunk_ms, at_sample=at_sample)
+
+        if rms_drums > self.drums_peak:
+            self.drums_peak = rms_drums
+
+        if adjusted_now >= self.next_beat_time:
+            if self.drums_peak > 1500 and not head_out:
+                move_tail_async(duration=0.2, at_sample=at_sample)
+            self.drums_peak = 0
+            self.next_beat_time += manager.beat_length
 
 
 class AudioPlaybackManager:
@@ -41,6 +146,13 @@ class AudioPlaybackManager:
         self.song_mode = False
         self.beat_length = 0.5
         self.compensate_tail_beats = 0.0
+        self.choreography = None  # Precompiled song motion, replaces live analysis
+        self.stem_index = None  # Precomputed stem levels, replace reading the stems
+        self.song_ring = None  # PcmRing of the song being played, if any
+        self.frames_written = 0  # 24 kHz frames handed to the output stream
+        self.song_start_frame = None  # frames_written when the current song began
+        self.wake_up_clips = None  # Wake-up clips decoded at startup, by path
+        self._stop_clip = threading.Event()
         
         # Ensure response history directory exists
         os.makedirs(RESPONSE_HISTORY_DIR, exist_ok=True)
@@ -57,17 +169,12 @@ class AudioPlaybackManager:
 
     def _playback_worker(self, chunk_ms):
         """Background worker that processes the playback queue."""
-        global head_out
-        global song_start_time
 
         interlude_counter = 0
         interlude_target = random.randint(150000, 300000)
-        head_move_active = False
-        head_move_end_time = 0
-        next_head_move = None
-        drums_peak = 0
-        drums_peak_time = 0
-        next_beat_time = 0
+        motion = None
+        # 24 kHz in, 48 kHz out; one stream, so chunks join without clicks
+        resampler = StreamResampler(24000, 48000)
 
         try:
             with sd.OutputStream(
@@ -77,23 +184,6 @@ class AudioPlaybackManager:
                 print("🔈 Output stream opened")
                 while True:
                     item = self.playback_queue.get()
-                    now = time.time()
-
-                    if head_move_active and now >= head_move_end_time:
-                        move_head("off")
-                        head_out = False
-                        head_move_active = False
-                        print("🛑 Head move ended")
-
-                    if not head_move_active and not self.head_move_queue.empty():
-                        move_time, move_duration = self.head_move_queue.queue[0]  # peek
-                        if now - song_start_time >= move_time:
-                            self.head_move_queue.get()
-                            move_head("on")
-                            head_out = True
-                            head_move_active = True
-                            head_move_end_time = now + move_duration
-                            print(f"🐟 Head move started for {move_duration:.2f} seconds")
 
                     if item is None:
                         print("🧵 Received stop signal, cleaning up.")
@@ -102,38 +192,30 @@ class AudioPlaybackManager:
 
                     if isinstance(item, tuple):
                         mode = item[0]
-                        if mode == "song":
-                            audio_chunk, flap_chunk, rms_drums = item[1], item[2], item[3]
+                        if mode == "song_ring":
+                            self._play_song_ring(item[1], stream, resampler, chunk_ms)
 
-                            flap_from_pcm_chunk(
-                                np.frombuffer(flap_chunk, dtype=np.int16), chunk_ms=chunk_ms
-                            )
+                        elif mode == "clip":
+                            self._play_clip(item[1], stream, chunk_ms)
+                            # The clip bypassed the resampler; the next speech is a new stream
+                            resampler.reset()
 
-                            if rms_drums > drums_peak:
-                                drums_peak = rms_drums
-                                drums_peak_time = now
-
-                            adjusted_now = (now - song_start_time) + (
-                                self.compensate_tail_beats * self.beat_length
+                        elif mode == "song":
+                            audio_chunk, flap_chunk, rms_drums = item[1], item[2], item[3]
+                            if self.song_start_frame is None:
+                                self.song_start_frame = self.frames_written
+                                motion = SongMotion(self, chunk_ms)
+                            song_time = (self.frames_written - self.song_start_frame) / 24000
+                            motion.update_head(song_time, self.frames_written)
+                            motion.chunk(
+                                song_time,
+                                np.frombuffer(flap_chunk, dtype=np.int16),
+                                rms_drums,
+                                self.frames_written,
                             )
-                            elapsed_song_time = now - song_start_time
-
-                            if adjusted_now >= next_beat_time:
-                                if drums_peak > 1500 and not head_out:
-                                    move_tail_async(duration=0.2)
-                                drums_peak = 0
-                                drums_peak_time = 0
-                                next_beat_time += self.beat_length
 
                             mono = np.frombuffer(audio_chunk, dtype=np.int16)
-                            resampled = resample(
-                                mono, int(len(mono) * 48000 / 24000)
-                            ).astype(np.int16)
-                            stereo = np.repeat(resampled[:, np.newaxis], 2, axis=1)
-                            stereo = np.clip(
-                                stereo * PLAYBACK_VOLUME, -32768, 32767
-                            ).astype(np.int16)
-                            stream.write(stereo)
+                            self._output(stream, resampler.process(mono), len(mono))
 
                         elif mode == "tts":
                             chunk = item[1]
@@ -143,15 +225,10 @@ class AudioPlaybackManager:
                                 sub = mono[i : i + chunk_len]
                                 if len(sub) == 0:
                                     continue
-                                flap_from_pcm_chunk(sub, chunk_ms=chunk_ms)
-                                resampled = resample(
-                                    sub, int(len(sub) * 48000 / 24000)
-                                ).astype(np.int16)
-                                stereo = np.repeat(resampled[:, np.newaxis], 2, axis=1)
-                                stereo = np.clip(
-                                    stereo * PLAYBACK_VOLUME, -32768, 32767
-                                ).astype(np.int16)
-                                stream.write(stereo)
+                                flap_from_pcm_chunk(
+                                    sub, chunk_ms=chunk_ms, at_sample=self.frames_written
+                                )
+                                self._output(stream, resampler.process(sub), len(sub))
 
                                 interlude_counter += len(sub)
                                 if interlude_counter >= interlude_target:
@@ -167,15 +244,10 @@ class AudioPlaybackManager:
                             sub = mono[i : i + chunk_len]
                             if len(sub) == 0:
                                 continue
-                            flap_from_pcm_chunk(sub, chunk_ms=chunk_ms)
-                            resampled = resample(sub, int(len(sub) * 48000 / 24000)).astype(
-                                np.int16
+                            flap_from_pcm_chunk(
+                                sub, chunk_ms=chunk_ms, at_sample=self.frames_written
                             )
-                            stereo = np.repeat(resampled[:, np.newaxis], 2, axis=1)
-                            stereo = np.clip(
-                                stereo * PLAYBACK_VOLUME, -32768, 32767
-                            ).astype(np.int16)
-                            stream.write(stereo)
+                            self._output(stream, resampler.process(sub), len(sub))
 
                             interlude_counter += len(sub)
                             if interlude_counter >= interlude_target:
@@ -192,6 +264,127 @@ class AudioPlaybackManager:
             self.playback_done_event.set()
             stop_all_motors()
 
+    def _output(self, stream, resampled, frames):
+        """Write a resampled mono chunk (frames long at 24 kHz) to the speaker."""
+        stereo = np.repeat(resampled[:, np.newaxis], 2, axis=1)
+        stereo = np.clip(stereo * PLAYBACK_VOLUME, -32768, 32767).astype(np.int16)
+        self._write(stream, stereo, frames)
+
+    def _write(self, stream, stereo, frames):
+        """
+        Write 48 kHz stereo (frames long at 24 kHz) to the speaker and anchor
+        the audio clock: of everything written so far, the device's output
+        latency is still queued.
+        """
+        stream.write(stereo)
+        self.frames_written += frames
+        if audio_clock is not None:
+            audio_clock.anchor(self.frames_written, int(float(stream.latency) * 24000))
+
+    def _play_song_ring(self, ring, stream, resampler, chunk_ms):
+        """
+        Play a song from a PcmRing (main, vocals, drums planes) filled by
+        play_song(). Motion runs on its own thread as an analysis reader of
+        the same frames, so it never delays the audio.
+        """
+        chunk = int(ring.sample_rate * chunk_ms / 1000)
+        # Attached before the first frame plays, so motion sees every chunk
+        reader = ring.attach()
+        if reader is None:
+            print("⚠️ No free PCM ring reader, song plays without motion")
+        # Frame 0 of the song is the next frame written to the speaker
+        start = self.frames_written
+        motion = threading.Thread(
+            target=self._song_motion_worker,
+            args=(ring, reader, start, chunk, chunk_ms),
+            daemon=True,
+        )
+        motion.start()
+        try:
+            while not ring.flags & CANCEL:
+                main = ring.peek(0, chunk)
+                if len(main) == 0:
+                    if ring.flags & END:
+                        break
+                    time.sleep(0.005)
+                    continue
+                resampled = resampler.process(main)
+                frames = len(main)
+                # Released frames count as playing: the motion reader follows them
+                ring.release(frames)
+                self._output(stream, resampled, frames)
+        except BaseException:
+            ring.cancel()
+            raise
+        finally:
+            motion.join()
+
+    def _song_motion_worker(self, ring, reader, start, chunk, chunk_ms):
+        """
+        Analysis reader of a song ring: drives mouth, head and tail. Frame n
+        of the song is frame start + n on the audio clock.
+        """
+        if reader is None:
+            return
+        motion = SongMotion(self, chunk_ms)
+        try:
+            while not ring.flags & CANCEL:
+                position, planes = reader.read(chunk)
+                count = len(planes[0])
+                if count == 0:
+                    if ring.flags & END and position >= ring.written:
+                        break
+                    time.sleep(0.005)
+                    continue
+
+                song_time = position / ring.sample_rate
+                motion.update_head(song_time, start + position)
+                vocals = planes[1] if len(planes) > 1 else None
+                rms_drums = 0.0
+                if len(planes) > 2:
+                    rms_drums = np.sqrt(np.mean(planes[2].astype(np.float32) ** 2))
+                # Skip a chunk the producer overwrote while this thread was stalled
+                if reader.intact(position):
+                    motion.chunk(song_time, vocals, rms_drums, start + position)
+                reader.consume(count)
+        finally:
+            reader.detach()
+
+    def _play_clip(self, clip, stream, chunk_ms):
+        """
+        Play a cached wake-up clip. Its samples are already in the output
+        format, so each chunk goes straight to the speaker at the current
+        volume, and the mouth
+        keyframes falling in it are stamped on the audio clock.
+        """
+        self._stop_clip.clear()
+        ratio = 48000 // DEFAULT_SAMPLE_RATE  # Output frames per audio clock frame
+        chunk = 48000 * chunk_ms // 1000
+        keyframes = clip.keyframes
+        key = 0
+        for first in range(0, len(clip.samples), chunk):
+            if self._stop_clip.is_set():
+                break
+            samples = clip.samples[first:first + chunk]
+            if PLAYBACK_VOLUME != 1:
+                scaled = samples.astype(np.float32) * PLAYBACK_VOLUME
+                samples = np.clip(scaled, -32768, 32767).astype(np.int16)
+            start = self.frames_written
+            while key < len(keyframes) and keyframes[key]["frame"] < first + len(samples):
+                at_sample = start + (int(keyframes[key]["frame"]) - first) // ratio
+                if keyframes[key]["mouth"] == MOUTH_OPEN:
+                    move_mouth(
+                        int(keyframes[key]["mouth_speed"]),
+                        keyframes[key]["mouth_ms"] / 1000.0,
+                        brake=False,
+                        at_sample=at_sample,
+                    )
+                elif keyframes[key]["mouth"] == MOUTH_STOP:
+                    stop_mouth(at_sample)
+                key += 1
+            self._write(stream, samples, len(samples) // ratio)
+        stop_mouth(self.frames_written)
+
     def save_audio_to_wav(self, audio_bytes, filename):
         """Save audio data to WAV file."""
         full_path = os.path.join(RESPONSE_HISTORY_DIR, filename)
@@ -214,30 +407,41 @@ class AudioPlaybackManager:
         self.save_audio_to_wav(audio_bytes, "response-1.wav")
 
     def enqueue_wav_to_playback(self, filepath):
-        """Read a WAV file and enqueue its PCM audio data to the playback queue."""
-        with wave.open(filepath, 'rb') as wf:
-            if (
-                wf.getframerate() != DEFAULT_SAMPLE_RATE
-                or wf.getnchannels() != DEFAULT_CHANNELS
-                or wf.getsampwidth() != 2
-            ):
+        """
+        Enqueue a WAV file's PCM audio to the playback queue. With tools/wavmap
+        built the chunks are views of the mapped file, not copies.
+        """
+        with open_wav(filepath) as wav:
+            if wav.sample_rate != DEFAULT_SAMPLE_RATE or wav.channels != DEFAULT_CHANNELS:
                 raise ValueError("WAV file must be 24000 Hz, mono, 16-bit")
 
             chunk_size = int(DEFAULT_SAMPLE_RATE * CHUNK_MS / 1000)
-            while True:
-                frames = wf.readframes(chunk_size)
-                if not frames:
-                    break
+            for frames in wav.chunks(chunk_size):
                 self.playback_queue.put(frames)
 
-    def play_random_wake_up_clip(self):
-        """Select and enqueue a random wake-up WAV file with mouth movement."""
-        # Check custom folder first
+    def _wake_up_clip_paths(self):
+        """Custom wake-up clips, or the default ones when there are none."""
         clips = glob.glob(os.path.join(WAKE_UP_CUSTOM_DIR, "*.wav"))
 
         if not clips:
             print(WARNING_NO_CUSTOM_CLIPS)
             clips = glob.glob(os.path.join(WAKE_UP_DEFAULT_DIR, "*.wav"))
+        return clips
+
+    def load_wake_up_clips(self):
+        """
+        Decode the wake-up clips into the native clip cache (tools/clipcache),
+        so a button press starts audio and mouth within one chunk.
+        """
+        cache = ClipCache.load(self._wake_up_clip_paths(), 48000, CHUNK_MS)
+        if cache is None:
+            return
+        self.wake_up_clips = {clip.path: clip for clip in cache.clips}
+        print(f"⚡ Cached {len(cache.clips)} wake-up clips")
+
+    def play_random_wake_up_clip(self):
+        """Select and enqueue a random wake-up WAV file with mouth movement."""
+        clips = self._wake_up_clip_paths()
 
         if not clips:
             print(WARNING_NO_WAKEUP_CLIPS)
@@ -248,8 +452,12 @@ class AudioPlaybackManager:
         # Track how many tasks were pending before enqueue
         already_pending = self.playback_queue.unfinished_tasks
 
-        # Enqueue the WAV file
-        self.enqueue_wav_to_playback(clip)
+        # Clips added since startup are read from disk as before
+        cached = (self.wake_up_clips or {}).get(clip)
+        if cached is not None:
+            self.playback_queue.put(("clip", cached))
+        else:
+            self.enqueue_wav_to_playback(clip)
 
         # Wait for exactly those new chunks to finish
         while self.playback_queue.unfinished_tasks > already_pending:
@@ -262,6 +470,9 @@ class AudioPlaybackManager:
 
     def stop_playback(self):
         """Immediately stop playback and flush queue."""
+        if self.song_ring is not None:
+            self.song_ring.cancel()
+        self._stop_clip.set()
         while not self.playback_queue.empty():
             try:
                 self.playback_queue.get_nowait()
@@ -278,13 +489,12 @@ class AudioPlaybackManager:
 
     def reset_for_new_song(self):
         """Reset playback state for a new song."""
-        global song_start_time
-        
         self.playback_queue.queue.clear()
         self.head_move_queue.queue.clear()
+        self.choreography = None
         self.playback_done_event.clear()
         self.last_played_time = time.time()
-        song_start_time = time.time()
+        self.song_start_frame = None
 
 
 # Global playback manager instance
@@ -3,17 +3,17 @@ Shared audio processing utilities.
 Consolidates common audio handling logic used across multiple modules.
 """
 import asyncio
-import base64
 import os
 import wave
 from typing import AsyncGenerator, Optional
 
 import numpy as np
-from scipy.signal import resample
 
 from .audio import playback_queue, rotate_and_save_response_audio
+from .base64_codec import Base64Codec
 from .config import CHUNK_MS, PLAYBACK_VOLUME
 from .movements import move_head
+from .resampler import StreamResampler
 
 
 class AudioProcessor:
@@ -22,6 +22,7 @@ class AudioProcessor:
     def __init__(self, sample_rate: int = 24000, channels: int = 1):
         self.sample_rate = sample_rate
         self.channels = channels
+        self.resampler = StreamResampler(sample_rate, 48000)
 
     def process_audio_chunk(self, audio_data: bytes) -> bytes:
         """Process audio chunk for playback (resample, convert to stereo, apply volume)."""
@@ -35,9 +36,7 @@ class AudioProcessor:
                 continue
                 
             # Resample from 24kHz to 48kHz
-            resampled = resample(
-                sub, int(len(sub) * 48000 / self.sample_rate)
-            ).astype(np.int16)
+            resampled = self.resampler.process(sub)
             
             # Convert to stereo
             stereo = np.repeat(resampled[:, np.newaxis], 2, axis=1)
@@ -101,10 +100,12 @@ class AudioStreamProcessor:
         self.processor = processor
         self.audio_buffer = bytearray()
         self.full_text = ""
+        self.codec = Base64Codec()
 
     def process_audio_delta(self, audio_b64: str) -> None:
         """Process audio delta from WebSocket response."""
-        audio_chunk = base64.b64decode(audio_b64)
+        # A view of the codec's scratch buffer, consumed before the next delta
+        audio_chunk = self.codec.decode(audio_b64)
         self.audio_buffer.extend(audio_chunk)
         self.processor.enqueue_audio_chunk(audio_chunk)
 
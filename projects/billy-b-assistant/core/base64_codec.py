@@ -0,0 +1,100 @@
+"""
+Base64 for realtime audio messages.
+Uses tools/base64 when libbase64.so is built (see README): the vectorised
+codec (AVX2, SSSE3 or NEON) decodes each delta straight from the message
+string into a buffer the caller reuses, with no bytes object per chunk.
+Without it, or for input the strict decoder rejects, the base64 module is
+used as before.
+"""
+import base64
+import ctypes
+from typing import Optional, Union
+
+import numpy as np
+
+from .native import load_native
+
+
+LIBRARY_ENV = "BILLY_BASE64_LIB"
+LIBRARY_NAME = "libbase64.so"
+
+# UTF-8 view of a str; for the ASCII strings json gives us it is the string's
+# own storage, so the decoder reads the message without a copy
+_as_utf8 = ctypes.pythonapi.PyUnicode_AsUTF8AndSize
+_as_utf8.restype = ctypes.c_void_p
+_as_utf8.argtypes = [ctypes.py_object, ctypes.POINTER(ctypes.c_ssize_t)]
+
+
+def _declare(lib: ctypes.CDLL) -> None:
+    lib.base64_encode.restype = ctypes.c_size_t
+    lib.base64_encode.argtypes = [ctypes.c_void_p, ctypes.c_size_t, ctypes.c_void_p]
+    lib.base64_decode.restype = ctypes.c_long
+    lib.base64_decode.argtypes = [ctypes.c_void_p, ctypes.c_size_t, ctypes.c_void_p]
+    lib.base64_backend.restype = ctypes.c_char_p
+
+
+def _load_library() -> Optional[ctypes.CDLL]:
+    """Load the native codec once; None when it is not built."""
+    return load_native(LIBRARY_ENV, LIBRARY_NAME, _declare, "using the base64 module")
+
+
+def native_available() -> bool:
+    """True when libbase64.so can be loaded."""
+    return _load_library() is not None
+
+
+def backend() -> str:
+    """Instruction set of the native codec, or "python"."""
+    lib = _load_library()
+    return lib.base64_backend().decode() if lib is not None else "python"
+
+
+class Base64Codec:
+    """
+    Encodes and decodes into scratch buffers this object owns. Each result
+    is a view that stays valid until the next call of the same kind, so a
+    stream of deltas allocates only when a chunk is larger than any before.
+    """
+
+    def __init__(self):
+        self._lib = _load_library()
+        self._decoded, self._decoded_address = self._scratch(0)
+        self._encoded, self._encoded_address = self._scratch(0)
+        self._utf8_size = ctypes.c_ssize_t()
+
+    @staticmethod
+    def _scratch(size: int):
+        # A new array rather than a resize: views of the old one may live on.
+        # The address is kept, as asking numpy for it costs about 1 us a call
+        buffer = np.empty(max(size, 4096), dtype=np.uint8)
+        return buffer, buffer.ctypes.data
+
+    def _text(self, text: Union[str, bytes]):
+        """Pointer argument and length for the characters of text, without copying them."""
+        if isinstance(text, str):
+            address = _as_utf8(text, ctypes.byref(self._utf8_size))
+            return address, self._utf8_size.value
+        return text, len(text)
+
+    def decode(self, text: Union[str, bytes]) -> memoryview:
+        """Bytes of a base64 str or bytes."""
+        if self._lib is not None:
+            address, chars = self._text(text)
+            if chars // 4 * 3 > len(self._decoded):
+                self._decoded, self._decoded_address = self._scratch(chars // 4 * 3)
+            decoded = self._lib.base64_decode(address, chars, self._decoded_address)
+            if decoded >= 0:
+                return memoryview(self._decoded)[:decoded]
+        return memoryview(base64.b64decode(text))
+
+    def encode(self, data) -> str:
+        """Base64 str of anything that exposes its bytes (bytes, ndarray)."""
+        if self._lib is None:
+            return base64.b64encode(data).decode("utf-8")
+        if not isinstance(data, bytes):
+            data = bytes(data)  # A memcpy, cheaper than asking ctypes for the address
+        size = (len(data) + 2) // 3 * 4
+        if size > len(self._encoded):
+            self._encoded, self._encoded_address = self._scratch(size)
+        chars = self._lib.base64_encode(data, len(data), self._encoded_address)
+        return str(memoryview(self._encoded)[:chars], "ascii")
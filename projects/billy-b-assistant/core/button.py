@@ -93,6 +93,7 @@ def on_button():
 
 def start_loop():
     audio.detect_devices(debug=config.DEBUG_MODE)
+    audio.load_wake_up_clips()
     button.when_pressed = on_button
     print("🎦 Ready. Press button to start a voice session. Press Ctrl+C to quit.")
     print("🕐 Waiting for button press...")
@@ -0,0 +1,129 @@
+"""
+Precompiled song choreography.
+Decodes the keyframe format produced by tools/choreoc (choreo.bbc) and
+evaluates it with the same interpolation as the firmware player.
+"""
+import bisect
+import os
+from typing import List, Optional, Tuple
+
+CHOREO_FILENAME = "choreo.bbc"
+
+TRACK_MOUTH = 0
+TRACK_BODY = 1
+TRACK_TAIL = 2
+
+_MAGIC = b"BC"
+_VERSION = 1
+_HEADER_SIZE = 4
+
+_DIR_STOP = 0
+_DIR_FORWARD = 1
+_DIR_BACKWARD = 2
+_DIR_END = 3
+
+_EASE_STEP = 0
+_EASE_LINEAR = 1
+_EASE_IN = 2
+_EASE_OUT = 3
+
+
+class Choreography:
+    """Decoded tracks of (time_ms, value, easing) keyframes, value in -255..255."""
+
+    def __init__(self, tracks: List[List[Tuple[int, int, int]]], end_times: List[int]):
+        self.tracks = tracks
+        self.end_times = end_times
+        self._times = [[key[0] for key in track] for track in tracks]
+
+    @property
+    def duration_ms(self) -> int:
+        return max(self.end_times, default=0)
+
+    def value_at(self, track: int, time_ms: float) -> int:
+        """Signed motor speed (-255..255) for a track at a song position."""
+        if track >= len(self.tracks) or time_ms >= self.end_times[track]:
+            return 0
+
+        keys = self.tracks[track]
+        index = bisect.bisect_right(self._times[track], time_ms)
+        from_time, from_value = (keys[index - 1][0], keys[index - 1][1]) if index else (0, 0)
+        if index == len(keys):
+            return from_value
+
+        to_time, to_value, easing = keys[index]
+        span = to_time - from_time
+        if easing == _EASE_STEP or span == 0:
+            return from_value
+
+        # Progress as 0..255 fixed point, as in ChoreographyPlayer::interpolate()
+        t = min(int(((time_ms - from_time) * 256) // span), 255)
+        if easing == _EASE_IN:
+            t = (t * t) >> 8
+        elif easing == _EASE_OUT:
+            t = 255 - (((255 - t) * (255 - t)) >> 8)
+        return from_value + (((to_value - from_value) * t) >> 8)
+
+
+def decode_choreography(data: bytes) -> Choreography:
+    """Decode a choreography blob; raises ValueError on a malformed one."""
+    if len(data) < _HEADER_SIZE or data[:2] != _MAGIC or data[2] != _VERSION:
+        raise ValueError("not a choreography file")
+
+    try:
+        return _decode_tracks(data)
+    except IndexError:
+        raise ValueError("truncated choreography data") from None
+
+
+def _decode_tracks(data: bytes) -> Choreography:
+    tracks = []
+    end_times = []
+    for i in range(data[3]):
+        entry = _HEADER_SIZE + i * 2
+        cursor = data[entry] | (data[entry + 1] << 8)
+
+        keys = []
+        time_ms = 0
+        while True:
+            delta = 0
+            shift = 0
+            while True:
+                byte = data[cursor]
+                cursor += 1
+                delta |= (byte & 0x7F) << shift
+                shift += 7
+                if not byte & 0x80:
+                    break
+            time_ms += delta
+
+            control = data[cursor]
+            cursor += 1
+            direction = control & 0x03
+            easing = (control >> 2) & 0x03
+            if direction == _DIR_END:
+                break
+
+            value = 0
+            if direction in (_DIR_FORWARD, _DIR_BACKWARD):
+                value = data[cursor] if direction == _DIR_FORWARD else -data[cursor]
+                cursor += 1
+            keys.append((time_ms, value, easing))
+
+        tracks.append(keys)
+        end_times.append(time_ms)
+
+    return Choreography(tracks, end_times)
+
+
+def load_choreography(song_dir: str) -> Optional[Choreography]:
+    """Load SONG_DIR/choreo.bbc if present; returns None when missing or invalid."""
+    path = os.path.join(song_dir, CHOREO_FILENAME)
+    if not os.path.exists(path):
+        return None
+    try:
+        with open(path, "rb") as f:
+            return decode_choreography(f.read())
+    except (OSError, ValueError) as e:
+        print(f"⚠️ Ignoring {path}: {e}")
+        return None
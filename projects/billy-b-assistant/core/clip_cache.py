@@ -0,0 +1,126 @@
+"""
+Wake-up clips decoded once at startup.
+Uses tools/clipcache when libclipcache.so is built (see README): every clip
+is resampled to the 48 kHz stereo output and normalised into one arena, with its mouth keyframes worked out ahead,
+so a button press only writes memory to the sound card. Without it the
+clips are read and processed on every press as before.
+"""
+import ctypes
+from typing import List, Optional
+
+import numpy as np
+
+from .native import load_native
+
+
+LIBRARY_ENV = "BILLY_CLIPCACHE_LIB"
+LIBRARY_NAME = "libclipcache.so"
+
+KEYFRAME = np.dtype([
+    ("frame", "<u4"),
+    ("mouth", "u1"),
+    ("mouth_speed", "u1"),
+    ("mouth_ms", "<u2"),
+])
+
+
+def _declare(lib: ctypes.CDLL) -> None:
+    cache = ctypes.c_void_p
+    lib.clip_cache_create.restype = cache
+    lib.clip_cache_create.argtypes = [ctypes.c_uint32, ctypes.c_uint16]
+    lib.clip_cache_destroy.argtypes = [cache]
+    lib.clip_cache_add.restype = ctypes.c_long
+    lib.clip_cache_add.argtypes = [cache, ctypes.c_char_p]
+    lib.clip_cache_count.restype = ctypes.c_size_t
+    lib.clip_cache_count.argtypes = [cache]
+    lib.clip_cache_samples.restype = ctypes.c_void_p
+    lib.clip_cache_samples.argtypes = [cache, ctypes.c_size_t]
+    lib.clip_cache_frames.restype = ctypes.c_size_t
+    lib.clip_cache_frames.argtypes = [cache, ctypes.c_size_t]
+    lib.clip_cache_keyframes.restype = ctypes.c_void_p
+    lib.clip_cache_keyframes.argtypes = [cache, ctypes.c_size_t, ctypes.POINTER(ctypes.c_size_t)]
+
+
+def _load_library() -> Optional[ctypes.CDLL]:
+    """Load the native cache once; None when it is not built."""
+    return load_native(
+        LIBRARY_ENV, LIBRARY_NAME, _declare, "wake-up clips are decoded on each press"
+    )
+
+
+def native_available() -> bool:
+    """True when clips can be cached."""
+    return _load_library() is not None
+
+
+class _Arena:
+    """Owns the native cache; every view of a clip holds it."""
+
+    def __init__(self, lib: ctypes.CDLL, handle: int):
+        self.lib = lib
+        self.handle = handle
+
+    def __del__(self):
+        if getattr(self, "handle", None) is not None:
+            self.lib.clip_cache_destroy(self.handle)
+            self.handle = None
+
+
+class _ArenaView:
+    """Read-only array interface over arena memory; numpy keeps it (and the arena) as base."""
+
+    def __init__(self, arena: _Arena, address: int, shape: tuple, dtype: np.dtype):
+        self.arena = arena
+        self.__array_interface__ = {
+            "version": 3,
+            "shape": shape,
+            "typestr": dtype.str,
+            "descr": dtype.descr,
+            "data": (address, True),
+        }
+
+
+class CachedClip:
+    """One clip: (frames, 2) int16 at the output rate, before volume, and its mouth keyframes."""
+
+    def __init__(self, path: str, samples: np.ndarray, keyframes: np.ndarray):
+        self.path = path
+        self.samples = samples
+        self.keyframes = keyframes
+
+
+class ClipCache:
+    """All clips of one output format in a single native arena."""
+
+    def __init__(self, arena: _Arena, output_rate: int):
+        self._arena = arena
+        self.output_rate = output_rate
+        self.clips: List[CachedClip] = []
+
+    @classmethod
+    def load(cls, paths: List[str], output_rate: int, chunk_ms: int) -> Optional["ClipCache"]:
+        """Decode every clip in paths; None without the library or a usable clip."""
+        lib = _load_library()
+        if lib is None:
+            return None
+        handle = lib.clip_cache_create(output_rate, chunk_ms)
+        if not handle:
+            return None
+        cache = cls(_Arena(lib, handle), output_rate)
+
+        added = [(path, lib.clip_cache_add(handle, path.encode())) for path in paths]
+        # The arena only stops moving once every clip is in
+        for path, index in added:
+            if index >= 0:
+                cache.clips.append(cache._clip(path, index))
+        return cache if cache.clips else None
+
+    def _clip(self, path: str, index: int) -> CachedClip:
+        lib, handle = self._arena.lib, self._arena.handle
+        frames = lib.clip_cache_frames(handle, index)
+        address = lib.clip_cache_samples(handle, index)
+        samples = np.asarray(_ArenaView(self._arena, address or 0, (frames, 2), np.dtype("<i2")))
+        count = ctypes.c_size_t()
+        address = lib.clip_cache_keyframes(handle, index, ctypes.byref(count))
+        keyframes = np.asarray(_ArenaView(self._arena, address or 0, (count.value,), KEYFRAME))
+        return CachedClip(path, samples, keyframes)
@@ -22,6 +22,10 @@ DEFAULT_HEAD_SPEED = 80
 DEFAULT_TAIL_SPEED = 80
 DEFAULT_HEAD_DURATION = 0.5
 DEFAULT_TAIL_DURATION = 0.2
+# Seconds from driving a motor to a visible move; audio-timed moves start this early
+DEFAULT_MOUTH_LATENCY = 0.03
+DEFAULT_HEAD_LATENCY = 0.08
+DEFAULT_TAIL_LATENCY = 0.05
 
 # Timing Configuration
 DEFAULT_BUTTON_DEBOUNCE_DELAY = 0.5
@@ -0,0 +1,138 @@
+"""
+Mouth sync decisions for PCM chunks.
+Uses the fixed-point engine from shared/libraries/LipSync when liblipsync.so
+is built (see README), the same code the Arduino firmware runs; otherwise
+returns None so callers keep their numpy path.
+"""
+import ctypes
+import time
+from typing import Optional
+
+import numpy as np
+
+from .native import load_native
+
+
+LIBRARY_ENV = "BILLY_LIPSYNC_LIB"
+LIBRARY_NAME = "liblipsync.so"
+
+MOUTH_HOLD = 0
+MOUTH_OPEN = 1
+MOUTH_STOP = 2
+
+HEAD_HOLD = 0
+HEAD_OUT = 1
+HEAD_IN = 2
+
+
+class LipSyncCommand(ctypes.Structure):
+    """Mirror of lipsync_command in LipSyncC.h."""
+
+    _fields_ = [
+        ("mouth", ctypes.c_uint8),
+        ("mouth_speed", ctypes.c_uint8),
+        ("mouth_ms", ctypes.c_uint16),
+        ("head", ctypes.c_uint8),
+        ("tail", ctypes.c_uint8),
+        ("rms", ctypes.c_uint16),
+        ("peak", ctypes.c_uint16),
+    ]
+
+
+def _declare(lib: ctypes.CDLL) -> None:
+    lib.lipsync_size.restype = ctypes.c_size_t
+    lib.lipsync_init.restype = ctypes.c_void_p
+    lib.lipsync_init.argtypes = [ctypes.c_void_p, ctypes.c_uint16, ctypes.c_uint16]
+    lib.lipsync_process.argtypes = [
+        ctypes.c_void_p,
+        ctypes.c_void_p,
+        ctypes.c_uint16,
+        ctypes.c_uint32,
+        ctypes.c_uint16,
+        ctypes.POINTER(LipSyncCommand),
+    ]
+    lib.lipsync_levels.argtypes = [
+        ctypes.c_void_p,
+        ctypes.c_uint16,
+        ctypes.c_uint16,
+        ctypes.c_uint32,
+        ctypes.c_uint16,
+        ctypes.POINTER(LipSyncCommand),
+    ]
+    lib.lipsync_reset.argtypes = [ctypes.c_void_p]
+
+
+def _load_library() -> Optional[ctypes.CDLL]:
+    """Load the native engine once; None when it is not built."""
+    return load_native(LIBRARY_ENV, LIBRARY_NAME, _declare, "using numpy mouth sync")
+
+
+def native_available() -> bool:
+    """True when chunks go through the native engine."""
+    return _load_library() is not None
+
+
+class LipSync:
+    """One mouth's lip-sync state, fed consecutive int16 chunks."""
+
+    def __init__(self, threshold: int = 1500, min_flap_gap: float = 0.1):
+        self._lib = _load_library()
+        self._storage = None
+        self._engine = None
+        self._command = LipSyncCommand()
+        if self._lib is not None:
+            # Engine state lives in Python-owned memory; the library never allocates
+            self._storage = ctypes.create_string_buffer(self._lib.lipsync_size())
+            self._engine = self._lib.lipsync_init(
+                self._storage, int(threshold), int(min_flap_gap * 1000)
+            )
+
+    @property
+    def available(self) -> bool:
+        return self._engine is not None
+
+    def process(
+        self, audio: np.ndarray, chunk_ms: int = 40, now: Optional[float] = None
+    ) -> Optional[LipSyncCommand]:
+        """
+        Motor command for the next chunk, or None without the native engine.
+        now: the chunk's time in seconds on any steady clock (default monotonic).
+        """
+        if self._engine is None:
+            return None
+        chunk = np.ascontiguousarray(audio, dtype=np.int16)
+        if now is None:
+            now = time.monotonic()
+        now_ms = int(now * 1000) & 0xFFFFFFFF
+        self._lib.lipsync_process(
+            self._engine,
+            chunk.ctypes.data,
+            len(chunk),
+            now_ms,
+            int(chunk_ms),
+            ctypes.byref(self._command),
+        )
+        return self._command
+
+    def levels(
+        self, rms: int, peak: int, chunk_ms: int = 40, now: Optional[float] = None
+    ) -> Optional[LipSyncCommand]:
+        """As process(), for a chunk whose RMS and peak were measured elsewhere."""
+        if self._engine is None:
+            return None
+        if now is None:
+            now = time.monotonic()
+        now_ms = int(now * 1000) & 0xFFFFFFFF
+        self._lib.lipsync_levels(
+            self._engine,
+            min(int(rms), 0xFFFF),
+            min(int(peak), 0xFFFF),
+            now_ms,
+            int(chunk_ms),
+            ctypes.byref(self._command),
+        )
+        return self._command
+
+    def reset(self) -> None:
+        if self._engine is not None:
+            self._lib.lipsync_reset(self._engine)
@@ -0,0 +1,130 @@
+"""
+Microphone front end: level, voice activity and the realtime API message for
+each capture block. Uses tools/micfront when libmicfront.so is built (see
+README): one native pass removes DC, measures the RMS, resamples to 24 kHz
+and base64-encodes into a ready JSON message. Without it, MicFrontEnd is
+unavailable and the session keeps its numpy path (send_mic_audio).
+"""
+import ctypes
+from typing import NamedTuple, Optional
+
+import numpy as np
+
+from .native import load_native
+
+
+LIBRARY_ENV = "BILLY_MICFRONT_LIB"
+LIBRARY_NAME = "libmicfront.so"
+
+OUTPUT_RATE = 24000
+HANGOVER_MS = 300
+
+
+class _Packet(ctypes.Structure):
+    """Mirror of mic_packet in MicFrontEndC.h."""
+
+    _fields_ = [
+        ("rms", ctypes.c_float),
+        ("voice", ctypes.c_uint8),
+        ("samples", ctypes.c_size_t),
+        ("message", ctypes.c_void_p),
+        ("length", ctypes.c_size_t),
+    ]
+
+
+class MicPacket(NamedTuple):
+    rms: float
+    voice: bool
+    message: str  # input_audio_buffer.append, ready for ws.send()
+
+
+def _declare(lib: ctypes.CDLL) -> None:
+    front = ctypes.c_void_p
+    lib.mic_front_create.restype = front
+    lib.mic_front_create.argtypes = [
+        ctypes.c_uint32,
+        ctypes.c_uint32,
+        ctypes.c_uint16,
+        ctypes.c_uint16,
+        ctypes.c_uint16,
+    ]
+    lib.mic_front_destroy.argtypes = [front]
+    lib.mic_front_process.argtypes = [
+        front,
+        ctypes.c_void_p,
+        ctypes.c_size_t,
+        ctypes.POINTER(_Packet),
+    ]
+    lib.mic_front_reset.argtypes = [front]
+
+
+def _load_library() -> Optional[ctypes.CDLL]:
+    """Load the native front end once; None when it is not built."""
+    return load_native(
+        LIBRARY_ENV, LIBRARY_NAME, _declare, "using numpy mic processing"
+    )
+
+
+def native_available() -> bool:
+    """True when libmicfront.so can be loaded."""
+    return _load_library() is not None
+
+
+class MicFrontEnd:
+    """One capture stream's DC, voice hangover and resampler state."""
+
+    def __init__(
+        self,
+        input_rate: int,
+        channels: int = 1,
+        threshold: int = 2000,
+        hangover_ms: int = HANGOVER_MS,
+    ):
+        self._lib = _load_library()
+        self._handle = None
+        self._packet = _Packet()
+        self.input_rate = input_rate
+        self.channels = channels
+        if self._lib is not None:
+            self._handle = self._lib.mic_front_create(
+                int(input_rate),
+                OUTPUT_RATE,
+                int(channels),
+                max(0, min(int(threshold), 0xFFFF)),
+                int(hangover_ms),
+            )
+
+    @property
+    def available(self) -> bool:
+        return self._handle is not None
+
+    def process(self, indata: np.ndarray) -> Optional[MicPacket]:
+        """
+        Packet for one (frames, channels) int16 capture block, or None
+        without the native library.
+        """
+        if self._handle is None:
+            return None
+        block = np.ascontiguousarray(indata, dtype=np.int16)
+        frames = len(block)
+        if self._lib.mic_front_process(
+            self._handle, block.ctypes.data, frames, ctypes.byref(self._packet)
+        ):
+            return None
+        packet = self._packet
+        # The one copy left: the message becomes the str that ws.send() takes
+        message = ctypes.string_at(packet.message, packet.length).decode("ascii")
+        return MicPacket(float(packet.rms), bool(packet.voice), message)
+
+    def reset(self) -> None:
+        if self._handle is not None:
+            self._lib.mic_front_reset(self._handle)
+
+    def close(self) -> None:
+        if self._handle is not None:
+            self._lib.mic_front_destroy(self._handle)
+            self._handle = None
+
+    def __del__(self):
+        if getattr(self, "_handle", None) is not None:
+            self.close()
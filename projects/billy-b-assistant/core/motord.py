@@ -0,0 +1,265 @@
+"""
+Client for the native motor daemon in tools/motord.
+When libmotord.so is built (see README), one high-priority C++ thread owns
+the motor GPIOs and applies timestamped commands from a lock-free ring, so
+motor timing no longer depends on which Python thread calls in or on GIL
+and garbage-collection stalls. Without it, core/movements.py drives lgpio
+directly.
+"""
+import ctypes
+import threading
+from typing import Optional, Sequence
+
+from .native import load_native
+
+
+LIBRARY_ENV = "BILLY_MOTORD_LIB"
+LIBRARY_NAME = "libmotord.so"
+
+MOUTH = 0
+HEAD = 1
+TAIL = 2
+ALL = 255
+
+FLAG_CANCEL = 1
+FLAG_SAMPLES = 2
+
+
+def _declare(lib: ctypes.CDLL) -> None:
+    lib.motord_create_trace.restype = ctypes.c_void_p
+    lib.motord_create_trace.argtypes = [
+        ctypes.c_char_p,
+        ctypes.c_uint32,
+        ctypes.c_uint32,
+        ctypes.c_int,
+    ]
+    lib.motord_create_gpio.restype = ctypes.c_void_p
+    lib.motord_create_gpio.argtypes = [
+        ctypes.c_int,
+        ctypes.POINTER(ctypes.c_int),
+        ctypes.c_uint32,
+        ctypes.c_uint32,
+        ctypes.c_uint32,
+    ]
+    lib.motord_destroy.argtypes = [ctypes.c_void_p]
+    lib.motord_start.argtypes = [ctypes.c_void_p, ctypes.c_int]
+    lib.motord_realtime.argtypes = [ctypes.c_void_p]
+    lib.motord_push.argtypes = [
+        ctypes.c_void_p,
+        ctypes.c_uint64,
+        ctypes.c_uint8,
+        ctypes.c_int16,
+        ctypes.c_uint32,
+        ctypes.c_int16,
+        ctypes.c_uint8,
+    ]
+    lib.motord_now_us.restype = ctypes.c_uint64
+    lib.motord_set_clock.argtypes = [ctypes.c_void_p, ctypes.c_void_p]
+    lib.motord_set_latency_us.argtypes = [ctypes.c_void_p, ctypes.c_uint8, ctypes.c_uint32]
+    for name in ("motord_clock_create_stream", "motord_clock_create_manual"):
+        getattr(lib, name).restype = ctypes.c_void_p
+        getattr(lib, name).argtypes = [ctypes.c_uint32]
+    lib.motord_clock_destroy.argtypes = [ctypes.c_void_p]
+    lib.motord_clock_anchor.argtypes = [ctypes.c_void_p, ctypes.c_uint64, ctypes.c_uint32]
+    lib.motord_clock_set.argtypes = [ctypes.c_void_p, ctypes.c_int64]
+    lib.motord_clock_position.restype = ctypes.c_int64
+    lib.motord_clock_position.argtypes = [ctypes.c_void_p]
+    for name in ("motord_max_late_us", "motord_watchdog_trips", "motord_dropped"):
+        getattr(lib, name).restype = ctypes.c_uint32
+        getattr(lib, name).argtypes = [ctypes.c_void_p]
+
+
+def _load_library() -> Optional[ctypes.CDLL]:
+    """Load the native daemon once; None when it is not built."""
+    return load_native(
+        LIBRARY_ENV, LIBRARY_NAME, _declare, "driving motors from Python"
+    )
+
+
+def native_available() -> bool:
+    """True when libmotord.so can be loaded."""
+    return _load_library() is not None
+
+
+class SampleClock:
+    """
+    Audio frame position used as the clock of push(at_sample=...).
+    stream() follows an output stream through anchor() calls from the thread
+    that writes to it; manual() is moved by set() and stands in for the
+    audio device in tests.
+    """
+
+    def __init__(self, lib: ctypes.CDLL, handle: int, sample_rate: int):
+        self._lib = lib
+        self._handle = handle
+        self.sample_rate = sample_rate
+
+    @classmethod
+    def stream(cls, sample_rate: int) -> Optional["SampleClock"]:
+        lib = _load_library()
+        if lib is None:
+            return None
+        return cls(lib, lib.motord_clock_create_stream(sample_rate), sample_rate)
+
+    @classmethod
+    def manual(cls, sample_rate: int) -> Optional["SampleClock"]:
+        lib = _load_library()
+        if lib is None:
+            return None
+        return cls(lib, lib.motord_clock_create_manual(sample_rate), sample_rate)
+
+    def anchor(self, written: int, queued: int) -> None:
+        """Just after a write: frames written in total, queued still in the device."""
+        self._lib.motord_clock_anchor(self._handle, written, max(int(queued), 0))
+
+    def set(self, position: int) -> None:
+        self._lib.motord_clock_set(self._handle, position)
+
+    @property
+    def position(self) -> int:
+        """Frame at the speaker now; -1 before the first."""
+        return self._lib.motord_clock_position(self._handle)
+
+    def __del__(self):
+        # Daemons hold a reference, so the clock outlives every one using it
+        if getattr(self, "_handle", None) is not None:
+            self._lib.motord_clock_destroy(self._handle)
+            self._handle = None
+
+
+class MotorDaemon:
+    """A running native motor daemon; create it with open_gpio() or open_trace()."""
+
+    def __init__(self, lib: ctypes.CDLL, handle: int):
+        self._lib = lib
+        self._handle = handle
+        # The ring has a single producer; Python callers come from many threads
+        self._lock = threading.Lock()
+        self._clock = None
+
+    @classmethod
+    def open_gpio(
+        cls,
+        pins: Sequence[int],
+        pwm_hz: int,
+        idle_timeout: float,
+        chip: int = 0,
+        tick_us: int = 1000,
+        priority: int = 50,
+    ) -> Optional["MotorDaemon"]:
+        """pins: in1, in2 of mouth, head and tail (-1 for no tail motor)."""
+        lib = _load_library()
+        if lib is None:
+            return None
+        pin_array = (ctypes.c_int * 6)(*pins)
+        handle = lib.motord_create_gpio(
+            chip, pin_array, int(pwm_hz), tick_us, int(idle_timeout * 1000)
+        )
+        return cls._started(lib, handle, priority)
+
+    @classmethod
+    def open_trace(
+        cls,
+        path: str,
+        idle_timeout: float = 60,
+        tick_us: int = 1000,
+        priority: int = 0,
+        tail_on_head: bool = False,
+    ) -> Optional["MotorDaemon"]:
+        """Daemon that logs `<us> <motor> <speed>` lines instead of driving GPIOs.
+
+        tail_on_head traces the tail on the head motor reversed, as on a
+        two-motor fish.
+        """
+        lib = _load_library()
+        if lib is None:
+            return None
+        handle = lib.motord_create_trace(
+            path.encode(), tick_us, int(idle_timeout * 1000), int(tail_on_head)
+        )
+        return cls._started(lib, handle, priority)
+
+    @classmethod
+    def _started(cls, lib, handle, priority) -> Optional["MotorDaemon"]:
+        if not handle:
+            return None
+        lib.motord_start(handle, priority)
+        return cls(lib, handle)
+
+    def push(
+        self,
+        motor: int,
+        speed: int,
+        duration: float = 0.0,
+        then_speed: int = 0,
+        at: Optional[float] = None,
+        cancel: bool = False,
+        at_sample: Optional[int] = None,
+    ) -> bool:
+        """
+        Run motor at speed (signed percent, 0 brakes) from time.monotonic()
+        time `at` (now when None), or when the clock reaches frame
+        `at_sample`; after duration seconds switch to then_speed.
+        """
+        flags = FLAG_CANCEL if cancel else 0
+        if at_sample is not None:
+            at_us = max(int(at_sample), 0)
+            flags |= FLAG_SAMPLES
+        else:
+            at_us = 0 if at is None else int(at * 1_000_000)
+        with self._lock:
+            if self._handle is None:
+                return False
+            return bool(
+                self._lib.motord_push(
+                    self._handle,
+                    at_us,
+                    motor,
+                    int(speed),
+                    int(duration * 1_000_000),
+                    int(then_speed),
+                    flags,
+                )
+            )
+
+    def set_clock(self, clock: Optional[SampleClock]) -> None:
+        """Clock of push(at_sample=...); None applies those commands at once."""
+        with self._lock:
+            if self._handle is None:
+                return
+            self._lib.motord_set_clock(self._handle, clock._handle if clock else None)
+            self._clock = clock
+
+    def set_latency(self, motor: int, latency: float) -> None:
+        """Seconds from driving motor to seeing it move; at_sample commands start that early."""
+        with self._lock:
+            if self._handle is not None:
+                self._lib.motord_set_latency_us(self._handle, motor, int(latency * 1_000_000))
+
+    @property
+    def realtime(self) -> bool:
+        return bool(self._lib.motord_realtime(self._handle))
+
+    @property
+    def max_late_us(self) -> int:
+        return self._lib.motord_max_late_us(self._handle)
+
+    @property
+    def watchdog_trips(self) -> int:
+        return self._lib.motord_watchdog_trips(self._handle)
+
+    @property
+    def dropped(self) -> int:
+        return self._lib.motord_dropped(self._handle)
+
+    def close(self) -> None:
+        """Stop the control thread and brake every motor."""
+        with self._lock:
+            if self._handle is not None:
+                self._lib.motord_destroy(self._handle)
+                self._handle = None
+
+    def __del__(self):
+        if getattr(self, "_handle", None) is not None:
+            self.close()
+
@@ -9,6 +9,7 @@ import numpy as np
 
 from .config import is_classic_billy
 from .constants import (
+    DEFAULT_SAMPLE_RATE,
     DEFAULT_MOTOR_FREQ,
     DEFAULT_HEAD_SPEED,
     DEFAULT_TAIL_SPEED,
@@ -19,7 +20,12 @@ from .constants import (
     DEFAULT_INTERLUDE_DELAY_MIN,
     DEFAULT_INTERLUDE_DELAY_MAX,
     DEFAULT_TAIL_MOVE_INTERVAL,
+    DEFAULT_MOUTH_LATENCY,
+    DEFAULT_HEAD_LATENCY,
+    DEFAULT_TAIL_LATENCY,
 )
+from . import motord
+from .lipsync import MOUTH_OPEN, MOUTH_STOP, LipSync
 
 
 # === Configuration ===
@@ -48,9 +54,33 @@ motor_pins = [MOUTH_IN1, MOUTH_IN2, HEAD_IN1, HEAD_IN2]
 if USE_THIRD_MOTOR:
     motor_pins += [TAIL_IN1, TAIL_IN2]
 
-for pin in motor_pins:
-    lgpio.gpio_claim_output(h, pin)
-    lgpio.gpio_write(h, pin, 0)
+# The native motor daemon (tools/motord) claims the pins itself when it is built
+_daemon = motord.MotorDaemon.open_gpio(
+    [MOUTH_IN1, MOUTH_IN2, HEAD_IN1, HEAD_IN2]
+    + ([TAIL_IN1, TAIL_IN2] if USE_THIRD_MOTOR else [-1, -1]),
+    FREQ,
+    DEFAULT_MOTOR_IDLE_TIMEOUT,
+)
+# Daemon motor behind each forward pin, for set_motor_speed()
+_DAEMON_MOTORS = {MOUTH_IN1: motord.MOUTH, HEAD_IN1: motord.HEAD}
+if USE_THIRD_MOTOR:
+    _DAEMON_MOTORS[TAIL_IN1] = motord.TAIL
+
+# Position of the audio output, anchored by the playback thread; moves given
+# at_sample are applied when the speaker reaches that frame
+audio_clock = None
+
+if _daemon is not None:
+    print(f"⚙️ Motor daemon running ({'realtime' if _daemon.realtime else 'normal'} priority)")
+    audio_clock = motord.SampleClock.stream(DEFAULT_SAMPLE_RATE)
+    _daemon.set_clock(audio_clock)
+    _daemon.set_latency(motord.MOUTH, DEFAULT_MOUTH_LATENCY)
+    _daemon.set_latency(motord.HEAD, DEFAULT_HEAD_LATENCY)
+    _daemon.set_latency(motord.TAIL, DEFAULT_TAIL_LATENCY)
+else:
+    for pin in motor_pins:
+        lgpio.gpio_claim_output(h, pin)
+        lgpio.gpio_write(h, pin, 0)
 
 # === State ===
 _head_tail_lock = Lock()
@@ -58,6 +88,8 @@ _motor_watchdog_running = False
 _last_flap = 0
 _mouth_open_until = 0
 _last_rms = 0
+_lipsync_engines = {}  # (threshold, min_flap_gap) -> LipSync
+_last_choreo_frame = None
 head_out = False
 
 
@@ -78,15 +110,24 @@ def run_motor(pwm_pin, low_pin, speed_percent=100, duration=0.3, brake=True):
 
 
 # === Movement Functions ===
-def move_mouth(speed_percent, duration, brake=False):
+# at_sample: frame of audio_clock the move belongs to. With the motor daemon it
+# waits for the speaker to reach that frame; otherwise it applies at once.
+def move_mouth(speed_percent, duration, brake=False, at_sample=None):
+    if _daemon is not None:
+        # Without brake the mouth keeps its speed until the next command, as below
+        _daemon.push(motord.MOUTH, speed_percent, duration if brake else 0, at_sample=at_sample)
+        return
     run_motor(MOUTH_IN1, MOUTH_IN2, speed_percent, duration, brake)
 
 
-def stop_mouth():
+def stop_mouth(at_sample=None):
+    if _daemon is not None:
+        _daemon.push(motord.MOUTH, 0, at_sample=at_sample)
+        return
     brake_motor(MOUTH_IN1, MOUTH_IN2)
 
 
-def move_head(state="on"):
+def move_head(state="on", at_sample=None):
     global head_out
 
     def _move_head_on():
@@ -97,36 +138,156 @@ def move_head(state="on"):
 
     if state == "on":
         if not head_out:
-            threading.Thread(target=_move_head_on, daemon=True).start()
+            if _daemon is not None:
+                _daemon.push(
+                    motord.HEAD,
+                    DEFAULT_HEAD_SPEED,
+                    DEFAULT_HEAD_DURATION,
+                    then_speed=100,
+                    at_sample=at_sample,
+                )
+            else:
+                threading.Thread(target=_move_head_on, daemon=True).start()
             head_out = True
     else:
-        brake_motor(HEAD_IN1, HEAD_IN2)
+        if _daemon is not None:
+            _daemon.push(motord.HEAD, 0, cancel=True, at_sample=at_sample)
+        else:
+            brake_motor(HEAD_IN1, HEAD_IN2)
+        head_out = False
+
+
+def _tail_takes_head():
+    # A two-motor fish flaps its tail on the head motor, which brakes after it
+    global head_out
+    if not USE_THIRD_MOTOR:
         head_out = False
 
 
 def move_tail(duration=DEFAULT_TAIL_DURATION):
+    _tail_takes_head()
+    if _daemon is not None:
+        _daemon.push(motord.TAIL, DEFAULT_TAIL_SPEED, duration)
+        time.sleep(duration)  # Callers pace their moves on this returning
+        return
     if USE_THIRD_MOTOR:
         run_motor(TAIL_IN1, TAIL_IN2, speed_percent=DEFAULT_TAIL_SPEED, duration=duration)
     else:
         run_motor(HEAD_IN2, HEAD_IN1, speed_percent=DEFAULT_TAIL_SPEED, duration=duration)
 
 
-def move_tail_async(duration=0.3):
+def move_tail_async(duration=0.3, at_sample=None):
+    _tail_takes_head()
+    if _daemon is not None:
+        _daemon.push(motord.TAIL, DEFAULT_TAIL_SPEED, duration, at_sample=at_sample)
+        return
     threading.Thread(target=move_tail, args=(duration,), daemon=True).start()
 
 
+def set_motor_speed(pin_forward, pin_backward, value, at_sample=None):
+    """Drive a motor without blocking; value is a signed speed in -255..255."""
+    speed_percent = min(abs(value), 255) * 100 // 255
+    if _daemon is not None:
+        _daemon.push(
+            _DAEMON_MOTORS[pin_forward],
+            speed_percent if value > 0 else -speed_percent,
+            at_sample=at_sample,
+        )
+        return
+    if speed_percent == 0:
+        brake_motor(pin_forward, pin_backward)
+        return
+    pwm_pin, low_pin = (pin_forward, pin_backward) if value > 0 else (pin_backward, pin_forward)
+    lgpio.tx_pwm(h, low_pin, FREQ, 0)
+    lgpio.gpio_write(h, low_pin, 0)
+    lgpio.tx_pwm(h, pwm_pin, FREQ, speed_percent)
+
+
+def drive_choreography(mouth, body, tail=0, at_sample=None):
+    """
+    Apply one frame of a precompiled choreography (see core/choreography.py).
+    Body forward extends the head, backward flaps the tail; a tail track drives
+    the third motor, or the body motor backward on two-motor fish.
+    """
+    global head_out, _last_choreo_frame
+    frame = (mouth, body, tail)
+    if frame == _last_choreo_frame:
+        return
+    _last_choreo_frame = frame
+
+    set_motor_speed(MOUTH_IN1, MOUTH_IN2, mouth, at_sample)
+    if USE_THIRD_MOTOR:
+        set_motor_speed(HEAD_IN1, HEAD_IN2, max(body, 0), at_sample)
+        set_motor_speed(TAIL_IN1, TAIL_IN2, abs(tail) or max(-body, 0), at_sample)
+    else:
+        set_motor_speed(HEAD_IN1, HEAD_IN2, body or -abs(tail), at_sample)
+    head_out = body > 0
+
+
 # === Mouth Sync ===
 def flap_from_pcm_chunk(
-    audio, threshold=1500, min_flap_gap=0.1, chunk_ms=40, sample_rate=24000
+    audio, threshold=1500, min_flap_gap=0.1, chunk_ms=40, sample_rate=24000, at_sample=None
 ):
-    global _last_flap, _mouth_open_until, _last_rms
-    now = time.time()
-
+    """
+    Flap the mouth to one chunk of speech. With at_sample (the chunk's first
+    frame on audio_clock) flap timing follows the audio rather than the wall
+    clock, and the move waits for the speaker to reach the chunk.
+    """
     if audio.size == 0:
         return
 
+    now = time.time() if at_sample is None else at_sample / sample_rate
+
+    # Native fixed-point engine, shared with the firmware, when it is built
+    engine = _lipsync_for(threshold, min_flap_gap)
+    command = engine.process(audio, chunk_ms, now=None if at_sample is None else now)
+    if command is not None:
+        _follow_lipsync(command, at_sample)
+        return
+
     rms = np.sqrt(np.mean(audio.astype(np.float32) ** 2))
     peak = np.max(np.abs(audio))
+    _flap_from_rms(rms, peak, now, threshold, min_flap_gap, chunk_ms, at_sample)
+
+
+def flap_from_levels(
+    rms, peak, threshold=1500, min_flap_gap=0.1, chunk_ms=40, sample_rate=24000, at_sample=None
+):
+    """
+    Flap the mouth to a chunk whose RMS and peak were measured ahead of
+    time (a song's stem index), as flap_from_pcm_chunk() would for its samples.
+    """
+    now = time.time() if at_sample is None else at_sample / sample_rate
+
+    engine = _lipsync_for(threshold, min_flap_gap)
+    command = engine.levels(rms, peak, chunk_ms, now=None if at_sample is None else now)
+    if command is not None:
+        _follow_lipsync(command, at_sample)
+        return
+
+    _flap_from_rms(float(rms), float(peak), now, threshold, min_flap_gap, chunk_ms, at_sample)
+
+
+def _lipsync_for(threshold, min_flap_gap):
+    """The engine for one threshold and flap gap, which are fixed at creation."""
+    key = (threshold, min_flap_gap)
+    engine = _lipsync_engines.get(key)
+    if engine is None:
+        engine = _lipsync_engines[key] = LipSync(threshold, min_flap_gap)
+    return engine
+
+
+def _follow_lipsync(command, at_sample):
+    if command.mouth == MOUTH_STOP:
+        stop_mouth(at_sample)
+    elif command.mouth == MOUTH_OPEN:
+        move_mouth(
+            command.mouth_speed, command.mouth_ms / 1000.0, brake=False, at_sample=at_sample
+        )
+
+
+def _flap_from_rms(rms, peak, now, threshold, min_flap_gap, chunk_ms, at_sample):
+    global _last_flap, _mouth_open_until, _last_rms
 
     # Smooth out sudden fluctuations
     if '_last_rms' not in globals():
@@ -137,7 +298,7 @@ def flap_from_pcm_chunk(
 
     # If too quiet and mouth might be open, stop motor
     if rms < threshold / 2 and now >= _mouth_open_until:
-        stop_mouth()
+        stop_mouth(at_sample)
         return
 
     if rms <= threshold or (now - _last_flap) < min_flap_gap:
@@ -156,7 +317,7 @@ def flap_from_pcm_chunk(
     _last_flap = now
     _mouth_open_until = now + duration
 
-    move_mouth(speed, duration, brake=False)
+    move_mouth(speed, duration, brake=False, at_sample=at_sample)
 
 
 # === Interlude Behavior ===
@@ -185,8 +346,13 @@ def interlude():
 
 # === Motor Watchdog ===
 def stop_all_motors():
+    global _last_choreo_frame
     print("🛑 Stopping all motors")
+    _last_choreo_frame = None
     move_head("off")
+    if _daemon is not None:
+        _daemon.push(motord.ALL, 0, cancel=True)
+        return
     for pin in motor_pins:
         lgpio.tx_pwm(h, pin, FREQ, 0)
         lgpio.gpio_write(h, pin, 0)
@@ -198,6 +364,8 @@ def is_motor_active():
 
 def motor_watchdog():
     """Background thread that stops motors if active too long."""
+    if _daemon is not None:
+        return  # The daemon's control tick has its own watchdog
     global _motor_watchdog_running
     _motor_watchdog_running = True
     last_activity = time.time()
@@ -224,5 +392,7 @@ def stop_motor_watchdog():
     _motor_watchdog_running = False
 
 
+if _daemon is not None:
+    atexit.register(_daemon.close)  # Runs last: atexit calls in reverse order
 atexit.register(stop_all_motors)
 atexit.register(stop_motor_watchdog)
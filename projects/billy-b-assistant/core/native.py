@@ -0,0 +1,43 @@
+"""
+Loading of the optional native libraries built from tools/ and
+shared/libraries (see README). Each library sits next to this file or at
+the path in its environment variable; a module whose library is missing
+falls back to its Python path.
+"""
+import ctypes
+import os
+from typing import Callable, Dict, Optional
+
+
+_libraries: Dict[str, Optional[ctypes.CDLL]] = {}
+
+
+def load_native(
+    env: str,
+    name: str,
+    configure: Callable[[ctypes.CDLL], None],
+    fallback: str,
+) -> Optional[ctypes.CDLL]:
+    """Load library `name` once; None when it is not built or fails to load.
+
+    configure declares the restype/argtypes of its functions. fallback says
+    what is used instead, for the warning printed when loading fails.
+    """
+    if name in _libraries:
+        return _libraries[name]
+    _libraries[name] = None
+
+    path = os.environ.get(env) or os.path.join(
+        os.path.dirname(os.path.abspath(__file__)), name
+    )
+    if not os.path.exists(path):
+        return None
+    try:
+        lib = ctypes.CDLL(path)
+    except OSError as e:
+        print(f"⚠️ Could not load {path}, {fallback}: {e}")
+        return None
+
+    configure(lib)
+    _libraries[name] = lib
+    return lib
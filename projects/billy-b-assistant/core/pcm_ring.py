@@ -0,0 +1,202 @@
+"""
+Shared-memory PCM ring between song decoding, audio output and motion analysis.
+Uses tools/pcmring when libpcmring.so is built (see README): the decoder
+writes planar int16 frames into shared memory once, and the audio writer and
+any number of analysis readers (mouth, tail, telemetry) read them in place
+as numpy views. Without it, songs go through playback_queue as before.
+"""
+import ctypes
+from typing import List, Optional, Tuple
+
+import numpy as np
+
+from .native import load_native
+
+
+LIBRARY_ENV = "BILLY_PCMRING_LIB"
+LIBRARY_NAME = "libpcmring.so"
+
+END = 1
+CANCEL = 2
+
+
+def _declare(lib: ctypes.CDLL) -> None:
+    ring = ctypes.c_void_p
+    lib.pcm_ring_create.restype = ring
+    lib.pcm_ring_create.argtypes = [ctypes.c_char_p, ctypes.c_uint32, ctypes.c_uint32, ctypes.c_uint32]
+    lib.pcm_ring_open.restype = ring
+    lib.pcm_ring_open.argtypes = [ctypes.c_char_p]
+    lib.pcm_ring_close.argtypes = [ring]
+    for name in ("pcm_ring_channels", "pcm_ring_capacity", "pcm_ring_sample_rate", "pcm_ring_flags"):
+        getattr(lib, name).restype = ctypes.c_uint32
+        getattr(lib, name).argtypes = [ring]
+    lib.pcm_ring_channel.restype = ctypes.POINTER(ctypes.c_int16)
+    lib.pcm_ring_channel.argtypes = [ring, ctypes.c_uint32]
+    for name in ("pcm_ring_written", "pcm_ring_played"):
+        getattr(lib, name).restype = ctypes.c_uint64
+        getattr(lib, name).argtypes = [ring]
+    for name in ("pcm_ring_writable", "pcm_ring_playable"):
+        getattr(lib, name).restype = ctypes.c_size_t
+        getattr(lib, name).argtypes = [ring]
+    for name in ("pcm_ring_commit", "pcm_ring_release"):
+        getattr(lib, name).argtypes = [ring, ctypes.c_size_t]
+    lib.pcm_ring_set_flags.argtypes = [ring, ctypes.c_uint32]
+    lib.pcm_ring_attach.argtypes = [ring]
+    lib.pcm_ring_detach.argtypes = [ring, ctypes.c_int]
+    lib.pcm_ring_available.restype = ctypes.c_size_t
+    lib.pcm_ring_available.argtypes = [ring, ctypes.c_int, ctypes.POINTER(ctypes.c_uint64)]
+    lib.pcm_ring_consume.argtypes = [ring, ctypes.c_int, ctypes.c_size_t]
+    lib.pcm_ring_intact.argtypes = [ring, ctypes.c_uint64]
+    lib.pcm_ring_lapped.restype = ctypes.c_uint64
+    lib.pcm_ring_lapped.argtypes = [ring, ctypes.c_int]
+    lib.pcm_ring_reset.argtypes = [ring]
+
+
+def _load_library() -> Optional[ctypes.CDLL]:
+    """Load the native ring once; None when it is not built."""
+    return load_native(
+        LIBRARY_ENV, LIBRARY_NAME, _declare, "songs use the playback queue"
+    )
+
+
+def native_available() -> bool:
+    """True when libpcmring.so can be loaded."""
+    return _load_library() is not None
+
+
+class PcmRing:
+    """
+    One producer, one audio reader (peek/release) and up to eight analysis
+    readers (attach). Positions are frame counts since the stream began.
+    """
+
+    def __init__(self, lib: ctypes.CDLL, handle: int):
+        self._lib = lib
+        self._handle = handle
+        self.channels = lib.pcm_ring_channels(handle)
+        self.capacity = lib.pcm_ring_capacity(handle)
+        self.sample_rate = lib.pcm_ring_sample_rate(handle)
+        # One numpy view per channel over the shared mapping; slices never copy
+        self._planes = [
+            np.ctypeslib.as_array(lib.pcm_ring_channel(handle, c), shape=(self.capacity,))
+            for c in range(self.channels)
+        ]
+
+    @classmethod
+    def create(cls, name: str, channels: int, capacity: int, sample_rate: int) -> Optional["PcmRing"]:
+        lib = _load_library()
+        if lib is None:
+            return None
+        handle = lib.pcm_ring_create(name.encode(), channels, capacity, sample_rate)
+        return cls(lib, handle) if handle else None
+
+    @classmethod
+    def open(cls, name: str) -> Optional["PcmRing"]:
+        lib = _load_library()
+        if lib is None:
+            return None
+        handle = lib.pcm_ring_open(name.encode())
+        return cls(lib, handle) if handle else None
+
+    def _span(self, position: int, frames: int) -> Tuple[int, int]:
+        """Offset and length of the contiguous part of frames at position."""
+        offset = position % self.capacity
+        return offset, min(frames, self.capacity - offset)
+
+    # === Producer ===
+    @property
+    def written(self) -> int:
+        return self._lib.pcm_ring_written(self._handle)
+
+    def writable(self) -> int:
+        return self._lib.pcm_ring_writable(self._handle)
+
+    def write(self, *channels: np.ndarray) -> int:
+        """Copy as many frames of every channel as fit; returns the count."""
+        position = self.written
+        frames = min(len(channels[0]), self.writable())
+        done = 0
+        while done < frames:
+            offset, count = self._span(position + done, frames - done)
+            for plane, samples in zip(self._planes, channels):
+                plane[offset:offset + count] = samples[done:done + count]
+            done += count
+        self._lib.pcm_ring_commit(self._handle, frames)
+        return frames
+
+    def finish(self) -> None:
+        """No more frames will be written."""
+        self._lib.pcm_ring_set_flags(self._handle, END)
+
+    def cancel(self) -> None:
+        """Ask every reader to stop now."""
+        self._lib.pcm_ring_set_flags(self._handle, CANCEL)
+
+    @property
+    def flags(self) -> int:
+        return self._lib.pcm_ring_flags(self._handle)
+
+    # === Audio reader ===
+    @property
+    def played(self) -> int:
+        return self._lib.pcm_ring_played(self._handle)
+
+    def peek(self, channel: int, frames: int) -> np.ndarray:
+        """Up to frames unplayed samples of channel, in place (may stop at the wrap)."""
+        available = self._lib.pcm_ring_playable(self._handle)
+        offset, count = self._span(self.played, min(frames, available))
+        return self._planes[channel][offset:offset + count]
+
+    def release(self, frames: int) -> None:
+        """Mark frames as played; the producer may then reuse them."""
+        self._lib.pcm_ring_release(self._handle, frames)
+
+    # === Analysis readers ===
+    def attach(self) -> Optional["RingReader"]:
+        reader = self._lib.pcm_ring_attach(self._handle)
+        return RingReader(self, reader) if reader >= 0 else None
+
+    def close(self) -> None:
+        """Unmap the ring (the creator also removes it); views become invalid."""
+        if self._handle is not None:
+            self._planes = []
+            self._lib.pcm_ring_close(self._handle)
+            self._handle = None
+
+    def __del__(self):
+        if getattr(self, "_handle", None) is not None:
+            self.close()
+
+
+class RingReader:
+    """An analysis cursor that trails the audio reader and never holds it up."""
+
+    def __init__(self, ring: PcmRing, reader: int):
+        self._ring = ring
+        self._reader = reader
+        self._position = ctypes.c_uint64()
+
+    def read(self, frames: int) -> Tuple[int, List[np.ndarray]]:
+        """
+        Position and in-place views of up to frames already played frames,
+        one view per channel. Check intact(position) after using them.
+        """
+        ring = self._ring
+        available = ring._lib.pcm_ring_available(ring._handle, self._reader, ctypes.byref(self._position))
+        position = self._position.value
+        offset, count = ring._span(position, min(frames, available))
+        return position, [plane[offset:offset + count] for plane in ring._planes]
+
+    def consume(self, frames: int) -> None:
+        self._ring._lib.pcm_ring_consume(self._ring._handle, self._reader, frames)
+
+    def intact(self, position: int) -> bool:
+        """The producer has not overwritten the frames read at position."""
+        return bool(self._ring._lib.pcm_ring_intact(self._ring._handle, position))
+
+    @property
+    def lapped(self) -> int:
+        return self._ring._lib.pcm_ring_lapped(self._ring._handle, self._reader)
+
+    def detach(self) -> None:
+        self._ring._lib.pcm_ring_detach(self._ring._handle, self._reader)
@@ -0,0 +1,84 @@
+"""
+Streaming sample-rate conversion for PCM chunks.
+Uses the native polyphase resampler from shared/libraries/arduinoFFT when
+libfftresampler.so is built (see README), which keeps filter state between
+chunks; otherwise falls back to scipy.signal.resample on each chunk.
+"""
+import ctypes
+from typing import Optional
+
+import numpy as np
+from scipy.signal import resample
+
+from .native import load_native
+
+
+LIBRARY_ENV = "BILLY_RESAMPLER_LIB"
+LIBRARY_NAME = "libfftresampler.so"
+TAPS_PER_PHASE = 32
+
+
+def _declare(lib: ctypes.CDLL) -> None:
+    lib.fft_resampler_create.restype = ctypes.c_void_p
+    lib.fft_resampler_create.argtypes = [ctypes.c_uint32] * 3
+    lib.fft_resampler_destroy.argtypes = [ctypes.c_void_p]
+    lib.fft_resampler_process_s16.restype = ctypes.c_size_t
+    lib.fft_resampler_process_s16.argtypes = [
+        ctypes.c_void_p, ctypes.c_void_p, ctypes.c_size_t, ctypes.c_void_p
+    ]
+    lib.fft_resampler_reset.argtypes = [ctypes.c_void_p]
+
+
+def _load_library() -> Optional[ctypes.CDLL]:
+    """Load the native resampler once; None when it is not built."""
+    return load_native(LIBRARY_ENV, LIBRARY_NAME, _declare, "using scipy resampling")
+
+
+def native_available() -> bool:
+    """True when chunks go through the native resampler."""
+    return _load_library() is not None
+
+
+class StreamResampler:
+    """Converts consecutive int16 chunks of one stream between two rates."""
+
+    def __init__(self, input_rate: int, output_rate: int):
+        self.input_rate = int(input_rate)
+        self.output_rate = int(output_rate)
+        self._lib = _load_library()
+        self._handle = None
+        if self._lib is not None and self.input_rate != self.output_rate:
+            self._handle = self._lib.fft_resampler_create(
+                self.input_rate, self.output_rate, TAPS_PER_PHASE
+            )
+
+    def process(self, samples: np.ndarray) -> np.ndarray:
+        """Resample the next chunk of the stream to int16 at output_rate."""
+        if self.input_rate == self.output_rate:
+            return np.asarray(samples).astype(np.int16, copy=False)
+
+        if self._handle is None:
+            return resample(
+                samples, int(len(samples) * self.output_rate / self.input_rate)
+            ).astype(np.int16)
+
+        # int16 chunks are passed to the filter without a copy
+        chunk = np.ascontiguousarray(samples, dtype=np.int16)
+        # fft_resampler_max_output(), without another call into the library
+        out = np.empty(
+            len(chunk) * self.output_rate // self.input_rate + 1, dtype=np.int16
+        )
+        produced = self._lib.fft_resampler_process_s16(
+            self._handle, chunk.ctypes.data, len(chunk), out.ctypes.data
+        )
+        return out[:produced]
+
+    def reset(self) -> None:
+        """Forget the filter history before an unrelated stream."""
+        if self._handle is not None:
+            self._lib.fft_resampler_reset(self._handle)
+
+    def __del__(self):
+        if getattr(self, "_handle", None) is not None:
+            self._lib.fft_resampler_destroy(self._handle)
+            self._handle = None
@@ -1,5 +1,4 @@
 import asyncio
-import base64
 import json
 
 import websockets.legacy.client
@@ -78,7 +77,6 @@ async def say(text: str):
 
 async def _process_say_response(ws, stream_processor, audio_processor):
     """Process the response from the say command."""
-    full_audio = bytearray()
     full_text = ""
 
     # Ensure playback thread is running
@@ -93,9 +91,8 @@ async def _process_say_response(ws, stream_processor, audio_processor):
             if parsed["type"] in ("response.audio", "response.audio.delta"):
                 b64 = parsed.get("audio") or parsed.get("delta")
                 if b64:
-                    chunk = base64.b64decode(b64)
+                    # Decoded once; the processor keeps the whole response
                     stream_processor.process_audio_delta(b64)
-                    full_audio.extend(chunk)
 
             # Capture text
             if parsed["type"] in ("response.text.delta", "response.audio_transcript.delta"):
@@ -107,6 +104,7 @@ async def _process_say_response(ws, stream_processor, audio_processor):
                 await ws.send(json.dumps({"type": WS_SESSION_END}))
                 break
 
+        full_audio = stream_processor.audio_buffer
         print(f"✅ Audio received: {len(full_audio)} bytes")
         print(f"📝 Transcript: {full_text.strip()}")
 
@@ -48,6 +48,7 @@ from .constants import (
 )
 from .ha import send_conversation_prompt
 from .mic import MicManager
+from .mic_front import MicFrontEnd
 from .movements import move_tail_async, stop_all_motors
 from .mqtt import mqtt_publish
 from .personality import update_persona_ini
@@ -112,6 +113,7 @@ class BillySession:
         self.allow_mic_input = True
         self.interrupt_event = interrupt_event or asyncio.Event()
         self.mic = MicManager()
+        self.mic_front = None
         self.mic_timeout_task: asyncio.Task | None = None
 
         # Track whenever a session is updated after creation, and OpenAI is ready to
@@ -168,19 +170,27 @@ class BillySession:
     def mic_callback(self, indata, *_):
         if not self.allow_mic_input or not self.session_active.is_set():
             return
-        samples = indata[:, 0]
-        rms = np.sqrt(np.mean(np.square(samples.astype(np.float32))))
+        packet = self.mic_front.process(indata) if self.mic_front else None
+        if packet is not None:
+            rms, voice = packet.rms, packet.voice
+        else:
+            samples = indata[:, 0]
+            rms = np.sqrt(np.mean(np.square(samples.astype(np.float32))))
+            voice = rms > SILENCE_THRESHOLD
         self.last_rms = rms
 
         if DEBUG_MODE:
             print(f"\r🎙 Mic Volume: {rms:.1f}     ", end='', flush=True)
 
-        if rms > SILENCE_THRESHOLD:
+        if voice:
             self.last_activity[0] = time.time()
             self.user_spoke_after_assistant = True
 
         if self.ws_client:
-            audio.send_mic_audio(self.ws_client.ws, samples, self.loop)
+            if packet is not None:
+                audio.send_mic_message(self.ws_client.ws, packet.message, self.loop)
+            else:
+                audio.send_mic_audio(self.ws_client.ws, samples, self.loop)
 
     async def run_stream(self):
         if not TEXT_ONLY_MODE and audio.playback_done_event.is_set():
@@ -195,6 +205,9 @@ class BillySession:
         )
 
         try:
+            # Native DC removal, RMS, voice hangover, resampling and encoding
+            front = MicFrontEnd(audio.MIC_RATE, audio.MIC_CHANNELS, SILENCE_THRESHOLD)
+            self.mic_front = front if front.available else None
             self.mic.start(self.mic_callback)
 
             async for data in self.ws_client.listen_for_response():
@@ -0,0 +1,141 @@
+"""
+Per-chunk levels of a song's vocal and drum stems, cached as stems.idx.
+tools/stemindex builds the index in one native pass over the memory-mapped
+stems when libstemindex.so is built (see README); later plays read it here
+and skip decoding and analysing the stems. Without the library play_song()
+analyses the stems live as before.
+"""
+import ctypes
+import os
+from typing import Optional
+
+import numpy as np
+
+from .native import load_native
+
+
+INDEX_FILENAME = "stems.idx"
+LIBRARY_ENV = "BILLY_STEMINDEX_LIB"
+LIBRARY_NAME = "libstemindex.so"
+
+DRUM_ONSET = 1
+
+_MAGIC = b"BSIX"
+_VERSION = 1
+
+# Mirrors StemIndexHeader and StemLevels in tools/stemindex/StemIndex.h
+_HEADER = np.dtype([
+    ("magic", "S4"),
+    ("version", "<u2"),
+    ("chunk_ms", "<u2"),
+    ("chunks", "<u4"),
+    ("gain", "<f4"),
+])
+LEVELS = np.dtype([
+    ("vocal_rms", "<u2"),
+    ("vocal_peak", "<u2"),
+    ("drum_rms", "<u2"),
+    ("flags", "u1"),
+    ("reserved", "u1"),
+])
+
+_SOURCES = ("vocals.wav", "drums.wav", "metadata.txt")
+
+
+def _declare(lib: ctypes.CDLL) -> None:
+    lib.stem_index_build.restype = ctypes.c_long
+    lib.stem_index_build.argtypes = [ctypes.c_char_p, ctypes.c_uint32, ctypes.c_float]
+
+
+def _load_library() -> Optional[ctypes.CDLL]:
+    """Load the native analyzer once; None when it is not built."""
+    return load_native(
+        LIBRARY_ENV, LIBRARY_NAME, _declare, "songs analyse their stems live"
+    )
+
+
+def native_available() -> bool:
+    """True when missing indexes can be built."""
+    return _load_library() is not None
+
+
+class StemIndex:
+    """Levels of consecutive chunk_ms chunks, in int16 units after the song's gain."""
+
+    def __init__(self, chunk_ms: int, gain: float, levels: np.ndarray):
+        self.chunk_ms = chunk_ms
+        self.gain = gain
+        self.levels = levels
+
+    def __len__(self) -> int:
+        return len(self.levels)
+
+    def at(self, song_time: float) -> Optional[np.void]:
+        """Levels of the chunk starting song_time seconds in; None past the stems."""
+        index = int(round(song_time * 1000 / self.chunk_ms))
+        if 0 <= index < len(self.levels):
+            return self.levels[index]
+        return None
+
+    def onsets(self) -> np.ndarray:
+        """Song times, in seconds, of the chunks flagged as drum onsets."""
+        chunks = np.flatnonzero(self.levels["flags"] & DRUM_ONSET)
+        return chunks * (self.chunk_ms / 1000.0)
+
+
+def decode_stem_index(data: bytes) -> StemIndex:
+    """Decode a stems.idx blob; raises ValueError on a malformed one."""
+    if len(data) < _HEADER.itemsize:
+        raise ValueError("not a stem index")
+    header = np.frombuffer(data, dtype=_HEADER, count=1)[0]
+    if header["magic"] != _MAGIC or header["version"] != _VERSION or not header["chunk_ms"]:
+        raise ValueError("not a stem index")
+    chunks = int(header["chunks"])
+    if len(data) < _HEADER.itemsize + chunks * LEVELS.itemsize:
+        raise ValueError("truncated stem index")
+    levels = np.frombuffer(data, dtype=LEVELS, count=chunks, offset=_HEADER.itemsize)
+    return StemIndex(int(header["chunk_ms"]), float(header["gain"]), levels)
+
+
+def _is_fresh(song_dir: str, path: str) -> bool:
+    """The index is newer than both stems and the metadata (gain)."""
+    built = os.path.getmtime(path)
+    for name in _SOURCES:
+        source = os.path.join(song_dir, name)
+        if os.path.exists(source) and os.path.getmtime(source) > built:
+            return False
+    return True
+
+
+def load_stem_index(song_dir: str, chunk_ms: int, gain: float) -> Optional[StemIndex]:
+    """
+    SONG_DIR/stems.idx if it matches chunk_ms and gain and is up to date
+    with the stems; None otherwise.
+    """
+    path = os.path.join(song_dir, INDEX_FILENAME)
+    if not os.path.exists(path) or not _is_fresh(song_dir, path):
+        return None
+    try:
+        with open(path, "rb") as f:
+            index = decode_stem_index(f.read())
+    except (OSError, ValueError) as e:
+        print(f"⚠️ Ignoring {path}: {e}")
+        return None
+    if index.chunk_ms != chunk_ms or np.float32(index.gain) != np.float32(gain):
+        return None
+    return index
+
+
+def stem_index(song_dir: str, chunk_ms: int, gain: float) -> Optional[StemIndex]:
+    """The song's index, building it first when it is missing or stale."""
+    index = load_stem_index(song_dir, chunk_ms, gain)
+    if index is not None:
+        return index
+
+    lib = _load_library()
+    if lib is None:
+        return None
+    if lib.stem_index_build(song_dir.encode(), int(chunk_ms), float(gain)) < 0:
+        return None
+    print(f"📇 Indexed the stems of {os.path.basename(os.path.normpath(song_dir))}")
+    return load_stem_index(song_dir, chunk_ms, gain)
@@ -0,0 +1,147 @@
+"""
+WAV files read as numpy views of a memory mapping.
+Uses tools/wavmap when libwavmap.so is built (see README): the header is
+validated once, every chunk is a read-only slice of the mapped file with no
+copy and no allocation, and the kernel is asked to read ahead of playback.
+Without it, open_wav() falls back to the wave module with the same interface.
+"""
+import ctypes
+import wave
+from typing import Iterator, Optional, Union
+
+import numpy as np
+
+from .native import load_native
+
+
+LIBRARY_ENV = "BILLY_WAVMAP_LIB"
+LIBRARY_NAME = "libwavmap.so"
+
+# Frames read into the page cache ahead of the chunk being played
+PREFETCH_SECONDS = 1.0
+
+
+def _declare(lib: ctypes.CDLL) -> None:
+    wav = ctypes.c_void_p
+    lib.wavmap_open.restype = wav
+    lib.wavmap_open.argtypes = [ctypes.c_char_p]
+    lib.wavmap_close.argtypes = [wav]
+    lib.wavmap_sample_rate.restype = ctypes.c_uint32
+    lib.wavmap_sample_rate.argtypes = [wav]
+    lib.wavmap_channels.restype = ctypes.c_uint16
+    lib.wavmap_channels.argtypes = [wav]
+    lib.wavmap_frames.restype = ctypes.c_uint64
+    lib.wavmap_frames.argtypes = [wav]
+    lib.wavmap_data.restype = ctypes.c_void_p
+    lib.wavmap_data.argtypes = [wav]
+    lib.wavmap_prefetch.argtypes = [wav, ctypes.c_uint64, ctypes.c_uint64]
+
+
+def _load_library() -> Optional[ctypes.CDLL]:
+    """Load the native reader once; None when it is not built."""
+    return load_native(
+        LIBRARY_ENV, LIBRARY_NAME, _declare, "WAV files are read with the wave module"
+    )
+
+
+def native_available() -> bool:
+    """True when WAV files are memory-mapped."""
+    return _load_library() is not None
+
+
+class _Mapping:
+    """Owns one native mapping; numpy views hold it as their base."""
+
+    def __init__(self, lib: ctypes.CDLL, handle: int, frames: int, channels: int):
+        self.lib = lib
+        self.handle = handle
+        self.__array_interface__ = {
+            "version": 3,
+            "shape": (frames, channels),
+            "typestr": "<i2",
+            "data": (lib.wavmap_data(handle) or 0, True),  # read-only
+        }
+
+    def __del__(self):
+        if getattr(self, "handle", None) is not None:
+            self.lib.wavmap_close(self.handle)
+            self.handle = None
+
+
+class MappedWav:
+    """
+    A 16-bit PCM WAV file mapped read-only. samples and every chunk are
+    (frames, channels) int16 views that keep the mapping alive, so they can
+    be queued for playback; the file is unmapped after the last one goes.
+    """
+
+    def __init__(self, lib: ctypes.CDLL, handle: int):
+        self.sample_rate = lib.wavmap_sample_rate(handle)
+        self.channels = lib.wavmap_channels(handle)
+        self.frames = lib.wavmap_frames(handle)
+        self._mapping = _Mapping(lib, handle, self.frames, self.channels)
+        self.samples = np.asarray(self._mapping)
+
+    @classmethod
+    def open(cls, path: str) -> Optional["MappedWav"]:
+        lib = _load_library()
+        if lib is None:
+            return None
+        handle = lib.wavmap_open(path.encode())
+        return cls(lib, handle) if handle else None
+
+    def prefetch(self, first: int, frames: int) -> None:
+        """Start reading frames into the page cache without waiting."""
+        self._mapping.lib.wavmap_prefetch(self._mapping.handle, first, frames)
+
+    def chunks(self, frames: int) -> Iterator[np.ndarray]:
+        """Consecutive views of up to frames frames, reading ahead as they go."""
+        window = max(frames, int(self.sample_rate * PREFETCH_SECONDS))
+        prefetched = 0
+        for first in range(0, self.frames, frames):
+            if first + frames > prefetched:
+                self.prefetch(first, window)
+                prefetched = first + window
+            yield self.samples[first:first + frames]
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        return False
+
+
+class WaveFile:
+    """The same interface on the wave module, for when libwavmap.so is missing."""
+
+    def __init__(self, path: str):
+        self._wave = wave.open(path, "rb")
+        if self._wave.getsampwidth() != 2:
+            self._wave.close()
+            raise ValueError(f"{path}: only 16-bit PCM is supported")
+        self.sample_rate = self._wave.getframerate()
+        self.channels = self._wave.getnchannels()
+        self.frames = self._wave.getnframes()
+
+    def chunks(self, frames: int) -> Iterator[np.ndarray]:
+        while True:
+            data = self._wave.readframes(frames)
+            if not data:
+                return
+            yield np.frombuffer(data, dtype=np.int16).reshape(-1, self.channels)
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self._wave.close()
+        return False
+
+
+def open_wav(path: str) -> Union[MappedWav, WaveFile]:
+    """Memory-map path when the native reader is built, else open it with wave."""
+    if _load_library() is not None:
+        mapped = MappedWav.open(path)
+        if mapped is not None:
+            return mapped
+    return WaveFile(path)
@@ -0,0 +1,6 @@
+import unittest
+
+
+def requires_native(module):
+    """Skip a test case unless the native library behind module is built."""
+    return unittest.skipUnless(module.native_available(), f"{module.LIBRARY_NAME} not built")
@@ -4,6 +4,8 @@ import sys
 import os
 import asyncio
 
+import numpy as np
+
 # Mock hardware-related modules before they're imported
 sys.modules['sounddevice'] = MagicMock()
 sys.modules['lgpio'] = MagicMock()
@@ -43,24 +45,20 @@ head_moves=2.0:1,4.5:0
                 self.assertTrue(metadata["half_tempo_tail_flap"])
                 self.assertEqual(metadata["head_moves"], [(2.0, 1.0), (4.5, 0.0)])
 
-    @patch("core.audio.wave.open")
+    @patch("core.audio.open_wav")
     @patch("core.audio.playback_manager")
     @patch("core.audio.ensure_playback_worker_started")
     @patch("core.audio.stop_all_motors")
     @patch("core.mqtt.mqtt_publish")
     @patch("core.audio.playback_queue") # Mock the queue
-    async def test_play_song(self, mock_playback_queue, mock_mqtt_publish, mock_stop_motors, mock_ensure_worker, mock_playback_manager, mock_wave_open):
+    async def test_play_song(self, mock_playback_queue, mock_mqtt_publish, mock_stop_motors, mock_ensure_worker, mock_playback_manager, mock_open_wav):
         """Test play_song logic (mocking file I/O and playback)."""
 
-        # Mock wave file objects
-        mock_wf = MagicMock()
-        mock_wf.getframerate.return_value = 24000
-        # Return some frames then empty bytes to simulate end of file
-        # We need enough chunks for main, vocals, drums in the first iteration.
-        # In the second iteration, main returns empty, but code reads all 3 before checking.
-        chunk = b'\x00' * 4 * 100
-        mock_wf.readframes.side_effect = [chunk, chunk, chunk, b'', b'', b'']
-        mock_wave_open.return_value.__enter__.return_value = mock_wf
+        # Mock WAV files: one 100-frame stereo chunk each, then the end
+        mock_wav = MagicMock()
+        mock_wav.sample_rate = 24000
+        mock_wav.chunks.side_effect = lambda frames: iter([np.zeros((100, 2), dtype=np.int16)])
+        mock_open_wav.return_value.__enter__.return_value = mock_wav
 
         # Mock load_song_metadata to return valid metadata
         with patch("core.audio.load_song_metadata") as mock_load_metadata:
@@ -0,0 +1,71 @@
+import base64
+import sys
+import unittest
+from unittest.mock import MagicMock, patch
+
+import numpy as np
+
+# Mock hardware-related modules before core is imported
+sys.modules['sounddevice'] = MagicMock()
+sys.modules['lgpio'] = MagicMock()
+sys.modules['gpiozero'] = MagicMock()
+
+from core import base64_codec
+from core.audio_utils import AudioStreamProcessor
+from core.base64_codec import Base64Codec
+from native_support import requires_native
+
+
+class TestBase64Codec(unittest.TestCase):
+    def setUp(self):
+        self.rng = np.random.default_rng(1234)
+
+    def check_round_trips(self, codec):
+        for n in list(range(0, 130)) + [1920, 2400, 65537]:
+            data = self.rng.integers(0, 256, n, dtype=np.uint8).tobytes()
+            text = base64.b64encode(data).decode("utf-8")
+            self.assertEqual(codec.encode(data), text)
+            self.assertEqual(bytes(codec.decode(text)), data)
+            self.assertEqual(bytes(codec.decode(text.encode())), data)
+
+    def test_matches_base64_module(self):
+        self.check_round_trips(Base64Codec())
+
+    def test_fallback_matches_base64_module(self):
+        codec = Base64Codec()
+        codec._lib = None
+        self.check_round_trips(codec)
+
+    def test_lenient_input_falls_back(self):
+        # Line breaks are rejected by the strict native decoder, not by b64decode
+        self.assertEqual(bytes(Base64Codec().decode("QUJD\nREVG")), b"ABCDEF")
+
+    @requires_native(base64_codec)
+    def test_earlier_views_survive_a_larger_chunk(self):
+        codec = Base64Codec()
+        small = codec.decode(base64.b64encode(b"abc").decode())
+        codec.decode(base64.b64encode(bytes(65536)).decode())
+        self.assertEqual(bytes(small), b"abc")
+
+    def test_encodes_int16_arrays(self):
+        pcm = np.arange(-500, 500, dtype=np.int16)
+        self.assertEqual(Base64Codec().encode(pcm), base64.b64encode(pcm.tobytes()).decode())
+
+
+class TestAudioDelta(unittest.TestCase):
+    @patch("core.audio_utils.playback_queue")
+    def test_delta_is_buffered_and_enqueued(self, mock_queue):
+        processor = MagicMock()
+        enqueued = []
+        processor.enqueue_audio_chunk.side_effect = lambda chunk: enqueued.append(bytes(chunk))
+        stream = AudioStreamProcessor(processor)
+        chunks = [np.arange(n, dtype=np.int16).tobytes() for n in (960, 480, 1200)]
+        for chunk in chunks:
+            stream.process_audio_delta(base64.b64encode(chunk).decode())
+        self.assertEqual(stream.get_audio_buffer(), b"".join(chunks))
+        # Each view is consumed before the next delta reuses the buffer
+        self.assertEqual(enqueued, chunks)
+
+
+if __name__ == "__main__":
+    unittest.main()
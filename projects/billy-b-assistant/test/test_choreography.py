@@ -0,0 +1,58 @@
+import sys
+import unittest
+from unittest.mock import MagicMock, patch, mock_open
+
+# Mock hardware-related modules before core is imported
+sys.modules['sounddevice'] = MagicMock()
+sys.modules['lgpio'] = MagicMock()
+sys.modules['gpiozero'] = MagicMock()
+
+from core.choreography import decode_choreography, load_choreography
+
+# Mouth: forward 200 at 0 ms, linear fade to stop at 100 ms, end at 300 ms
+# Body:  backward 100 at 50 ms (step), end at 250 ms
+SAMPLE = bytes([
+    0x42, 0x43, 0x01, 0x02,     # magic, version, two tracks
+    0x08, 0x00, 0x10, 0x00,     # track offsets
+    0x00, 0x01, 0xC8,           # +0    forward 200
+    0x64, 0x04,                 # +100  stop, linear
+    0xC8, 0x01, 0x03,           # +200  end (two-byte varint)
+    0x32, 0x02, 0x64,           # +50   backward 100
+    0xC8, 0x01, 0x03,           # +200  end
+])
+
+
+class TestChoreography(unittest.TestCase):
+    def test_decode_tracks(self):
+        choreo = decode_choreography(SAMPLE)
+        self.assertEqual(choreo.tracks[0], [(0, 200, 0), (100, 0, 1)])
+        self.assertEqual(choreo.tracks[1], [(50, -100, 0)])
+        self.assertEqual(choreo.end_times, [300, 250])
+        self.assertEqual(choreo.duration_ms, 300)
+
+    def test_value_at_interpolates_like_firmware(self):
+        choreo = decode_choreography(SAMPLE)
+        self.assertEqual(choreo.value_at(0, 0), 200)
+        self.assertEqual(choreo.value_at(0, 50), 100)     # halfway through linear fade
+        self.assertEqual(choreo.value_at(0, 150), 0)
+        self.assertEqual(choreo.value_at(0, 300), 0)      # track ended
+        self.assertEqual(choreo.value_at(1, 10), 0)       # before first step
+        self.assertEqual(choreo.value_at(1, 60), -100)
+        self.assertEqual(choreo.value_at(2, 60), 0)       # missing track is idle
+
+    def test_rejects_bad_data(self):
+        with self.assertRaises(ValueError):
+            decode_choreography(b"XX\x01\x00")
+        with self.assertRaises(ValueError):
+            decode_choreography(SAMPLE[:12])
+
+    def test_load_missing_or_invalid(self):
+        with patch("os.path.exists", return_value=False):
+            self.assertIsNone(load_choreography("song"))
+        with patch("os.path.exists", return_value=True):
+            with patch("builtins.open", mock_open(read_data=b"junk")):
+                self.assertIsNone(load_choreography("song"))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,107 @@
+import os
+import sys
+import tempfile
+import unittest
+import wave
+from unittest.mock import MagicMock, patch
+
+import numpy as np
+
+# Mock hardware-related modules before core is imported
+sys.modules['sounddevice'] = MagicMock()
+sys.modules['lgpio'] = MagicMock()
+sys.modules['gpiozero'] = MagicMock()
+
+from core import audio_playback, clip_cache
+from core.audio_playback import AudioPlaybackManager
+from core.clip_cache import KEYFRAME, CachedClip, ClipCache
+from core.lipsync import MOUTH_OPEN, MOUTH_STOP
+from native_support import requires_native
+
+
+def write_wav(path, samples, rate=24000):
+    with wave.open(path, "wb") as wf:
+        wf.setnchannels(1)
+        wf.setsampwidth(2)
+        wf.setframerate(rate)
+        wf.writeframes(samples.astype(np.int16).tobytes())
+
+
+@requires_native(clip_cache)
+class TestClipCache(unittest.TestCase):
+    def setUp(self):
+        self.dir = tempfile.TemporaryDirectory()
+        self.addCleanup(self.dir.cleanup)
+        t = np.arange(24000) / 24000
+        # 0.5 s of quiet, then 0.5 s of a loud tone the mouth should open to
+        self.speech = np.where(t < 0.5, 0, 6000 * np.sin(2 * np.pi * 220 * t))
+        self.quiet = 300 * np.sin(2 * np.pi * 440 * t[:12000])
+        self.paths = [os.path.join(self.dir.name, name) for name in ("speech.wav", "quiet.wav")]
+        write_wav(self.paths[0], self.speech)
+        write_wav(self.paths[1], self.quiet)
+
+    def test_clips_are_output_ready(self):
+        cache = ClipCache.load(self.paths, 48000, 50)
+        speech, quiet = cache.clips
+        self.assertEqual(speech.samples.shape, (48000, 2))
+        self.assertEqual(quiet.samples.shape, (24000, 2))
+        self.assertFalse(speech.samples.flags.writeable)
+        np.testing.assert_array_equal(speech.samples[:, 0], speech.samples[:, 1])
+        # Both are brought to the same loudness
+        for clip in cache.clips:
+            rms = np.sqrt(np.mean(clip.samples[:, 0].astype(float) ** 2))
+            self.assertAlmostEqual(rms, 3000, delta=30)
+
+    def test_mouth_opens_with_the_tone(self):
+        keyframes = ClipCache.load(self.paths[:1], 48000, 50).clips[0].keyframes
+        opens = keyframes["frame"][keyframes["mouth"] == MOUTH_OPEN]
+        self.assertGreater(len(opens), 0)
+        self.assertEqual(opens[0], 24000)
+        self.assertTrue(np.all(np.diff(keyframes["frame"].astype(int)) > 0))
+
+    def test_skips_unreadable_clips(self):
+        bad = os.path.join(self.dir.name, "bad.wav")
+        with open(bad, "wb") as f:
+            f.write(b"not a wav")
+        cache = ClipCache.load([bad, self.paths[1]], 48000, 50)
+        self.assertEqual([clip.path for clip in cache.clips], [self.paths[1]])
+        self.assertIsNone(ClipCache.load([bad], 48000, 50))
+
+
+class TestPlayClip(unittest.TestCase):
+    def test_keyframes_follow_the_audio_clock(self):
+        manager = AudioPlaybackManager()
+        manager.frames_written = 1000
+        samples = np.zeros((9600, 2), dtype=np.int16)
+        keyframes = np.array([(2400, MOUTH_OPEN, 80, 40), (6000, MOUTH_STOP, 0, 0)], dtype=KEYFRAME)
+        stream = MagicMock()
+
+        with patch.object(audio_playback, "move_mouth") as move_mouth, \
+                patch.object(audio_playback, "stop_mouth") as stop_mouth:
+            manager._play_clip(CachedClip("clip.wav", samples, keyframes), stream, 50)
+
+        # 50 ms chunks of 2400 frames at 48 kHz, counted at 24 kHz
+        self.assertEqual(stream.write.call_count, 4)
+        self.assertEqual(manager.frames_written, 1000 + 4800)
+        move_mouth.assert_called_once_with(80, 0.04, brake=False, at_sample=1000 + 1200)
+        self.assertEqual(stop_mouth.call_args_list[0].args, (1000 + 3000,))
+        self.assertEqual(stop_mouth.call_args_list[-1].args, (1000 + 4800,))
+
+    def test_volume_is_applied_on_playback(self):
+        manager = AudioPlaybackManager()
+        samples = np.full((2400, 2), 20000, dtype=np.int16)
+        keyframes = np.zeros(0, dtype=KEYFRAME)
+        stream = MagicMock()
+
+        with patch.object(audio_playback, "PLAYBACK_VOLUME", 2), \
+                patch.object(audio_playback, "stop_mouth"):
+            manager._play_clip(CachedClip("clip.wav", samples, keyframes), stream, 50)
+
+        written = stream.write.call_args.args[0]
+        self.assertEqual(written.dtype, np.int16)
+        self.assertTrue(np.all(written == 32767))
+        self.assertTrue(np.all(samples == 20000))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,127 @@
+import sys
+import unittest
+from unittest.mock import MagicMock, patch
+
+import numpy as np
+
+# Mock hardware-related modules before core is imported
+sys.modules['sounddevice'] = MagicMock()
+sys.modules['lgpio'] = MagicMock()
+sys.modules['gpiozero'] = MagicMock()
+
+from core import lipsync, movements
+from core.lipsync import HEAD_IN, HEAD_OUT, MOUTH_HOLD, MOUTH_OPEN, MOUTH_STOP, LipSync
+from native_support import requires_native
+
+
+def level(rms, samples=960):
+    """A square wave whose RMS and peak are both rms."""
+    chunk = np.full(samples, rms, dtype=np.int16)
+    chunk[1::2] = -rms
+    return chunk
+
+
+def python_mapping(rms, chunk_ms=40):
+    """Speed and duration as flap_from_pcm_chunk computes them without the engine."""
+    normalized = rms / 32768.0
+    speed = int(np.clip(np.interp(normalized, [0.005, 0.15], [25, 100]), 25, 100))
+    duration = np.clip(np.interp(normalized, [0.005, 0.15], [15, 70]), 15, chunk_ms)
+    return speed, duration
+
+
+class TestLipSyncFallback(unittest.TestCase):
+    def test_without_library_returns_none(self):
+        with patch.object(lipsync, "_load_library", return_value=None):
+            engine = LipSync()
+        self.assertFalse(engine.available)
+        self.assertIsNone(engine.process(level(3000)))
+
+
+@requires_native(lipsync)
+class TestLipSyncNative(unittest.TestCase):
+    def setUp(self):
+        self.now = 1000.0
+        patcher = patch.object(lipsync.time, "monotonic", side_effect=lambda: self.now)
+        patcher.start()
+        self.addCleanup(patcher.stop)
+        self.engine = LipSync()
+
+    def step(self, rms, seconds=0.04):
+        command = self.engine.process(level(rms))
+        result = (command.mouth, command.mouth_speed, command.mouth_ms, command.head, command.tail)
+        self.now += seconds
+        return result
+
+    def test_mapping_matches_python(self):
+        for rms in (1600, 2500, 4000, 8000):
+            engine = LipSync()
+            command = engine.process(level(rms))
+            speed, duration = python_mapping(rms)
+            self.assertEqual(command.mouth, MOUTH_OPEN)
+            self.assertLessEqual(abs(command.mouth_speed - speed), 1)
+            self.assertLessEqual(abs(command.mouth_ms - duration), 1)
+            self.assertEqual(command.rms, rms)
+            self.assertEqual(command.peak, rms)
+
+    def test_quiet_stops_and_gap_holds(self):
+        self.assertEqual(self.step(3000, seconds=0.05)[0], MOUTH_OPEN)
+        # 50 ms later: still inside the 100 ms flap gap
+        self.assertEqual(self.step(3000, seconds=0.06)[0], MOUTH_HOLD)
+        self.assertEqual(self.step(3000)[0], MOUTH_OPEN)
+        self.assertEqual(self.step(100)[0], MOUTH_STOP)
+        # Between half the threshold and the threshold nothing changes
+        self.assertEqual(self.step(1000)[0], MOUTH_HOLD)
+
+    def test_head_follows_speech(self):
+        self.assertEqual(self.step(3000)[3], HEAD_OUT)
+        self.assertNotEqual(self.step(3000, seconds=1.0)[3], HEAD_OUT)
+        heads = [self.step(0, seconds=0.5)[3] for _ in range(4)]
+        self.assertIn(HEAD_IN, heads)
+
+    def test_levels_match_process(self):
+        measured = LipSync()
+        for rms in (3000, 3000, 100, 5000, 0):
+            expected = self.engine.process(level(rms))
+            expected = (expected.mouth, expected.mouth_speed, expected.mouth_ms, expected.head)
+            command = measured.levels(rms, rms)
+            self.assertEqual(
+                (command.mouth, command.mouth_speed, command.mouth_ms, command.head), expected
+            )
+            self.now += 0.04
+
+    def test_onset_flags_tail(self):
+        for _ in range(20):
+            self.step(1000)
+        self.assertEqual(self.step(4000)[4], 1)
+        self.assertEqual(self.step(4000)[4], 0)
+
+
+@requires_native(lipsync)
+class TestMouthSyncEngines(unittest.TestCase):
+    def setUp(self):
+        patcher = patch.dict(movements._lipsync_engines, clear=True)
+        patcher.start()
+        self.addCleanup(patcher.stop)
+        self.moves = []
+        for name in ("move_mouth", "stop_mouth"):
+            patcher = patch.object(
+                movements, name, side_effect=lambda *a, _name=name, **k: self.moves.append(_name)
+            )
+            patcher.start()
+            self.addCleanup(patcher.stop)
+
+    def test_each_threshold_gets_its_own_engine(self):
+        movements.flap_from_pcm_chunk(level(3000), at_sample=0)
+        # 3000 is above the default threshold but below this caller's
+        movements.flap_from_pcm_chunk(level(3000), threshold=5000, at_sample=24000)
+        self.assertEqual(len(movements._lipsync_engines), 2)
+        self.assertEqual(self.moves, ["move_mouth"])
+
+    def test_same_arguments_share_an_engine(self):
+        movements.flap_from_pcm_chunk(level(3000), at_sample=0)
+        movements.flap_from_levels(3000, 3000, at_sample=24000)
+        self.assertEqual(len(movements._lipsync_engines), 1)
+
+
+if __name__ == "__main__":
+    unittest.main()
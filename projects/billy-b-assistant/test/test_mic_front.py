@@ -0,0 +1,99 @@
+import base64
+import json
+import sys
+import unittest
+from unittest.mock import MagicMock, patch
+
+import numpy as np
+
+# Mock hardware-related modules before core is imported
+sys.modules['sounddevice'] = MagicMock()
+sys.modules['lgpio'] = MagicMock()
+sys.modules['gpiozero'] = MagicMock()
+
+from core import mic_front
+from core.mic_front import MicFrontEnd, MicPacket
+from core.session import BillySession
+from native_support import requires_native
+
+
+def tone(frames, rate, amplitude, offset=0, channels=1):
+    t = np.arange(frames) / rate
+    mono = offset + amplitude * np.sin(2 * np.pi * 300 * t)
+    return np.repeat(mono.astype(np.int16)[:, None], channels, axis=1)
+
+
+def decode(packet):
+    message = json.loads(packet.message)
+    return message["type"], np.frombuffer(base64.b64decode(message["audio"]), dtype=np.int16)
+
+
+@requires_native(mic_front)
+class TestMicFrontEnd(unittest.TestCase):
+    def test_message_matches_send_mic_audio(self):
+        front = MicFrontEnd(24000)
+        packet = front.process(tone(1200, 24000, 4000))
+        kind, pcm = decode(packet)
+        self.assertEqual(kind, "input_audio_buffer.append")
+        self.assertEqual(len(pcm), 1200)
+        expected = json.dumps({
+            "type": "input_audio_buffer.append",
+            "audio": base64.b64encode(pcm.tobytes()).decode("utf-8"),
+        })
+        self.assertEqual(packet.message, expected)
+
+    def test_downsamples_to_24k(self):
+        front = MicFrontEnd(48000, channels=2)
+        total = sum(len(decode(front.process(tone(2400, 48000, 4000, channels=2)))[1]) for _ in range(10))
+        # Streaming: the output lags by the filter delay but keeps the ratio
+        self.assertAlmostEqual(total, 12000, delta=32)
+
+    def test_removes_dc_before_measuring(self):
+        front = MicFrontEnd(48000)
+        block = tone(2400, 48000, 1000, offset=8000)
+        for _ in range(20):
+            packet = front.process(block)
+        self.assertAlmostEqual(packet.rms, 1000 / np.sqrt(2), delta=50)
+        self.assertLess(abs(decode(packet)[1].mean()), 200)
+
+    def test_voice_holds_through_hangover(self):
+        front = MicFrontEnd(48000, threshold=2000, hangover_ms=100)
+        self.assertTrue(front.process(tone(2400, 48000, 8000)).voice)
+        quiet = np.zeros((2400, 1), dtype=np.int16)
+        held = [front.process(quiet).voice for _ in range(4)]
+        # 100 ms is two 50 ms blocks
+        self.assertEqual(held, [True, True, False, False])
+
+
+class TestMicCallback(unittest.TestCase):
+    def setUp(self):
+        self.session = BillySession.__new__(BillySession)
+        self.session.allow_mic_input = True
+        self.session.session_active = MagicMock()
+        self.session.session_active.is_set.return_value = True
+        self.session.last_activity = [0.0]
+        self.session.user_spoke_after_assistant = False
+        self.session.ws_client = MagicMock()
+        self.session.loop = MagicMock()
+
+    @patch("core.session.audio")
+    def test_native_packet_is_sent_as_is(self, mock_audio):
+        self.session.mic_front = MagicMock()
+        self.session.mic_front.process.return_value = MicPacket(2500.0, True, "{}")
+        self.session.mic_callback(np.zeros((10, 1), dtype=np.int16))
+        mock_audio.send_mic_message.assert_called_once_with(self.session.ws_client.ws, "{}", self.session.loop)
+        mock_audio.send_mic_audio.assert_not_called()
+        self.assertTrue(self.session.user_spoke_after_assistant)
+        self.assertEqual(self.session.last_rms, 2500.0)
+
+    @patch("core.session.audio")
+    def test_numpy_path_without_front_end(self, mock_audio):
+        self.session.mic_front = None
+        self.session.mic_callback(np.zeros((10, 1), dtype=np.int16))
+        mock_audio.send_mic_audio.assert_called_once()
+        mock_audio.send_mic_message.assert_not_called()
+        self.assertFalse(self.session.user_spoke_after_assistant)
+
+
+if __name__ == "__main__":
+    unittest.main()
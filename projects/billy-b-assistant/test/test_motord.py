@@ -0,0 +1,156 @@
+import os
+import sys
+import tempfile
+import time
+import unittest
+from unittest.mock import MagicMock, patch
+
+# Mock hardware-related modules before core is imported
+sys.modules['sounddevice'] = MagicMock()
+sys.modules['lgpio'] = MagicMock()
+sys.modules['gpiozero'] = MagicMock()
+
+from core import motord
+from core.motord import HEAD, MOUTH, TAIL, MotorDaemon, SampleClock
+from native_support import requires_native
+
+
+@requires_native(motord)
+class TestMotorDaemonTrace(unittest.TestCase):
+    def setUp(self):
+        fd, self.path = tempfile.mkstemp(suffix=".trace")
+        os.close(fd)
+        self.addCleanup(os.remove, self.path)
+
+    def run_daemon(self, commands, seconds, idle_timeout=60, tail_on_head=False):
+        daemon = MotorDaemon.open_trace(
+            self.path, idle_timeout=idle_timeout, tail_on_head=tail_on_head
+        )
+        self.assertIsNotNone(daemon)
+        start = time.monotonic()
+        for offset, kwargs in commands:
+            self.assertTrue(daemon.push(at=start + offset, **kwargs))
+        time.sleep(seconds)
+        trips = daemon.watchdog_trips
+        daemon.close()
+        with open(self.path) as f:
+            rows = [line.split() for line in f]
+        return [(int(us) / 1e6, motor, int(speed)) for us, motor, speed in rows], trips
+
+    def test_timestamped_commands_run_in_time_order(self):
+        trace, _ = self.run_daemon(
+            [
+                (0.06, dict(motor=MOUTH, speed=0)),
+                (0.03, dict(motor=MOUTH, speed=70)),
+                (0.0, dict(motor=TAIL, speed=-50)),
+            ],
+            0.1,
+        )
+        changes = [(motor, speed) for _, motor, speed in trace]
+        self.assertEqual(changes[:3], [("tail", -50), ("mouth", 70), ("mouth", 0)])
+        mouth_open = trace[1][0] - trace[0][0]
+        self.assertAlmostEqual(mouth_open, 0.03, delta=0.01)
+
+    def test_duration_then_speed(self):
+        trace, _ = self.run_daemon(
+            [(0.0, dict(motor=HEAD, speed=80, duration=0.05, then_speed=100))], 0.1
+        )
+        self.assertEqual([(m, s) for _, m, s in trace[:2]], [("head", 80), ("head", 100)])
+        self.assertAlmostEqual(trace[1][0] - trace[0][0], 0.05, delta=0.01)
+
+    def test_cancel_drops_pending_commands(self):
+        trace, _ = self.run_daemon(
+            [
+                (0.05, dict(motor=HEAD, speed=100)),
+                (0.0, dict(motor=HEAD, speed=0, cancel=True)),
+            ],
+            0.1,
+        )
+        self.assertNotIn(("head", 100), [(m, s) for _, m, s in trace])
+
+    def test_watchdog_brakes_idle_motor(self):
+        trace, trips = self.run_daemon(
+            [(0.0, dict(motor=HEAD, speed=100))], 0.15, idle_timeout=0.05
+        )
+        self.assertEqual([(m, s) for _, m, s in trace[:2]], [("head", 100), ("head", 0)])
+        self.assertEqual(trips, 1)
+
+    def test_two_motor_tail_shares_head_state(self):
+        trace, _ = self.run_daemon(
+            [
+                (0.0, dict(motor=HEAD, speed=100)),
+                (0.02, dict(motor=TAIL, speed=50, duration=0.02, then_speed=0)),
+                (0.06, dict(motor=HEAD, speed=100)),
+            ],
+            0.1,
+            tail_on_head=True,
+        )
+        self.assertEqual(
+            [(m, s) for _, m, s in trace[:4]],
+            [("head", 100), ("head", -50), ("head", 0), ("head", 100)],
+        )
+
+
+@requires_native(motord)
+class TestSampleClock(unittest.TestCase):
+    def setUp(self):
+        fd, self.path = tempfile.mkstemp(suffix=".trace")
+        os.close(fd)
+        self.addCleanup(os.remove, self.path)
+        self.daemon = MotorDaemon.open_trace(self.path)
+        self.clock = SampleClock.manual(24000)
+        self.daemon.set_clock(self.clock)
+
+    def trace(self):
+        """Motor changes, less the brakes applied on close."""
+        self.daemon.close()
+        with open(self.path) as f:
+            rows = [line.split() for line in f]
+        return [(motor, int(speed)) for _, motor, speed in rows if int(speed)]
+
+    def test_commands_wait_for_their_sample(self):
+        self.daemon.push(MOUTH, 60, at_sample=24000)
+        self.daemon.push(TAIL, 80, at_sample=12000)
+        self.clock.set(11999)
+        time.sleep(0.01)
+        self.clock.set(12000)
+        time.sleep(0.01)
+        self.assertEqual(self.trace(), [("tail", 80)])
+
+    def test_latency_starts_motor_early(self):
+        self.daemon.set_latency(HEAD, 0.05)  # 1200 frames at 24 kHz
+        self.daemon.push(HEAD, 100, at_sample=24000)
+        self.daemon.push(MOUTH, 50, at_sample=24000)
+        self.clock.set(22800)
+        time.sleep(0.01)
+        self.assertEqual(self.trace(), [("head", 100)])
+
+    def test_without_clock_commands_apply_at_once(self):
+        self.daemon.set_clock(None)
+        self.daemon.push(MOUTH, 40, at_sample=10**9)
+        time.sleep(0.01)
+        self.assertEqual(self.trace(), [("mouth", 40)])
+
+    def test_stream_clock_follows_writes(self):
+        clock = SampleClock.stream(24000)
+        self.assertEqual(clock.position, -1)
+        # 9600 frames written, 4800 of them still in the device
+        clock.anchor(9600, 4800)
+        start = clock.position
+        self.assertGreaterEqual(start, 4800)
+        time.sleep(0.05)
+        self.assertAlmostEqual(clock.position - start, 1200, delta=600)
+        # An underrun holds it at the last frame written
+        time.sleep(0.25)
+        self.assertEqual(clock.position, 9600)
+        self.daemon.close()
+
+
+class TestMotorDaemonMissing(unittest.TestCase):
+    def test_open_without_library(self):
+        with patch.object(motord, "_load_library", return_value=None):
+            self.assertIsNone(MotorDaemon.open_trace("-"))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,108 @@
+import os
+import sys
+import unittest
+from unittest.mock import MagicMock
+
+import numpy as np
+
+# Mock hardware-related modules before core is imported
+sys.modules['sounddevice'] = MagicMock()
+sys.modules['lgpio'] = MagicMock()
+sys.modules['gpiozero'] = MagicMock()
+
+from core import pcm_ring
+from core.pcm_ring import CANCEL, END, PcmRing
+from native_support import requires_native
+
+
+@requires_native(pcm_ring)
+class TestPcmRing(unittest.TestCase):
+    def setUp(self):
+        self.name = f"/billy-pcm-test-{os.getpid()}"
+        self.ring = PcmRing.create(self.name, 2, 1024, 24000)
+        self.assertIsNotNone(self.ring)
+        self.addCleanup(self.ring.close)
+
+    def play(self, frames):
+        played = self.ring.peek(0, frames).copy()
+        self.ring.release(len(played))
+        return played
+
+    def test_write_peek_release(self):
+        main = np.arange(1500, dtype=np.int16)
+        vocals = -main
+        # A quarter of the ring is kept as history for analysis readers
+        self.assertEqual(self.ring.write(main, vocals), 768)
+        # The producer cannot overwrite frames the speaker has not played
+        self.assertEqual(self.ring.write(main[768:], vocals[768:]), 0)
+
+        np.testing.assert_array_equal(self.play(600), main[:600])
+        self.assertEqual(self.ring.write(main[768:], vocals[768:]), 600)
+        np.testing.assert_array_equal(self.play(400), main[600:1000])
+        self.assertEqual(self.ring.write(main[1368:], vocals[1368:]), 132)
+
+        # Frames past the wrap come back in two contiguous pieces
+        rest = np.concatenate([self.play(1024), self.play(1024)])
+        np.testing.assert_array_equal(rest, main[1000:])
+        self.assertEqual(self.ring.played, 1500)
+
+    def test_reader_trails_played(self):
+        reader = self.ring.attach()
+        main = np.arange(800, dtype=np.int16)
+        self.ring.write(main, main // 2)
+
+        position, planes = reader.read(256)
+        self.assertEqual(len(planes[0]), 0)
+
+        self.play(300)
+        position, planes = reader.read(256)
+        self.assertEqual(position, 0)
+        np.testing.assert_array_equal(planes[1], main[:256] // 2)
+        self.assertTrue(reader.intact(position))
+        reader.consume(256)
+
+        position, planes = reader.read(256)
+        self.assertEqual((position, len(planes[0])), (256, 44))
+        reader.detach()
+
+    def test_stalled_reader_is_lapped(self):
+        reader = self.ring.attach()
+        main = np.arange(3000, dtype=np.int16)
+        for start in range(0, 3000, 500):
+            self.ring.write(main[start:start + 500], main[start:start + 500])
+            self.play(500)
+            self.play(500)  # The rest, past the wrap
+
+        # Only the newest capacity frames are still in the ring
+        position, planes = reader.read(4096)
+        self.assertEqual(position, 3000 - 1024)
+        self.assertEqual(reader.lapped, 3000 - 1024)
+        np.testing.assert_array_equal(planes[0], main[position:position + len(planes[0])])
+        self.assertTrue(reader.intact(position))
+
+        self.ring.write(main[:600], main[:600])
+        self.assertFalse(reader.intact(position))
+        reader.detach()
+
+    def test_open_by_name_shares_frames(self):
+        other = PcmRing.open(self.name)
+        self.assertIsNotNone(other)
+        self.addCleanup(other.close)
+        self.assertEqual((other.channels, other.capacity, other.sample_rate), (2, 1024, 24000))
+
+        main = np.arange(100, dtype=np.int16)
+        self.ring.write(main, main)
+        np.testing.assert_array_equal(other.peek(1, 100), main)
+        other.release(100)
+        self.assertEqual(self.ring.played, 100)
+
+    def test_flags(self):
+        self.assertEqual(self.ring.flags, 0)
+        self.ring.finish()
+        self.assertEqual(self.ring.flags, END)
+        self.ring.cancel()
+        self.assertEqual(self.ring.flags, END | CANCEL)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,73 @@
+import sys
+import unittest
+from unittest.mock import MagicMock, patch
+
+import numpy as np
+
+# Mock hardware-related modules before core is imported
+sys.modules['sounddevice'] = MagicMock()
+sys.modules['lgpio'] = MagicMock()
+sys.modules['gpiozero'] = MagicMock()
+
+from core import resampler
+from core.resampler import StreamResampler
+from native_support import requires_native
+
+
+def tone(rate, seconds=0.5, freq=440.0, amplitude=8000):
+    t = np.arange(int(rate * seconds)) / rate
+    return (amplitude * np.sin(2 * np.pi * freq * t)).astype(np.int16)
+
+
+def in_chunks(stream, samples, chunk):
+    return np.concatenate([
+        stream.process(samples[i:i + chunk]) for i in range(0, len(samples), chunk)
+    ])
+
+
+class TestStreamResamplerFallback(unittest.TestCase):
+    def setUp(self):
+        patcher = patch.object(resampler, "_load_library", return_value=None)
+        patcher.start()
+        self.addCleanup(patcher.stop)
+
+    def test_same_rate_passes_through(self):
+        samples = tone(24000)
+        out = StreamResampler(24000, 24000).process(samples)
+        np.testing.assert_array_equal(out, samples)
+
+    def test_scipy_chunk_lengths(self):
+        stream = StreamResampler(24000, 48000)
+        self.assertEqual(len(stream.process(tone(24000)[:960])), 1920)
+        stream = StreamResampler(48000, 24000)
+        self.assertEqual(len(stream.process(tone(48000)[:1920])), 960)
+
+
+@requires_native(resampler)
+class TestStreamResamplerNative(unittest.TestCase):
+    def test_chunks_match_one_pass(self):
+        samples = tone(24000)
+        whole = StreamResampler(24000, 48000).process(samples)
+        chunked = in_chunks(StreamResampler(24000, 48000), samples, 960)
+        np.testing.assert_array_equal(chunked, whole)
+        self.assertEqual(len(whole), 2 * len(samples))
+
+    def test_tone_survives(self):
+        for input_rate, output_rate in ((24000, 48000), (48000, 24000), (44100, 24000)):
+            out = in_chunks(StreamResampler(input_rate, output_rate), tone(input_rate), 1000)
+            expected = tone(output_rate)
+            self.assertLessEqual(abs(len(out) - len(expected)), 1)
+            # Past the filter's start-up, the level matches the input tone
+            rms = np.sqrt(np.mean(out[200:].astype(np.float64) ** 2))
+            self.assertAlmostEqual(rms, 8000 / np.sqrt(2), delta=60)
+
+    def test_reset_clears_history(self):
+        stream = StreamResampler(48000, 24000)
+        stream.process(tone(48000))
+        stream.reset()
+        silence = stream.process(np.zeros(480, dtype=np.int16))
+        self.assertFalse(silence.any())
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,167 @@
+import os
+import sys
+import tempfile
+import time
+import unittest
+import wave
+from unittest.mock import MagicMock, patch
+
+import numpy as np
+
+# Mock hardware-related modules before core is imported
+sys.modules['sounddevice'] = MagicMock()
+sys.modules['lgpio'] = MagicMock()
+sys.modules['gpiozero'] = MagicMock()
+
+import core.stem_index
+from core import audio_playback
+from core.audio_playback import SongMotion
+from core.stem_index import (
+    DRUM_ONSET,
+    INDEX_FILENAME,
+    LEVELS,
+    _HEADER,
+    decode_stem_index,
+    load_stem_index,
+    stem_index,
+)
+from native_support import requires_native
+
+
+def write_wav(path, samples, rate=48000):
+    """Write an int16 array of shape (frames, channels)."""
+    with wave.open(path, "wb") as wf:
+        wf.setnchannels(samples.shape[1])
+        wf.setsampwidth(2)
+        wf.setframerate(rate)
+        wf.writeframes(samples.astype(np.int16).tobytes())
+
+
+def encode(chunk_ms, gain, levels):
+    header = np.zeros(1, dtype=_HEADER)
+    header[0] = (b"BSIX", 1, chunk_ms, len(levels), gain)
+    return header.tobytes() + levels.tobytes()
+
+
+class TestStemIndexFormat(unittest.TestCase):
+    def setUp(self):
+        self.dir = tempfile.TemporaryDirectory()
+        self.addCleanup(self.dir.cleanup)
+        self.levels = np.zeros(3, dtype=LEVELS)
+        self.levels["vocal_rms"] = [0, 2000, 100]
+        self.levels["drum_rms"] = [0, 3000, 0]
+        self.levels["flags"] = [0, DRUM_ONSET, 0]
+
+    def write_index(self, chunk_ms=40, gain=1.5):
+        with open(os.path.join(self.dir.name, INDEX_FILENAME), "wb") as f:
+            f.write(encode(chunk_ms, gain, self.levels))
+
+    def test_decode(self):
+        index = decode_stem_index(encode(40, 1.5, self.levels))
+        self.assertEqual(len(index), 3)
+        self.assertEqual(index.at(0.04)["vocal_rms"], 2000)
+        self.assertEqual(index.at(0.08)["drum_rms"], 0)
+        self.assertIsNone(index.at(0.12))
+        np.testing.assert_allclose(index.onsets(), [0.04])
+
+    def test_rejects_malformed(self):
+        with self.assertRaises(ValueError):
+            decode_stem_index(b"BSIX")
+        with self.assertRaises(ValueError):
+            decode_stem_index(b"XXXX" + encode(40, 1.0, self.levels)[4:])
+        with self.assertRaises(ValueError):
+            decode_stem_index(encode(40, 1.0, self.levels)[:-1])
+
+    def test_load_matches_settings(self):
+        self.write_index()
+        self.assertIsNotNone(load_stem_index(self.dir.name, 40, 1.5))
+        self.assertIsNone(load_stem_index(self.dir.name, 20, 1.5))
+        self.assertIsNone(load_stem_index(self.dir.name, 40, 1.0))
+
+    def test_stale_after_stem_changes(self):
+        self.write_index()
+        stem = os.path.join(self.dir.name, "drums.wav")
+        open(stem, "wb").close()
+        later = time.time() + 10
+        os.utime(stem, (later, later))
+        self.assertIsNone(load_stem_index(self.dir.name, 40, 1.5))
+
+
+class TestSongMotionFromIndex(unittest.TestCase):
+    def run_song(self, flags, compensate_tail_beats=0.0):
+        levels = np.zeros(len(flags), dtype=LEVELS)
+        levels["drum_rms"] = 3000
+        levels["flags"] = flags
+        manager = MagicMock(choreography=None, beat_length=0.08)
+        manager.stem_index = decode_stem_index(encode(40, 1.0, levels))
+        manager.compensate_tail_beats = compensate_tail_beats
+        motion = SongMotion(manager, 40)
+        with patch.object(audio_playback, "flap_from_levels"), \
+                patch.object(audio_playback, "move_tail_async") as move_tail:
+            for chunk in range(len(flags)):
+                motion.chunk(chunk * 0.04, None, 0, at_sample=chunk * 960)
+        return [call.kwargs["at_sample"] for call in move_tail.call_args_list]
+
+    def test_tail_follows_onsets(self):
+        self.assertEqual(self.run_song([0, DRUM_ONSET, 0, 0, DRUM_ONSET]), [960, 3840])
+
+    def test_without_onsets_the_tail_keeps_the_beat(self):
+        self.assertEqual(self.run_song([0, 0, 0, 0]), [0, 1920])
+
+    def test_compensation_moves_the_tail_early(self):
+        # Half a beat is one 40 ms chunk ahead
+        self.assertEqual(
+            self.run_song([0, DRUM_ONSET, 0, 0, DRUM_ONSET], 0.5), [0, 2880]
+        )
+
+
+@requires_native(core.stem_index)
+class TestStemIndexNative(unittest.TestCase):
+    def setUp(self):
+        self.dir = tempfile.TemporaryDirectory()
+        self.addCleanup(self.dir.cleanup)
+        rng = np.random.default_rng(1)
+        # 1 s of vocals at 48 kHz stereo; 0.5 s of drums with a hit at 0.2 s
+        self.vocals = rng.integers(-3000, 3000, size=(48000, 2))
+        self.drums = np.zeros((24000, 2), dtype=np.int64)
+        self.drums[9600:10560] = 6000
+        self.drums[9600:10560:2] = -6000
+        write_wav(os.path.join(self.dir.name, "vocals.wav"), self.vocals)
+        write_wav(os.path.join(self.dir.name, "drums.wav"), self.drums)
+
+    def expected(self, samples, chunk, gain):
+        mono = samples.sum(axis=1) // 2
+        scaled = np.clip((mono * int(gain * 256)) >> 8, -32768, 32767)
+        rms = [np.sqrt(np.mean(scaled[i:i + chunk] ** 2.0)) for i in range(0, len(scaled), chunk)]
+        return np.round(rms)
+
+    def test_build_and_reuse(self):
+        index = stem_index(self.dir.name, 40, 2.0)
+        self.assertIsNotNone(index)
+        self.assertEqual(len(index), 25)
+
+        vocal_rms = index.levels["vocal_rms"].astype(float)
+        np.testing.assert_allclose(vocal_rms, self.expected(self.vocals, 1920, 2.0), atol=1)
+        drum_rms = index.levels["drum_rms"][:13].astype(float)
+        np.testing.assert_allclose(drum_rms, self.expected(self.drums, 1920, 2.0), atol=1)
+        # Past the end of the shorter stem it reads as silence
+        self.assertTrue(np.all(index.levels["drum_rms"][13:] == 0))
+        np.testing.assert_allclose(index.onsets(), [0.2])
+
+        path = os.path.join(self.dir.name, INDEX_FILENAME)
+        built = os.path.getmtime(path)
+        self.assertEqual(len(stem_index(self.dir.name, 40, 2.0)), 25)
+        self.assertEqual(os.path.getmtime(path), built)
+
+    def test_rebuilds_for_new_gain(self):
+        loud = stem_index(self.dir.name, 40, 2.0)
+        quiet = stem_index(self.dir.name, 40, 0.5)
+        self.assertLess(quiet.levels["vocal_rms"][0], loud.levels["vocal_rms"][0])
+
+    def test_missing_stem(self):
+        os.remove(os.path.join(self.dir.name, "drums.wav"))
+        self.assertIsNone(stem_index(self.dir.name, 40, 1.0))
+
+
+if __name__ == "__main__":
+    unittest.main()
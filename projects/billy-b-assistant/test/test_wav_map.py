@@ -0,0 +1,87 @@
+import os
+import sys
+import tempfile
+import unittest
+import wave
+from unittest.mock import MagicMock, patch
+
+import numpy as np
+
+# Mock hardware-related modules before core is imported
+sys.modules['sounddevice'] = MagicMock()
+sys.modules['lgpio'] = MagicMock()
+sys.modules['gpiozero'] = MagicMock()
+
+from core import wav_map
+from core.wav_map import MappedWav, WaveFile, open_wav
+from native_support import requires_native
+
+
+class WavFileTest(unittest.TestCase):
+    def setUp(self):
+        self.dir = tempfile.TemporaryDirectory()
+        self.addCleanup(self.dir.cleanup)
+        self.samples = np.arange(-5000, 5000, dtype=np.int16).reshape(-1, 2)
+        self.path = os.path.join(self.dir.name, "clip.wav")
+        with wave.open(self.path, "wb") as wf:
+            wf.setnchannels(2)
+            wf.setsampwidth(2)
+            wf.setframerate(24000)
+            wf.writeframes(self.samples.tobytes())
+
+    def check_chunks(self, wav):
+        self.assertEqual((wav.sample_rate, wav.channels, wav.frames), (24000, 2, 5000))
+        chunks = list(wav.chunks(960))
+        self.assertEqual([len(c) for c in chunks], [960] * 5 + [200])
+        np.testing.assert_array_equal(np.concatenate(chunks), self.samples)
+
+
+class TestWaveFallback(WavFileTest):
+    def test_chunks(self):
+        with patch.object(wav_map, "_load_library", return_value=None):
+            with open_wav(self.path) as wav:
+                self.assertIsInstance(wav, WaveFile)
+                self.check_chunks(wav)
+
+
+@requires_native(wav_map)
+class TestMappedWav(WavFileTest):
+    def test_chunks_are_read_only_views(self):
+        with open_wav(self.path) as wav:
+            self.assertIsInstance(wav, MappedWav)
+            self.check_chunks(wav)
+            chunk = next(wav.chunks(960))
+            self.assertFalse(chunk.flags.writeable)
+            self.assertFalse(chunk.flags.owndata)
+
+    def test_views_outlive_the_file_object(self):
+        chunk = list(MappedWav.open(self.path).chunks(960))[-1]
+        np.testing.assert_array_equal(chunk, self.samples[4800:])
+
+    def test_rejects_non_pcm16(self):
+        path = os.path.join(self.dir.name, "8bit.wav")
+        with wave.open(path, "wb") as wf:
+            wf.setnchannels(1)
+            wf.setsampwidth(1)
+            wf.setframerate(8000)
+            wf.writeframes(b"\x80" * 100)
+        self.assertIsNone(MappedWav.open(path))
+
+    def test_rejects_empty_file(self):
+        path = os.path.join(self.dir.name, "empty.wav")
+        open(path, "wb").close()
+        log = os.path.join(self.dir.name, "stderr.log")
+        saved = os.dup(2)
+        try:
+            with open(log, "w") as f:
+                os.dup2(f.fileno(), 2)
+                self.assertIsNone(MappedWav.open(path))
+        finally:
+            os.dup2(saved, 2)
+            os.close(saved)
+        with open(log) as f:
+            self.assertIn("empty file", f.read())
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,57 @@
+/*
+  Drives a fish mouth from a sound sensor on A0 through LipSync.
+
+  Levels from analogRead() are pushed every loop and closed into a frame
+  every 20 ms. The tuning below suits an envelope sensor that reads about
+  10 when quiet; raise threshold for a noisier room.
+*/
+
+#include <LipSync.h>
+#include <MX1508.h>
+
+const uint8_t SOUND_PIN = A0;
+const uint16_t FRAME_MS = 20;
+
+MX1508 mouth(3, 5);
+LipSync lipSync;
+uint32_t frameStart = 0;
+uint32_t mouthUntil = 0;
+
+void setup() {
+  LipSyncConfig config;
+  config.threshold = 12;
+  config.rmsLow = 12;
+  config.rmsHigh = 300;
+  config.speedMin = 120;
+  config.speedMax = 255;
+  config.flapMinMs = 60;
+  config.flapMaxMs = 200;
+  lipSync = LipSync(config);
+  Serial.begin(115200);
+}
+
+void loop() {
+  uint32_t now = millis();
+  lipSync.push(analogRead(SOUND_PIN));
+
+  if (now - frameStart >= FRAME_MS) {
+    // The toy's mouth needs longer than one frame to open
+    LipSyncCommand command = lipSync.update(now, 250);
+    frameStart = now;
+
+    if (command.mouth == LIPSYNC_MOUTH_OPEN) {
+      mouth.setSpeed(command.mouthSpeed);
+      mouth.forward();
+      mouthUntil = now + command.mouthMs;
+    } else if (command.mouth == LIPSYNC_MOUTH_STOP) {
+      mouth.halt();
+    }
+    if (command.tail) {
+      Serial.println(F("Onset"));
+    }
+  }
+
+  if ((int32_t)(now - mouthUntil) >= 0) {
+    mouth.halt();
+  }
+}
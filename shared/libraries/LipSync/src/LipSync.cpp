@@ -0,0 +1,157 @@
+/*
+    LipSync - Turns audio frames into mouth, head and tail commands for a
+    singing fish. See LipSync.h.
+*/
+
+#include "LipSync.h"
+
+static uint32_t elapsed(uint32_t nowMs, uint32_t sinceMs) {
+  return nowMs - sinceMs; // Unsigned, so correct across a wrap
+}
+
+static uint16_t isqrt(uint32_t value) {
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > value) {
+    bit >>= 2;
+  }
+  while (bit) {
+    if (value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+}
+
+LipSync::LipSync(void) { reset(); }
+
+LipSync::LipSync(const LipSyncConfig &config) : _config(config) { reset(); }
+
+void LipSync::push(int16_t sample) {
+  int32_t value = sample;
+  _sumSquares += (uint32_t)(value * value);
+  uint16_t magnitude = value < 0 ? -value : value;
+  if (magnitude > _peak) {
+    _peak = magnitude;
+  }
+  _count++;
+}
+
+void LipSync::push(const int16_t *samples, uint16_t count) {
+  for (uint16_t i = 0; i < count; i++) {
+    push(samples[i]);
+  }
+}
+
+LipSyncCommand LipSync::update(uint32_t nowMs, uint16_t maxFlapMs) {
+  LipSyncCommand command;
+  if (!_count) {
+    return command;
+  }
+  uint16_t rms = isqrt((uint32_t)(_sumSquares / _count));
+  uint16_t peak = _peak;
+  _sumSquares = 0;
+  _count = 0;
+  _peak = 0;
+  return levels(rms, peak, nowMs, maxFlapMs);
+}
+
+LipSyncCommand LipSync::levels(uint16_t rms, uint16_t peak, uint32_t nowMs,
+                               uint16_t maxFlapMs) {
+  LipSyncCommand command;
+  command.rms = rms;
+  command.peak = peak;
+
+  // Onset against the envelope of the frames before this one
+  uint32_t level = (uint32_t)rms << 8;
+  if (_config.onsetRatio && rms > _config.threshold &&
+      (level << 4) > (uint64_t)_envelope * _config.onsetRatio &&
+      (!_onsetSeen || elapsed(nowMs, _lastOnsetMs) >= _config.onsetGapMs)) {
+    command.tail = 1;
+    _lastOnsetMs = nowMs;
+    _onsetSeen = true;
+  }
+  if (level > _envelope) {
+    _envelope += (level - _envelope) >> _config.envelopeShift;
+  } else {
+    _envelope -= (_envelope - level) >> _config.envelopeShift;
+  }
+
+  if (rms > _config.threshold) {
+    _lastVoiceMs = nowMs;
+  }
+
+  if (rms < _config.threshold / 2 &&
+      (!_mouthOpen || elapsed(nowMs, _lastFlapMs) >= _mouthMs)) {
+    command.mouth = LIPSYNC_MOUTH_STOP;
+    _mouthOpen = false;
+  } else if (rms > _config.threshold &&
+             (!_flapped ||
+              elapsed(nowMs, _lastFlapMs) >= _config.minFlapGapMs)) {
+    uint16_t duration = scale(rms, _config.flapMinMs, _config.flapMaxMs);
+    if (duration < _config.flapMinMs) {
+      duration = _config.flapMinMs;
+    }
+    if (duration > maxFlapMs) {
+      duration = maxFlapMs;
+    }
+    command.mouth = LIPSYNC_MOUTH_OPEN;
+    command.mouthSpeed = scale(rms, _config.speedMin, _config.speedMax);
+    command.mouthMs = duration;
+    _lastFlapMs = nowMs;
+    _mouthMs = duration;
+    _flapped = true;
+    _mouthOpen = true;
+    if (!_talking) {
+      command.head = LIPSYNC_HEAD_OUT;
+      _talking = true;
+    }
+  }
+
+  if (_talking && command.head == LIPSYNC_HEAD_HOLD &&
+      elapsed(nowMs, _lastVoiceMs) >= _config.headHoldMs) {
+    command.head = LIPSYNC_HEAD_IN;
+    _talking = false;
+  }
+  return command;
+}
+
+LipSyncCommand LipSync::process(const int16_t *samples, uint16_t count,
+                                uint32_t nowMs, uint16_t maxFlapMs) {
+  push(samples, count);
+  return update(nowMs, maxFlapMs);
+}
+
+uint16_t LipSync::envelope(void) const { return _envelope >> 8; }
+
+void LipSync::reset(void) {
+  _sumSquares = 0;
+  _count = 0;
+  _peak = 0;
+  _envelope = 0;
+  _lastFlapMs = 0;
+  _lastOnsetMs = 0;
+  _lastVoiceMs = 0;
+  _mouthMs = 0;
+  _flapped = false;
+  _mouthOpen = false;
+  _onsetSeen = false;
+  _talking = false;
+}
+
+uint16_t LipSync::scale(uint16_t rms, uint16_t atLow, uint16_t atHigh) const {
+  if (rms <= _config.rmsLow) {
+    return atLow;
+  }
+  if (rms >= _config.rmsHigh) {
+    return atHigh;
+  }
+  // Linear between the two ends; truncates like int() on the Python side
+  int64_t span = (int32_t)atHigh - atLow;
+  return atLow + span * (rms - _config.rmsLow) /
+                     (_config.rmsHigh - _config.rmsLow);
+}
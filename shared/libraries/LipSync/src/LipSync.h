@@ -0,0 +1,112 @@
+/*
+    LipSync - Turns audio frames into mouth, head and tail commands for a
+    singing fish. Shared by the Billy Bass firmware and, through the C
+    interface in LipSyncC.h, by the Raspberry Pi assistant.
+
+    Everything is integer arithmetic on fixed-size state: no heap, no
+    floating point, so the same code runs on an AVR and on the host.
+*/
+
+#ifndef LipSync_h /* Prevent loading library twice */
+#define LipSync_h
+
+#include <stdint.h>
+
+/*
+  Tuning of one LipSync. The defaults are those of the assistant, which
+  feeds 16-bit PCM and drives the mouth in percent; the firmware, which
+  feeds analogRead() levels and drives MX1508 PWM, sets its own.
+*/
+struct LipSyncConfig {
+  uint16_t threshold = 1500;   // RMS above which a frame opens the mouth
+  uint16_t minFlapGapMs = 100; // Shortest time between two mouth openings
+  uint16_t rmsLow = 164;       // RMS of the slowest, shortest flap
+  uint16_t rmsHigh = 4915;     // RMS of the fastest, longest flap
+  uint8_t speedMin = 25;       // Mouth speed at rmsLow, in motor units
+  uint8_t speedMax = 100;      // Mouth speed at rmsHigh
+  uint16_t flapMinMs = 15;     // Mouth drive time at rmsLow
+  uint16_t flapMaxMs = 70;     // Mouth drive time at rmsHigh
+  uint16_t headHoldMs = 1500;  // Quiet time before the head is released
+  uint8_t envelopeShift = 3;   // Envelope moves 1 / 2^shift of the way per frame
+  uint8_t onsetRatio = 32;     // Onset when RMS > envelope * onsetRatio / 16
+  uint16_t onsetGapMs = 250;   // Shortest time between two onsets
+};
+
+/* LipSyncCommand::mouth */
+const uint8_t LIPSYNC_MOUTH_HOLD = 0; // Leave the mouth as it is
+const uint8_t LIPSYNC_MOUTH_OPEN = 1; // Drive it open at mouthSpeed for mouthMs
+const uint8_t LIPSYNC_MOUTH_STOP = 2; // Quiet: stop driving it
+
+/* LipSyncCommand::head */
+const uint8_t LIPSYNC_HEAD_HOLD = 0;
+const uint8_t LIPSYNC_HEAD_OUT = 1; // Speech started
+const uint8_t LIPSYNC_HEAD_IN = 2;  // Quiet for headHoldMs
+
+/* What to do with the motors after one frame */
+struct LipSyncCommand {
+  uint8_t mouth = LIPSYNC_MOUTH_HOLD;
+  uint8_t mouthSpeed = 0;
+  uint16_t mouthMs = 0;
+  uint8_t head = LIPSYNC_HEAD_HOLD;
+  uint8_t tail = 0;  // 1 on a loudness onset: flap the tail once
+  uint16_t rms = 0;  // Level of the frame, for debugging and meters
+  uint16_t peak = 0;
+};
+
+/*
+  Samples are accumulated with push() as they arrive, and update() closes
+  the frame: it reduces the running sum of squares and peak to the frame's
+  RMS, compares it against the threshold and a slow envelope, and returns
+  the motor command. process() does both for a frame already in memory,
+  and levels() judges a frame whose RMS and peak were measured elsewhere
+  (the assistant's precomputed song stem index).
+
+  A frame louder than the threshold opens the mouth, at most once per
+  minFlapGapMs, with speed and drive time scaled between rmsLow and
+  rmsHigh; the drive time is capped at maxFlapMs, usually the frame
+  length so one flap ends before the next frame is judged. A frame quieter
+  than half the threshold stops the mouth once that drive time is over.
+  The first flap pushes the head out, and headHoldMs without a loud frame
+  pulls it back in. A frame that jumps above the envelope by onsetRatio
+  (in sixteenths) flags a tail flap; onsetRatio 0 disables onsets.
+
+  Times are millisecond counters such as millis(); they may wrap.
+*/
+class LipSync {
+public:
+  LipSync(void);
+  explicit LipSync(const LipSyncConfig &config);
+
+  void push(int16_t sample);
+  void push(const int16_t *samples, uint16_t count);
+  LipSyncCommand update(uint32_t nowMs, uint16_t maxFlapMs);
+  LipSyncCommand process(const int16_t *samples, uint16_t count,
+                         uint32_t nowMs, uint16_t maxFlapMs);
+  LipSyncCommand levels(uint16_t rms, uint16_t peak, uint32_t nowMs,
+                        uint16_t maxFlapMs);
+
+  const LipSyncConfig &config(void) const { return _config; }
+  uint16_t envelope(void) const;
+  bool talking(void) const { return _talking; }
+  void reset(void);
+
+private:
+  /* Variables */
+  LipSyncConfig _config;
+  uint64_t _sumSquares;
+  uint16_t _count;
+  uint16_t _peak;
+  uint32_t _envelope; // Q8
+  uint32_t _lastFlapMs;
+  uint32_t _lastOnsetMs;
+  uint32_t _lastVoiceMs;
+  uint16_t _mouthMs;
+  bool _flapped;
+  bool _mouthOpen;
+  bool _onsetSeen;
+  bool _talking;
+  /* Functions */
+  uint16_t scale(uint16_t rms, uint16_t atLow, uint16_t atHigh) const;
+};
+
+#endif
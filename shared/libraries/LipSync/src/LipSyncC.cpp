@@ -0,0 +1,60 @@
+/*
+    C interface to LipSync, for use from other languages.
+*/
+
+#include "LipSyncC.h"
+#include "LipSync.h"
+
+#ifndef ARDUINO // Host shared library only
+
+#include <new>
+
+struct lipsync {
+  LipSync engine;
+
+  explicit lipsync(const LipSyncConfig &config) : engine(config) {}
+};
+
+static_assert(sizeof(lipsync_command) == sizeof(LipSyncCommand),
+              "lipsync_command must mirror LipSyncCommand");
+
+static void copy_command(const LipSyncCommand &result,
+                         lipsync_command *command) {
+  command->mouth = result.mouth;
+  command->mouth_speed = result.mouthSpeed;
+  command->mouth_ms = result.mouthMs;
+  command->head = result.head;
+  command->tail = result.tail;
+  command->rms = result.rms;
+  command->peak = result.peak;
+}
+
+extern "C" {
+
+size_t lipsync_size(void) { return sizeof(lipsync); }
+
+lipsync *lipsync_init(void *storage, uint16_t threshold,
+                      uint16_t min_flap_gap_ms) {
+  LipSyncConfig config;
+  config.threshold = threshold;
+  config.minFlapGapMs = min_flap_gap_ms;
+  return new (storage) lipsync(config);
+}
+
+void lipsync_process(lipsync *engine, const int16_t *samples, uint16_t count,
+                     uint32_t now_ms, uint16_t max_flap_ms,
+                     lipsync_command *command) {
+  copy_command(engine->engine.process(samples, count, now_ms, max_flap_ms),
+               command);
+}
+
+void lipsync_levels(lipsync *engine, uint16_t rms, uint16_t peak,
+                    uint32_t now_ms, uint16_t max_flap_ms,
+                    lipsync_command *command) {
+  copy_command(engine->engine.levels(rms, peak, now_ms, max_flap_ms), command);
+}
+
+void lipsync_reset(lipsync *engine) { engine->engine.reset(); }
+}
+
+#endif
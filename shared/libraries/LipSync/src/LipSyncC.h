@@ -0,0 +1,60 @@
+/*
+    C interface to LipSync, for use from other languages.
+*/
+
+#ifndef LipSyncC_h /* Prevent loading library twice */
+#define LipSyncC_h
+
+/*
+  Plain C functions around one LipSync held in storage the caller provides
+  (lipsync_size() bytes, aligned like malloc()), so the engine allocates
+  nothing on either side of the call. Load the shared library with ctypes
+  or cffi; lipsync_command has the layout of LipSyncCommand. Arduino
+  builds compile LipSyncC.cpp to nothing.
+
+  Build on the host, e.g.
+    g++ -std=c++11 -O2 -shared -fPIC -o liblipsync.so \
+        LipSync.cpp LipSyncC.cpp
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct lipsync lipsync;
+
+typedef struct lipsync_command {
+  uint8_t mouth; /* LIPSYNC_MOUTH_HOLD, _OPEN or _STOP */
+  uint8_t mouth_speed;
+  uint16_t mouth_ms;
+  uint8_t head; /* LIPSYNC_HEAD_HOLD, _OUT or _IN */
+  uint8_t tail;
+  uint16_t rms;
+  uint16_t peak;
+} lipsync_command;
+
+size_t lipsync_size(void);
+
+/* Default tuning with the given threshold and flap gap; returns storage */
+lipsync *lipsync_init(void *storage, uint16_t threshold,
+                      uint16_t min_flap_gap_ms);
+
+void lipsync_process(lipsync *engine, const int16_t *samples, uint16_t count,
+                     uint32_t now_ms, uint16_t max_flap_ms,
+                     lipsync_command *command);
+
+/* The same for a frame measured elsewhere, from its RMS and peak */
+void lipsync_levels(lipsync *engine, uint16_t rms, uint16_t peak,
+                    uint32_t now_ms, uint16_t max_flap_ms,
+                    lipsync_command *command);
+
+void lipsync_reset(lipsync *engine);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
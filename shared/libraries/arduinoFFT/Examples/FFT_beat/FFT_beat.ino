@@ -0,0 +1,94 @@
+/*
+
+	Example of the BeatTracker: detects drum onsets in a signal sampled through
+	the ADC, locks onto the tempo and fires a pin slightly ahead of each predicted
+	beat, e.g. to start a motor that needs time to move.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "arduinoFFT.h"
+#include "BeatTracker.h"
+
+/*
+These values can be changed in order to evaluate the functions
+*/
+#define CHANNEL A0
+#define BEAT_PIN LED_BUILTIN
+const uint16_t samples = 128; //This value MUST ALWAYS be a power of 2
+const float samplingFrequency = 4000; //Hz, must be less than 10000 due to ADC
+const float motorLatency = 0.08; //Seconds between switching on and visible motion
+const float kickLow = 40; //Hz, band used for the flux
+const float kickHigh = 200;
+unsigned int sampling_period_us;
+unsigned long microseconds;
+unsigned long beatPinOff = 0;
+
+/*
+These are the input and output vectors
+Input vectors receive computed results from FFT
+*/
+float vReal[samples];
+float vImag[samples];
+float previousMagnitude[samples >> 1];
+
+/* One frame per block of samples: frames arrive at samplingFrequency / samples */
+ArduinoFFT<float> FFT = ArduinoFFT<float>(vReal, vImag, samples, samplingFrequency, true);
+BeatTracker<float> beats = BeatTracker<float>(previousMagnitude, samples >> 1, samplingFrequency / samples);
+
+void setup()
+{
+  sampling_period_us = round(1000000*(1.0/samplingFrequency));
+  pinMode(BEAT_PIN, OUTPUT);
+  beats.setBand(kickLow * samples / samplingFrequency, kickHigh * samples / samplingFrequency);
+  Serial.begin(115200);
+  while(!Serial);
+  Serial.println("Ready");
+}
+
+void loop()
+{
+  /*SAMPLING*/
+  microseconds = micros();
+  for(int i=0; i<samples; i++)
+  {
+      vReal[i] = analogRead(CHANNEL);
+      vImag[i] = 0;
+      while(micros() - microseconds < sampling_period_us){
+        //empty loop
+      }
+      microseconds += sampling_period_us;
+  }
+  FFT.dcRemoval();
+  FFT.windowing(FFTWindow::Hann, FFTDirection::Forward);	/* Weigh data */
+  FFT.compute(FFTDirection::Forward); /* Compute FFT */
+  FFT.complexToMagnitude(); /* Compute magnitudes */
+
+  if (beats.process(vReal)) {
+    Serial.print("Onset, tempo ");
+    Serial.print(beats.tempo(), 1);
+    Serial.print(" BPM, confidence ");
+    Serial.println(beats.confidence(), 2);
+  }
+  /* Switch on early so the motion lands on the beat */
+  if (beats.beatAhead(motorLatency)) {
+    digitalWrite(BEAT_PIN, HIGH);
+    beatPinOff = millis() + 100;
+  }
+  if (beatPinOff && (long)(millis() - beatPinOff) >= 0) {
+    digitalWrite(BEAT_PIN, LOW);
+    beatPinOff = 0;
+  }
+}
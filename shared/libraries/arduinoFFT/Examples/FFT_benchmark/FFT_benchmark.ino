@@ -0,0 +1,131 @@
+/*
+
+	Benchmark of the FFT kernels on the target: times compute() with the
+	radix-2 and radix-4 butterflies for every size that fits in RAM and checks
+	both against a plain DFT of the same input.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "arduinoFFT.h"
+
+/*
+These values can be changed in order to evaluate the functions
+*/
+#if defined(__AVR__)
+const uint16_t maxSamples = 64; //Largest size tested, limited by RAM
+#else
+const uint16_t maxSamples = 1024;
+#endif
+const uint8_t repetitions = 20;
+const FFTAlgorithm algorithms[] = {FFTAlgorithm::Radix2, FFTAlgorithm::Radix4};
+
+/*
+Input vectors, the work vectors for the FFT and the reference DFT output
+*/
+float input[maxSamples];
+float vReal[maxSamples];
+float vImag[maxSamples];
+float dftReal[maxSamples];
+float dftImag[maxSamples];
+
+ArduinoFFT<float> FFT = ArduinoFFT<float>();
+
+void setup()
+{
+  Serial.begin(115200);
+  while(!Serial);
+  Serial.println("Ready");
+  Serial.println("N\tradix2 us\tradix4 us\tradix2 error\tradix4 error");
+  for (uint16_t samples = 16; samples <= maxSamples; samples <<= 1)
+  {
+    buildInput(samples);
+    referenceDft(samples);
+    Serial.print(samples);
+    float errors[2];
+    for (uint8_t k = 0; k < 2; k++)
+    {
+      FFT.setAlgorithm(algorithms[k]);
+      unsigned long start = micros();
+      for (uint8_t r = 0; r < repetitions; r++)
+      {
+        loadInput(samples);
+        FFT.compute(vReal, vImag, samples, FFTDirection::Forward);
+      }
+      unsigned long elapsed = micros() - start;
+      errors[k] = maxError(samples);
+      Serial.print("\t");
+      Serial.print(elapsed / repetitions);
+    }
+    Serial.print("\t");
+    Serial.print(errors[0], 6);
+    Serial.print("\t");
+    Serial.println(errors[1], 6);
+  }
+}
+
+void loop()
+{
+}
+
+void buildInput(uint16_t samples)
+{
+  /* A tone between bins plus a little noise */
+  for (uint16_t i = 0; i < samples; i++)
+  {
+    input[i] = sin(twoPi * 5.3 * i / samples) + (random(200) - 100) / 400.0;
+  }
+}
+
+void loadInput(uint16_t samples)
+{
+  for (uint16_t i = 0; i < samples; i++)
+  {
+    vReal[i] = input[i];
+    vImag[i] = 0;
+  }
+}
+
+void referenceDft(uint16_t samples)
+{
+  for (uint16_t k = 0; k < samples; k++)
+  {
+    float re = 0;
+    float im = 0;
+    for (uint16_t t = 0; t < samples; t++)
+    {
+      float angle = -twoPi * (uint32_t(k) * t % samples) / samples;
+      re += input[t] * cos(angle);
+      im += input[t] * sin(angle);
+    }
+    dftReal[k] = re;
+    dftImag[k] = im;
+  }
+}
+
+/* Largest bin error of the last FFT, relative to the largest DFT bin */
+float maxError(uint16_t samples)
+{
+  float worst = 0;
+  float peak = 0;
+  for (uint16_t k = 0; k < samples; k++)
+  {
+    float error = sqrt(sq(vReal[k] - dftReal[k]) + sq(vImag[k] - dftImag[k]));
+    float magnitude = sqrt(sq(dftReal[k]) + sq(dftImag[k]));
+    if (error > worst) worst = error;
+    if (magnitude > peak) peak = magnitude;
+  }
+  return worst / peak;
+}
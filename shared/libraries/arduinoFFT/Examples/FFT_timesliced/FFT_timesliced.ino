@@ -0,0 +1,112 @@
+/*
+
+	Example of the time-sliced transform: the FFT is spread over many passes of
+	loop() with computeBegin()/computeStep(), so a motor that must be serviced
+	every millisecond never waits for a whole compute(). The worst loop()
+	latency is printed next to the dominant frequency.
+
+	This program is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "arduinoFFT.h"
+
+/*
+These values can be changed in order to evaluate the functions
+*/
+#define CHANNEL A0
+#define MOTOR_PIN LED_BUILTIN
+const uint16_t samples = 64; //This value MUST ALWAYS be a power of 2
+const float samplingFrequency = 1000; //Hz, must be less than 10000 due to ADC
+const unsigned long motorPeriod_us = 1000; //Motor deadline, serviced every pass
+const unsigned long fftSlice_us = 400; //FFT time allowed per pass of loop()
+unsigned int sampling_period_us;
+unsigned long nextSample;
+unsigned long lastLoop;
+unsigned long worstLatency = 0;
+uint16_t sampleCount = 0;
+bool transforming = false;
+
+/*
+These are the input and output vectors
+Input vectors receive computed results from FFT
+*/
+float vReal[samples];
+float vImag[samples];
+
+ArduinoFFT<float> FFT = ArduinoFFT<float>(vReal, vImag, samples, samplingFrequency, true);
+FFTProgress<float> progress;
+
+void setup()
+{
+  sampling_period_us = round(1000000*(1.0/samplingFrequency));
+  pinMode(MOTOR_PIN, OUTPUT);
+  Serial.begin(115200);
+  while(!Serial);
+  Serial.println("Ready");
+  nextSample = lastLoop = micros();
+}
+
+/* Stands in for the motor executor: toggles the pin on a fixed schedule */
+void serviceMotor()
+{
+  static unsigned long nextToggle = 0;
+  unsigned long now = micros();
+  if ((long)(now - nextToggle) >= 0) {
+    digitalWrite(MOTOR_PIN, !digitalRead(MOTOR_PIN));
+    nextToggle = now + motorPeriod_us;
+  }
+}
+
+void loop()
+{
+  unsigned long start = micros();
+  if (start - lastLoop > worstLatency) {
+    worstLatency = start - lastLoop;
+  }
+  lastLoop = start;
+  serviceMotor();
+
+  if (!transforming) {
+    /* Sample without blocking; start the transform once the frame is full */
+    if ((long)(start - nextSample) >= 0) {
+      vReal[sampleCount] = analogRead(CHANNEL);
+      vImag[sampleCount] = 0;
+      nextSample += sampling_period_us;
+      if (++sampleCount == samples) {
+        sampleCount = 0;
+        FFT.dcRemoval();
+        FFT.windowing(FFTWindow::Hann, FFTDirection::Forward);
+        FFT.computeBegin(&progress, FFTDirection::Forward);
+        transforming = true;
+      }
+    }
+    return;
+  }
+
+  /* A few butterflies at a time until this pass's slice is used up */
+  while (micros() - start < fftSlice_us) {
+    if (FFT.computeStep(&progress, 4)) {
+      transforming = false;
+      FFT.complexToMagnitude();
+      Serial.print(FFT.majorPeak(), 1);
+      Serial.print(" Hz, worst loop latency ");
+      Serial.print(worstLatency);
+      Serial.println(" us");
+      worstLatency = 0;
+      nextSample = micros();
+      break;
+    }
+  }
+}
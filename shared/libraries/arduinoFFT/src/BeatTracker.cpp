@@ -0,0 +1,243 @@
+/*
+
+        Beat tracker for ArduinoFFT frames
+
+        This program is free software: you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation, either version 3 of the License, or
+        (at your option) any later version.
+
+        This program is distributed in the hope that it will be useful,
+        but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+        GNU General Public License for more details.
+
+        You should have received a copy of the GNU General Public License
+        along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "BeatTracker.h"
+
+/* PLL gains: phase and period correction per onset, as a fraction of the
+   error. Onsets further than the window from a predicted beat only nudge the
+   period through their inter-onset interval. */
+#define BEAT_PHASE_GAIN 0.3
+#define BEAT_PERIOD_GAIN 0.1
+#define BEAT_INTERVAL_GAIN 0.05
+#define BEAT_PHASE_WINDOW 0.2
+#define BEAT_LOCK_CONFIDENCE 0.5
+/* Onsets must also reach this fraction of the recent flux peak, which halves
+   every BEAT_PEAK_HALF_LIFE seconds */
+#define BEAT_PEAK_RATIO 0.3
+#define BEAT_PEAK_HALF_LIFE 2.0
+
+template <typename T>
+BeatTracker<T>::BeatTracker(T *previousMagnitude, uint_fast16_t bins,
+                            T frameRate, T minBpm, T maxBpm)
+    : _previous(previousMagnitude), _bins(bins), _lowBin(1), _highBin(bins - 1),
+      _frameRate(frameRate), _minPeriod(frameRate * 60 / maxBpm),
+      _maxPeriod(frameRate * 60 / minBpm),
+      _peakDecay(pow(0.5, 1.0 / (BEAT_PEAK_HALF_LIFE * frameRate))) {
+  reset();
+}
+
+template <typename T> void BeatTracker<T>::reset(void) {
+  for (uint_fast8_t i = 0; i < BEAT_TRACKER_HISTORY; i++) {
+    _history[i] = 0;
+  }
+  _historyCount = 0;
+  _historyIndex = 0;
+  _flux = 0;
+  _lastFlux = 0;
+  _lastLastFlux = 0;
+  _peak = 0;
+  _frame = 0;
+  _lastOnset = 0;
+  _havePrevious = false;
+  // Start at 120 BPM (or the nearest allowed tempo) with no confidence
+  _period = foldPeriod(_frameRate / 2);
+  _nextBeat = _period;
+  _confidence = 0;
+  _beatReported = false;
+}
+
+// Restrict the flux to a bin range, e.g. the kick drum band
+template <typename T>
+void BeatTracker<T>::setBand(uint_fast16_t lowBin, uint_fast16_t highBin) {
+  if (highBin >= _bins) {
+    highBin = _bins - 1;
+  }
+  _lowBin = lowBin;
+  _highBin = highBin < lowBin ? lowBin : highBin;
+}
+
+// Onsets must exceed mean + deviations * mean absolute deviation of the
+// recent flux, and at least minimumFlux
+template <typename T>
+void BeatTracker<T>::setSensitivity(T deviations, T minimumFlux) {
+  _deviations = deviations;
+  _minimumFlux = minimumFlux;
+}
+
+// Processes one magnitude spectrum; returns true when an onset was detected.
+// Peaks are confirmed one frame late, so the onset belongs to the previous
+// frame.
+template <typename T> bool BeatTracker<T>::process(const T *magnitude) {
+  T sum = 0;
+  for (uint_fast16_t i = _lowBin; i <= _highBin; i++) {
+    T rise = magnitude[i] - _previous[i];
+    if (_havePrevious && rise > 0) {
+      sum += rise;
+    }
+    _previous[i] = magnitude[i];
+  }
+  _havePrevious = true;
+
+  _lastLastFlux = _lastFlux;
+  _lastFlux = _flux;
+  _flux = sum;
+
+  bool onset = pickOnset();
+  _peak *= _peakDecay;
+  if (sum > _peak) {
+    _peak = sum;
+  }
+
+  _history[_historyIndex] = sum;
+  _historyIndex = (_historyIndex + 1) % BEAT_TRACKER_HISTORY;
+  if (_historyCount < BEAT_TRACKER_HISTORY) {
+    _historyCount++;
+  }
+
+  if (onset) {
+    trackOnset(_frame - 1);
+  }
+  _frame++;
+  advanceBeat();
+  return onset;
+}
+
+// Returns true once per predicted beat, as soon as that beat is less than
+// leadSeconds away. Call it every frame to start motion ahead of the beat.
+template <typename T> bool BeatTracker<T>::beatAhead(T leadSeconds) {
+  if (_beatReported || !isLocked()) {
+    return false;
+  }
+  T lead = leadSeconds * _frameRate;
+  if (lead > _period / 2) {
+    lead = _period / 2;
+  }
+  if (_nextBeat - _frame <= lead) {
+    _beatReported = true;
+    return true;
+  }
+  return false;
+}
+
+template <typename T> T BeatTracker<T>::confidence(void) const {
+  return _confidence;
+}
+
+template <typename T> T BeatTracker<T>::flux(void) const { return _flux; }
+
+template <typename T> bool BeatTracker<T>::isLocked(void) const {
+  return _confidence >= BEAT_LOCK_CONFIDENCE;
+}
+
+template <typename T> T BeatTracker<T>::secondsToNextBeat(void) const {
+  return (_nextBeat - _frame) / _frameRate;
+}
+
+template <typename T> T BeatTracker<T>::tempo(void) const {
+  return _frameRate * 60 / _period;
+}
+
+// Moves the prediction past the current frame
+template <typename T> void BeatTracker<T>::advanceBeat(void) {
+  while (_nextBeat <= _frame) {
+    _nextBeat += _period;
+    _beatReported = false;
+  }
+}
+
+// Folds an interval into the allowed period range by octaves
+template <typename T> T BeatTracker<T>::foldPeriod(T interval) const {
+  if (interval <= 0) {
+    return _minPeriod;
+  }
+  while (interval > _maxPeriod) {
+    interval /= 2;
+  }
+  while (interval < _minPeriod) {
+    interval *= 2;
+  }
+  return interval > _maxPeriod ? _maxPeriod : interval;
+}
+
+// The previous flux value is an onset if it is a local maximum above the
+// adaptive threshold of the flux that came before it
+template <typename T> bool BeatTracker<T>::pickOnset(void) {
+  if (_historyCount < 2 || _lastFlux <= _flux || _lastFlux <= _lastLastFlux ||
+      _lastFlux < _peak * BEAT_PEAK_RATIO) {
+    return false;
+  }
+  // Nothing faster than half the shortest beat period can be a new onset
+  if (_lastOnset && _frame - 1 - _lastOnset < _minPeriod / 2) {
+    return false;
+  }
+  // The newest history entry is _lastFlux itself; leave it out
+  uint_fast8_t count = _historyCount - 1;
+  T mean = 0;
+  for (uint_fast8_t i = 0; i < count; i++) {
+    mean += _history[(_historyIndex + BEAT_TRACKER_HISTORY - 2 - i) %
+                     BEAT_TRACKER_HISTORY];
+  }
+  mean /= count;
+  T deviation = 0;
+  for (uint_fast8_t i = 0; i < count; i++) {
+    T d = _history[(_historyIndex + BEAT_TRACKER_HISTORY - 2 - i) %
+                   BEAT_TRACKER_HISTORY] -
+          mean;
+    deviation += d < 0 ? -d : d;
+  }
+  deviation /= count;
+  return _lastFlux > mean + _deviations * deviation &&
+         _lastFlux > _minimumFlux;
+}
+
+template <typename T> void BeatTracker<T>::trackOnset(uint32_t frame) {
+  // Phase error against the closest predicted beat
+  T error = frame - _nextBeat;
+  if (error < -_period / 2) {
+    error += _period;
+  }
+  T window = _period * BEAT_PHASE_WINDOW;
+
+  if (error > -window && error < window) {
+    _nextBeat += BEAT_PHASE_GAIN * error;
+    _period += BEAT_PERIOD_GAIN * error;
+    _confidence += (1 - _confidence) * 0.2;
+  } else {
+    T interval = foldPeriod(T(frame - _lastOnset));
+    if (_lastOnset && interval > _minPeriod && interval < _maxPeriod) {
+      // Adopt the interval quickly until locked, then only drift towards it
+      T gain = isLocked() ? BEAT_INTERVAL_GAIN : 0.5;
+      _period += gain * (interval - _period);
+    }
+    _confidence *= 0.8;
+    // Without a lock, restart the beat grid on this onset
+    if (!isLocked()) {
+      _nextBeat = frame + _period;
+    }
+  }
+  if (_period < _minPeriod) {
+    _period = _minPeriod;
+  } else if (_period > _maxPeriod) {
+    _period = _maxPeriod;
+  }
+  _lastOnset = frame;
+}
+
+template class BeatTracker<double>;
+template class BeatTracker<float>;
@@ -0,0 +1,96 @@
+/*
+
+        Beat tracker for ArduinoFFT frames
+
+        This program is free software: you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation, either version 3 of the License, or
+        (at your option) any later version.
+
+        This program is distributed in the hope that it will be useful,
+        but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+        GNU General Public License for more details.
+
+        You should have received a copy of the GNU General Public License
+        along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef BeatTracker_h /* Prevent loading library twice */
+#define BeatTracker_h
+
+#include "arduinoFFT.h"
+
+// Number of past flux values used for the adaptive onset threshold.
+// Memory use is this many values of T plus the caller's magnitude buffer.
+#ifndef BEAT_TRACKER_HISTORY
+#define BEAT_TRACKER_HISTORY 16
+#endif
+
+/*
+  Incremental onset detector and beat predictor.
+
+  Feed it one magnitude spectrum per hop (vReal after complexToMagnitude()).
+  It computes half-wave rectified spectral flux over a bin range, picks
+  onsets against a running mean + deviation threshold, and locks a tempo
+  PLL onto them. The PLL predicts the next beat so motion can be started
+  ahead of it (beatAhead()) to hide motor latency.
+
+  All state is fixed size; the only buffer is the previous spectrum, which
+  the caller provides (bins values).
+*/
+template <typename T> class BeatTracker {
+public:
+  BeatTracker(T *previousMagnitude, uint_fast16_t bins, T frameRate,
+              T minBpm = 60, T maxBpm = 200);
+
+  bool process(const T *magnitude);
+  void reset(void);
+
+  void setBand(uint_fast16_t lowBin, uint_fast16_t highBin);
+  void setSensitivity(T deviations, T minimumFlux = 0);
+
+  bool beatAhead(T leadSeconds);
+  T confidence(void) const;
+  T flux(void) const;
+  bool isLocked(void) const;
+  T secondsToNextBeat(void) const;
+  T tempo(void) const;
+
+private:
+  /* Variables */
+  T _history[BEAT_TRACKER_HISTORY];
+  T *_previous;
+  uint_fast16_t _bins;
+  uint_fast16_t _lowBin;
+  uint_fast16_t _highBin;
+  T _frameRate;
+  T _minPeriod;
+  T _maxPeriod;
+  T _peakDecay;
+  T _deviations = 1.5;
+  T _minimumFlux = 0;
+  /* Onset state */
+  uint_fast8_t _historyCount;
+  uint_fast8_t _historyIndex;
+  T _flux;
+  T _lastFlux;
+  T _lastLastFlux;
+  T _peak;
+  uint32_t _frame;
+  uint32_t _lastOnset;
+  bool _havePrevious;
+  /* PLL state, in frames */
+  T _period;
+  T _nextBeat;
+  T _confidence;
+  bool _beatReported;
+  /* Functions */
+  void advanceBeat(void);
+  T foldPeriod(T interval) const;
+  bool pickOnset(void);
+  void trackOnset(uint32_t frame);
+};
+
+#endif
@@ -0,0 +1,131 @@
+/*
+
+        Batched multi-frame FFT for host builds of ArduinoFFT
+
+        This program is free software: you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation, either version 3 of the License, or
+        (at your option) any later version.
+
+        This program is distributed in the hope that it will be useful,
+        but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+        GNU General Public License for more details.
+
+        You should have received a copy of the GNU General Public License
+        along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "FFTBatch.h"
+
+#ifdef FFT_HOST_BUILD
+
+#include <chrono>
+
+template <typename T>
+FFTBatch<T>::FFTBatch(uint_fast16_t samples, FFTThreadPool *pool)
+    : _pool(pool ? pool : &FFTThreadPool::shared()), _samples(samples) {
+  while ((uint_fast16_t(1) << _power) < samples) {
+    _power++;
+  }
+  _fft.setAlgorithm(FFTAlgorithm::Simd);
+}
+
+template <typename T> FFTBatch<T>::~FFTBatch() { delete[] _windowFactors; }
+
+// Transforms frames frames in place; see the class comment for the layout
+template <typename T>
+void FFTBatch<T>::compute(T *vReal, T *vImag, uint32_t frames,
+                          FFTDirection dir, uint_fast32_t stride) {
+  if (stride == 0) {
+    stride = _samples;
+  }
+  // Default grain: about four chunks per thread, so stealing can even out
+  // threads that fall behind
+  uint32_t grain = _grain;
+  if (grain == 0) {
+    grain = frames / (_pool->size() * 4);
+    if (grain == 0) {
+      grain = 1;
+    }
+  }
+
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  _pool->parallelFor(frames, grain, [&](uint32_t begin, uint32_t end) {
+    for (uint32_t f = begin; f < end; f++) {
+      T *re = vReal + f * stride;
+      T *im = vImag + f * stride;
+      bool paired = _paired && dir == FFTDirection::Forward;
+      if (_windowFactors && dir == FFTDirection::Forward) {
+        _fft.windowing(re, _samples, static_cast<const T *>(_windowFactors),
+                       dir);
+        if (paired) {
+          _fft.windowing(im, _samples,
+                         static_cast<const T *>(_windowFactors), dir);
+        }
+      }
+      if (paired) {
+        _fft.computePair(re, im, _samples);
+      } else {
+        _fft.compute(re, im, _samples, _power, dir);
+      }
+      if (_magnitude) {
+        if (paired) {
+          _fft.pairToMagnitude(re, im, _samples);
+        } else {
+          _fft.complexToMagnitude(re, im, _samples);
+        }
+      }
+    }
+  });
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  _framesPerSecond = seconds > 0.0 ? frames / seconds : 0.0;
+}
+
+// Throughput of the last compute() call, including windowing and magnitudes
+template <typename T> double FFTBatch<T>::framesPerSecond(void) const {
+  return _framesPerSecond;
+}
+
+template <typename T> void FFTBatch<T>::setAlgorithm(FFTAlgorithm algorithm) {
+  _fft.setAlgorithm(algorithm);
+}
+
+// Frames per pool task; 0 picks about four tasks per thread
+template <typename T> void FFTBatch<T>::setGrain(uint32_t frames) {
+  _grain = frames;
+}
+
+// Each frame holds two real signals, one in vReal and one in vImag, and a
+// forward compute() transforms both at once with computePair()
+template <typename T> void FFTBatch<T>::setPaired(bool paired) {
+  _paired = paired;
+}
+
+// Convert frames to magnitudes after the forward transform
+template <typename T> void FFTBatch<T>::setMagnitudeOutput(bool magnitude) {
+  _magnitude = magnitude;
+}
+
+// Window applied to every frame before a forward transform; the factors are
+// computed once here. Rectangle turns windowing off.
+template <typename T>
+void FFTBatch<T>::setWindow(FFTWindow windowType, bool withCompensation) {
+  delete[] _windowFactors;
+  _windowFactors = nullptr;
+  if (windowType == FFTWindow::Rectangle && !withCompensation) {
+    return;
+  }
+  _windowFactors = new T[_samples / 2];
+  _fft.computeWindowingFactors(_windowFactors, _samples, windowType,
+                               withCompensation);
+}
+
+template class FFTBatch<double>;
+template class FFTBatch<float>;
+
+#endif
@@ -0,0 +1,80 @@
+/*
+
+        Batched multi-frame FFT for host builds of ArduinoFFT
+
+        This program is free software: you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation, either version 3 of the License, or
+        (at your option) any later version.
+
+        This program is distributed in the hope that it will be useful,
+        but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+        GNU General Public License for more details.
+
+        You should have received a copy of the GNU General Public License
+        along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef FFTBatch_h /* Prevent loading library twice */
+#define FFTBatch_h
+
+#include "FFTThreadPool.h"
+
+#ifdef FFT_HOST_BUILD
+
+/*
+  Transforms many frames of the same size in one call, spread over a
+  thread pool.
+
+  Frames live in caller-owned arrays, frame f starting at vReal + f * stride
+  and vImag + f * stride; a stride of 0 means frames are packed back to back
+  (stride == samples). Each frame is optionally windowed before a forward
+  transform and optionally turned into magnitudes after it, so a whole song
+  of STFT frames is one compute() call. With setPaired(true) each frame
+  carries two real signals, one in vReal and one in vImag, transformed
+  together by ArduinoFFT::computePair(). Frames are independent, so they are
+  handed to the pool in chunks and the cores share them out by stealing.
+
+  All frames go through one ArduinoFFT object whose compute() is const;
+  the Simd kernel builds its tables once under std::call_once, so sharing it
+  between threads is safe. framesPerSecond() reports the throughput of the
+  last compute() call.
+
+  Host builds only (FFT_HOST_BUILD).
+*/
+template <typename T> class FFTBatch {
+public:
+  explicit FFTBatch(uint_fast16_t samples, FFTThreadPool *pool = nullptr);
+  ~FFTBatch();
+
+  FFTBatch(const FFTBatch &) = delete;
+  FFTBatch &operator=(const FFTBatch &) = delete;
+
+  void compute(T *vReal, T *vImag, uint32_t frames, FFTDirection dir,
+               uint_fast32_t stride = 0);
+
+  double framesPerSecond(void) const;
+
+  void setAlgorithm(FFTAlgorithm algorithm);
+  void setGrain(uint32_t frames);
+  void setMagnitudeOutput(bool magnitude);
+  void setPaired(bool paired);
+  void setWindow(FFTWindow windowType, bool withCompensation = false);
+
+private:
+  /* Variables */
+  ArduinoFFT<T> _fft;
+  FFTThreadPool *_pool;
+  T *_windowFactors = nullptr;
+  double _framesPerSecond = 0.0;
+  uint32_t _grain = 0;
+  uint_fast16_t _samples;
+  uint_fast8_t _power = 0;
+  bool _magnitude = false;
+  bool _paired = false;
+};
+
+#endif
+#endif
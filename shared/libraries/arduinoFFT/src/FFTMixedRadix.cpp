@@ -0,0 +1,414 @@
+/*
+
+        Arbitrary-length FFT for host builds of ArduinoFFT
+
+        This program is free software: you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation, either version 3 of the License, or
+        (at your option) any later version.
+
+        This program is distributed in the hope that it will be useful,
+        but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+        GNU General Public License for more details.
+
+        You should have received a copy of the GNU General Public License
+        along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "FFTMixedRadix.h"
+
+#ifdef FFT_HOST_BUILD
+
+#include "FFTVector.h"
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace {
+
+const long double kPi = 3.14159265358979323846264338327950288L;
+
+// Forward DFTs of 2 to 5 points, in place on re[0..P) and im[0..P), each
+// value a group of Ops::lanes independent transforms
+template <class Ops> struct Radix2 {
+  typedef typename Ops::V V;
+  static const uint32_t P = 2;
+  static inline void apply(V *re, V *im) {
+    V r = Ops::sub(re[0], re[1]), i = Ops::sub(im[0], im[1]);
+    re[0] = Ops::add(re[0], re[1]);
+    im[0] = Ops::add(im[0], im[1]);
+    re[1] = r;
+    im[1] = i;
+  }
+};
+
+template <class Ops> struct Radix3 {
+  typedef typename Ops::V V;
+  static const uint32_t P = 3;
+  static inline void apply(V *re, V *im) {
+    const V half = Ops::splat(0.5);
+    const V sin60 = Ops::splat(0.866025403784438646763723170752936183L);
+    V sr = Ops::add(re[1], re[2]), si = Ops::add(im[1], im[2]);
+    V dr = Ops::sub(re[1], re[2]), di = Ops::sub(im[1], im[2]);
+    V ur = Ops::sub(re[0], Ops::mul(half, sr));
+    V ui = Ops::sub(im[0], Ops::mul(half, si));
+    // -i * sin60 * (x1 - x2)
+    V vr = Ops::mul(sin60, di), vi = Ops::mul(sin60, dr);
+    re[0] = Ops::add(re[0], sr);
+    im[0] = Ops::add(im[0], si);
+    re[1] = Ops::add(ur, vr);
+    im[1] = Ops::sub(ui, vi);
+    re[2] = Ops::sub(ur, vr);
+    im[2] = Ops::add(ui, vi);
+  }
+};
+
+template <class Ops> struct Radix4 {
+  typedef typename Ops::V V;
+  static const uint32_t P = 4;
+  static inline void apply(V *re, V *im) {
+    V t0r = Ops::add(re[0], re[2]), t0i = Ops::add(im[0], im[2]);
+    V t1r = Ops::sub(re[0], re[2]), t1i = Ops::sub(im[0], im[2]);
+    V t2r = Ops::add(re[1], re[3]), t2i = Ops::add(im[1], im[3]);
+    V t3r = Ops::sub(re[1], re[3]), t3i = Ops::sub(im[1], im[3]);
+    re[0] = Ops::add(t0r, t2r);
+    im[0] = Ops::add(t0i, t2i);
+    re[2] = Ops::sub(t0r, t2r);
+    im[2] = Ops::sub(t0i, t2i);
+    // x1 and x3 gain -i and +i times t3
+    re[1] = Ops::add(t1r, t3i);
+    im[1] = Ops::sub(t1i, t3r);
+    re[3] = Ops::sub(t1r, t3i);
+    im[3] = Ops::add(t1i, t3r);
+  }
+};
+
+template <class Ops> struct Radix5 {
+  typedef typename Ops::V V;
+  static const uint32_t P = 5;
+  static inline void apply(V *re, V *im) {
+    const V c1 = Ops::splat(0.309016994374947424102293417182819059L);
+    const V c2 = Ops::splat(-0.809016994374947424102293417182819059L);
+    const V s1 = Ops::splat(0.951056516295153572116439333379382143L);
+    const V s2 = Ops::splat(0.587785252292473129168705954639072769L);
+    V a1r = Ops::add(re[1], re[4]), a1i = Ops::add(im[1], im[4]);
+    V b1r = Ops::sub(re[1], re[4]), b1i = Ops::sub(im[1], im[4]);
+    V a2r = Ops::add(re[2], re[3]), a2i = Ops::add(im[2], im[3]);
+    V b2r = Ops::sub(re[2], re[3]), b2i = Ops::sub(im[2], im[3]);
+    V u1r = Ops::add(re[0], Ops::add(Ops::mul(c1, a1r), Ops::mul(c2, a2r)));
+    V u1i = Ops::add(im[0], Ops::add(Ops::mul(c1, a1i), Ops::mul(c2, a2i)));
+    V u2r = Ops::add(re[0], Ops::add(Ops::mul(c2, a1r), Ops::mul(c1, a2r)));
+    V u2i = Ops::add(im[0], Ops::add(Ops::mul(c2, a1i), Ops::mul(c1, a2i)));
+    // -i * (s1 b1 + s2 b2) and -i * (s2 b1 - s1 b2)
+    V v1r = Ops::add(Ops::mul(s1, b1i), Ops::mul(s2, b2i));
+    V v1i = Ops::add(Ops::mul(s1, b1r), Ops::mul(s2, b2r));
+    V v2r = Ops::sub(Ops::mul(s2, b1i), Ops::mul(s1, b2i));
+    V v2i = Ops::sub(Ops::mul(s2, b1r), Ops::mul(s1, b2r));
+    re[0] = Ops::add(re[0], Ops::add(a1r, a2r));
+    im[0] = Ops::add(im[0], Ops::add(a1i, a2i));
+    re[1] = Ops::add(u1r, v1r);
+    im[1] = Ops::sub(u1i, v1i);
+    re[4] = Ops::sub(u1r, v1r);
+    im[4] = Ops::add(u1i, v1i);
+    re[2] = Ops::add(u2r, v2r);
+    im[2] = Ops::sub(u2i, v2i);
+    re[3] = Ops::sub(u2r, v2r);
+    im[3] = Ops::add(u2i, v2i);
+  }
+};
+
+// DFTs at offsets r to end - 1 of one group, Ops::lanes offsets at a time.
+// The loops over the P points are unrolled so the values stay in registers;
+// at -O2 GCC would otherwise keep them on the stack.
+template <class Ops, template <class> class Kernel, typename T>
+inline uint32_t stockhamRun(uint32_t r, uint32_t end, uint32_t stride,
+                            uint32_t step, const T *wr, const T *wi,
+                            const T *inR, const T *inI, T *outR, T *outI) {
+  typedef typename Ops::V V;
+  const uint32_t P = Kernel<Ops>::P;
+  V re[P], im[P], twr[P], twi[P];
+#pragma GCC unroll 5
+  for (uint32_t j = 1; j < P; j++) {
+    twr[j] = Ops::splat(wr[j]);
+    twi[j] = Ops::splat(wi[j]);
+  }
+  for (; r + Ops::lanes <= end; r += Ops::lanes) {
+#pragma GCC unroll 5
+    for (uint32_t k = 0; k < P; k++) {
+      re[k] = Ops::load(inR + r + step * k);
+      im[k] = Ops::load(inI + r + step * k);
+    }
+    Kernel<Ops>::apply(re, im);
+    Ops::store(outR + r, re[0]);
+    Ops::store(outI + r, im[0]);
+#pragma GCC unroll 5
+    for (uint32_t j = 1; j < P; j++) {
+      Ops::store(outR + r + stride * j, Ops::sub(Ops::mul(re[j], twr[j]),
+                                                 Ops::mul(im[j], twi[j])));
+      Ops::store(outI + r + stride * j, Ops::add(Ops::mul(re[j], twi[j]),
+                                                 Ops::mul(im[j], twr[j])));
+    }
+  }
+  return r;
+}
+
+// One Stockham pass: for every group q and offset r, a P-point DFT of
+// x[r + stride * (q + span * k)], rotated by w^(j q) and written to
+// y[r + stride * (P * q + j)]. Inputs of one DFT sit N / P apart in every
+// pass, and the offsets r of a group are contiguous with equal twiddles, so
+// they go through the vector unit; early passes with a short stride fall
+// back to narrower vectors and then scalars.
+template <typename T, template <class> class Kernel>
+void stockhamPass(uint32_t span, uint32_t stride, const T *twiddleRe,
+                  const T *twiddleIm, const T *xr, const T *xi, T *yr, T *yi) {
+  const uint32_t P = Kernel<fft_vector::Scalar<T>>::P;
+  const uint32_t step = stride * span;
+  T wr[P], wi[P];
+  for (uint32_t q = 0; q < span; q++) {
+#pragma GCC unroll 5
+    for (uint32_t j = 1; j < P; j++) {
+      wr[j] = twiddleRe[q * (P - 1) + j - 1];
+      wi[j] = twiddleIm[q * (P - 1) + j - 1];
+    }
+    const T *inR = xr + stride * q;
+    const T *inI = xi + stride * q;
+    T *outR = yr + stride * P * q;
+    T *outI = yi + stride * P * q;
+    uint32_t r = 0;
+    if (stride >= uint32_t(fft_vector::Wide<T>::lanes)) {
+      r = stockhamRun<fft_vector::Wide<T>, Kernel>(r, stride, stride, step, wr,
+                                                   wi, inR, inI, outR, outI);
+    }
+    if (stride - r >= uint32_t(fft_vector::Narrow<T>::lanes)) {
+      r = stockhamRun<fft_vector::Narrow<T>, Kernel>(
+          r, stride, stride, step, wr, wi, inR, inI, outR, outI);
+    }
+    stockhamRun<fft_vector::Scalar<T>, Kernel>(r, stride, stride, step, wr, wi,
+                                               inR, inI, outR, outI);
+  }
+}
+
+// Per-thread work buffer, grown to the largest plan used on the thread
+template <typename T> T *workBuffer(size_t size) {
+  static thread_local std::vector<T> buffer;
+  if (buffer.size() < size) {
+    buffer.resize(size);
+  }
+  return buffer.data();
+}
+
+} // namespace
+
+template <typename T>
+FFTMixedRadix<T>::FFTMixedRadix(uint32_t samples) : _samples(samples) {
+  uint32_t rest = samples;
+  uint32_t stride = 1;
+  while (rest > 1) {
+    uint32_t radix = rest % 4 == 0   ? 4
+                     : rest % 2 == 0 ? 2
+                     : rest % 3 == 0 ? 3
+                     : rest % 5 == 0 ? 5
+                                     : 0;
+    if (radix == 0) {
+      _stages.clear();
+      planBluestein();
+      return;
+    }
+    Stage stage;
+    stage.radix = radix;
+    stage.span = rest / radix;
+    stage.stride = stride;
+    stage.twiddles = _twiddleRe.size();
+    // w^(j q) with w = exp(-2 pi i / rest)
+    for (uint32_t q = 0; q < stage.span; q++) {
+      for (uint32_t j = 1; j < radix; j++) {
+        long double angle = -2 * kPi * ((uint64_t(j) * q) % rest) / rest;
+        _twiddleRe.push_back(T(cosl(angle)));
+        _twiddleIm.push_back(T(sinl(angle)));
+      }
+    }
+    _stages.push_back(stage);
+    rest /= radix;
+    stride *= radix;
+  }
+}
+
+// Transforms samples points in place; Reverse scales by 1 / samples
+template <typename T>
+void FFTMixedRadix<T>::compute(T *vReal, T *vImag, FFTDirection dir) const {
+  if (_samples < 2) {
+    return;
+  }
+  size_t half = _padded ? _padded : _samples;
+  T *work = workBuffer<T>(2 * half);
+  // The inverse is the conjugate of the forward transform of the conjugate
+  if (dir == FFTDirection::Reverse) {
+    for (uint32_t i = 0; i < _samples; i++) {
+      vImag[i] = -vImag[i];
+    }
+  }
+  if (_padded) {
+    bluestein(vReal, vImag, work, work + half);
+  } else {
+    forward(vReal, vImag, work, work + half);
+  }
+  if (dir == FFTDirection::Reverse) {
+    T scale = T(1) / _samples;
+    for (uint32_t i = 0; i < _samples; i++) {
+      vReal[i] *= scale;
+      vImag[i] *= -scale;
+    }
+  }
+}
+
+template <typename T> uint32_t FFTMixedRadix<T>::samples(void) const {
+  return _samples;
+}
+
+// True when samples has a prime factor above 5
+template <typename T> bool FFTMixedRadix<T>::usesBluestein(void) const {
+  return _padded != 0;
+}
+
+template <typename T>
+const FFTMixedRadix<T> &FFTMixedRadix<T>::cached(uint32_t samples) {
+  // Chunked callers ask for the same length over and over; skip the lock
+  static thread_local const FFTMixedRadix<T> *last = nullptr;
+  if (last && last->_samples == samples) {
+    return *last;
+  }
+  static std::mutex lock;
+  static std::map<uint32_t, std::unique_ptr<FFTMixedRadix<T>>> plans;
+  std::lock_guard<std::mutex> guard(lock);
+  std::unique_ptr<FFTMixedRadix<T>> &plan = plans[samples];
+  if (!plan) {
+    plan.reset(new FFTMixedRadix<T>(samples));
+  }
+  last = plan.get();
+  return *plan;
+}
+
+template <typename T>
+void FFTMixedRadix<T>::forward(T *vReal, T *vImag, T *workReal,
+                               T *workImag) const {
+  const T *xr = vReal, *xi = vImag;
+  T *yr = workReal, *yi = workImag;
+  for (const Stage &stage : _stages) {
+    const T *twr = _twiddleRe.data() + stage.twiddles;
+    const T *twi = _twiddleIm.data() + stage.twiddles;
+    uint32_t span = stage.span, stride = stage.stride;
+    switch (stage.radix) {
+    case 2:
+      stockhamPass<T, Radix2>(span, stride, twr, twi, xr, xi, yr, yi);
+      break;
+    case 3:
+      stockhamPass<T, Radix3>(span, stride, twr, twi, xr, xi, yr, yi);
+      break;
+    case 4:
+      stockhamPass<T, Radix4>(span, stride, twr, twi, xr, xi, yr, yi);
+      break;
+    default:
+      stockhamPass<T, Radix5>(span, stride, twr, twi, xr, xi, yr, yi);
+      break;
+    }
+    // Ping-pong between the caller's arrays and the work buffer
+    T *nextR = (yr == workReal) ? vReal : workReal;
+    T *nextI = (yi == workImag) ? vImag : workImag;
+    xr = yr;
+    xi = yi;
+    yr = nextR;
+    yi = nextI;
+  }
+  if (xr != vReal) {
+    for (uint32_t i = 0; i < _samples; i++) {
+      vReal[i] = xr[i];
+      vImag[i] = xi[i];
+    }
+  }
+}
+
+/*
+  X[k] = w[k] * sum_n (x[n] w[n]) conj(w[k - n]), with w[n] = exp(-pi i n^2 / N).
+  The sum is a circular convolution of length _padded done by FFT. The
+  library's forward transform assumes real input, so both transforms run in
+  the Reverse direction: Reverse(conj(a)) = conj(FFT(a)) / M, and the kernel
+  holds M * FFT(conj(w)) to cancel the scaling.
+*/
+template <typename T>
+void FFTMixedRadix<T>::bluestein(T *vReal, T *vImag, T *workReal,
+                                 T *workImag) const {
+  for (uint32_t n = 0; n < _samples; n++) {
+    T r = vReal[n] * _chirpRe[n] - vImag[n] * _chirpIm[n];
+    T i = vReal[n] * _chirpIm[n] + vImag[n] * _chirpRe[n];
+    workReal[n] = r;
+    workImag[n] = -i;
+  }
+  for (uint32_t n = _samples; n < _padded; n++) {
+    workReal[n] = 0;
+    workImag[n] = 0;
+  }
+  _inner.compute(workReal, workImag, _padded, _paddedPower,
+                 FFTDirection::Reverse);
+  for (uint32_t k = 0; k < _padded; k++) {
+    T r = workReal[k], i = -workImag[k];
+    workReal[k] = r * _kernelRe[k] - i * _kernelIm[k];
+    workImag[k] = r * _kernelIm[k] + i * _kernelRe[k];
+  }
+  _inner.compute(workReal, workImag, _padded, _paddedPower,
+                 FFTDirection::Reverse);
+  for (uint32_t k = 0; k < _samples; k++) {
+    vReal[k] = workReal[k] * _chirpRe[k] - workImag[k] * _chirpIm[k];
+    vImag[k] = workReal[k] * _chirpIm[k] + workImag[k] * _chirpRe[k];
+  }
+}
+
+template <typename T> void FFTMixedRadix<T>::planBluestein(void) {
+  _padded = 1;
+  while (_padded < 2 * _samples - 1) {
+    _padded <<= 1;
+    _paddedPower++;
+  }
+  // The vector kernel caches tables up to 2^fft_vector::maxPower points; its
+  // long double twiddles also keep the kernel below accurate
+  FFTAlgorithm algorithm = _paddedPower <= fft_vector::maxPower
+                               ? FFTAlgorithm::Simd
+                               : FFTAlgorithm::Radix4;
+  _inner.setAlgorithm(algorithm);
+
+  _chirpRe.resize(_samples);
+  _chirpIm.resize(_samples);
+  std::vector<double> bRe(_padded, 0.0), bIm(_padded, 0.0);
+  for (uint32_t n = 0; n < _samples; n++) {
+    // n^2 mod 2N keeps the angle exact for large n
+    long double angle =
+        -kPi * ((uint64_t(n) * n) % (2 * uint64_t(_samples))) / _samples;
+    _chirpRe[n] = T(cosl(angle));
+    _chirpIm[n] = T(sinl(angle));
+    // conj(w), then conj again for the Reverse-direction transform
+    bRe[n] = double(cosl(angle));
+    bIm[n] = double(sinl(angle));
+    if (n > 0) {
+      bRe[_padded - n] = bRe[n];
+      bIm[_padded - n] = bIm[n];
+    }
+  }
+  // Reverse(conj(b)) = conj(FFT(b)) / M, so M * FFT(b) = M^2 * conj(...)
+  ArduinoFFT<double> planner;
+  planner.setAlgorithm(algorithm);
+  planner.compute(bRe.data(), bIm.data(), _padded, _paddedPower,
+                  FFTDirection::Reverse);
+  double scale = double(_padded) * double(_padded);
+  _kernelRe.resize(_padded);
+  _kernelIm.resize(_padded);
+  for (uint32_t k = 0; k < _padded; k++) {
+    _kernelRe[k] = T(bRe[k] * scale);
+    _kernelIm[k] = T(-bIm[k] * scale);
+  }
+}
+
+template class FFTMixedRadix<double>;
+template class FFTMixedRadix<float>;
+
+#endif
@@ -0,0 +1,87 @@
+/*
+
+        Arbitrary-length FFT for host builds of ArduinoFFT
+
+        This program is free software: you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation, either version 3 of the License, or
+        (at your option) any later version.
+
+        This program is distributed in the hope that it will be useful,
+        but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+        GNU General Public License for more details.
+
+        You should have received a copy of the GNU General Public License
+        along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef FFTMixedRadix_h /* Prevent loading library twice */
+#define FFTMixedRadix_h
+
+#include "arduinoFFT.h"
+
+#ifdef FFT_HOST_BUILD
+
+#include <vector>
+
+/*
+  Complex FFT of any length, with the same direction and scaling
+  conventions as ArduinoFFT::compute().
+
+  Lengths that factor into 2, 3, 4 and 5 (960 = 2^6 * 3 * 5 and
+  1200 = 2^4 * 3 * 5^2, the Pi's 40 and 50 ms chunks at 24 kHz) run as a
+  Stockham autosort FFT, one pass per factor, in natural order with no bit
+  reversal. Any other length uses Bluestein's algorithm: a chirp turns the
+  transform into a circular convolution, done with two power-of-two
+  ArduinoFFT transforms of at least 2 * samples - 1 points.
+
+  Twiddles and chirps are computed once per length, in long double, and the
+  plan is const afterwards, so one plan can be shared between threads.
+  cached() keeps one plan per length for the whole process, and
+  ArduinoFFT::compute() uses it for every length that is not a power of two.
+  Work buffers are per thread, so compute() needs no caller scratch.
+
+  Host builds only (FFT_HOST_BUILD).
+*/
+template <typename T> class FFTMixedRadix {
+public:
+  explicit FFTMixedRadix(uint32_t samples);
+
+  void compute(T *vReal, T *vImag, FFTDirection dir) const;
+
+  uint32_t samples(void) const;
+  bool usesBluestein(void) const;
+
+  // Process-wide plan for samples, built on first use
+  static const FFTMixedRadix<T> &cached(uint32_t samples);
+
+private:
+  struct Stage {
+    uint32_t radix;   // Factor handled by this pass
+    uint32_t span;    // Butterflies per group (length / radix at this pass)
+    uint32_t stride;  // Product of the radices of the earlier passes
+    size_t twiddles;  // Offset of this pass in the twiddle tables
+  };
+
+  /* Variables */
+  ArduinoFFT<T> _inner;
+  std::vector<Stage> _stages;
+  std::vector<T> _twiddleRe;
+  std::vector<T> _twiddleIm;
+  std::vector<T> _chirpRe;
+  std::vector<T> _chirpIm;
+  std::vector<T> _kernelRe;
+  std::vector<T> _kernelIm;
+  uint32_t _samples;
+  uint32_t _padded = 0;
+  uint_fast8_t _paddedPower = 0;
+  /* Functions */
+  void bluestein(T *vReal, T *vImag, T *workReal, T *workImag) const;
+  void forward(T *vReal, T *vImag, T *workReal, T *workImag) const;
+  void planBluestein(void);
+};
+
+#endif
+#endif
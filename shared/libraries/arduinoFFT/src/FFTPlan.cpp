@@ -0,0 +1,121 @@
+/*
+
+        Shareable FFT plan for ArduinoFFT
+
+        This program is free software: you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation, either version 3 of the License, or
+        (at your option) any later version.
+
+        This program is distributed in the hope that it will be useful,
+        but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+        GNU General Public License for more details.
+
+        You should have received a copy of the GNU General Public License
+        along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "FFTPlan.h"
+
+// The inner ArduinoFFT has no arrays; only its const, pointer-taking
+// methods are used, so it holds nothing that changes after construction
+template <typename T>
+FFTPlan<T>::FFTPlan(uint_fast16_t samples, T samplingFrequency,
+                    FFTWindow windowType, bool withCompensation,
+                    FFTAlgorithm algorithm, T *windowingFactors)
+    : _fft(nullptr, nullptr, samples, samplingFrequency),
+      _windowingFactors(windowingFactors),
+      _samplingFrequency(samplingFrequency), _samples(samples), _power(0),
+      _ownsWindowingFactors(false) {
+  while ((uint_fast16_t(1) << _power) < samples) {
+    _power++;
+  }
+  _fft.setAlgorithm(algorithm);
+  if (windowType == FFTWindow::Rectangle && !withCompensation) {
+    _windowingFactors = nullptr;
+    return;
+  }
+  if (_windowingFactors == nullptr) {
+    _windowingFactors = new T[samples / 2];
+    _ownsWindowingFactors = true;
+  }
+  _fft.computeWindowingFactors(_windowingFactors, samples, windowType,
+                               withCompensation);
+}
+
+template <typename T> FFTPlan<T>::~FFTPlan() {
+  if (_ownsWindowingFactors) {
+    delete[] _windowingFactors;
+  }
+}
+
+template <typename T>
+void FFTPlan<T>::complexToMagnitude(const FFTWorkspace<T> &workspace) const {
+  _fft.complexToMagnitude(workspace.vReal, workspace.vImag, _samples);
+}
+
+template <typename T>
+void FFTPlan<T>::compute(const FFTWorkspace<T> &workspace,
+                         FFTDirection dir) const {
+  _fft.compute(workspace.vReal, workspace.vImag, _samples, _power, dir);
+}
+
+// Two real signals, one in vReal and one in vImag; see
+// ArduinoFFT::computePair() for the output layout
+template <typename T>
+void FFTPlan<T>::computePair(const FFTWorkspace<T> &workspace) const {
+  _fft.computePair(workspace.vReal, workspace.vImag, _samples);
+}
+
+template <typename T>
+void FFTPlan<T>::dcRemoval(const FFTWorkspace<T> &workspace) const {
+  _fft.dcRemoval(workspace.vReal, _samples);
+}
+
+template <typename T>
+void FFTPlan<T>::majorPeak(const FFTWorkspace<T> &workspace, T *frequency,
+                           T *magnitude) const {
+  _fft.majorPeak(workspace.vReal, _samples, _samplingFrequency, frequency,
+                 magnitude);
+}
+
+template <typename T>
+uint_fast8_t FFTPlan<T>::majorPeaks(const FFTWorkspace<T> &workspace,
+                                    FFTPeak<T> *peaks,
+                                    uint_fast8_t count) const {
+  return _fft.majorPeaks(workspace.vReal, _samples, _samplingFrequency, peaks,
+                         count);
+}
+
+template <typename T>
+void FFTPlan<T>::pairToMagnitude(const FFTWorkspace<T> &workspace) const {
+  _fft.pairToMagnitude(workspace.vReal, workspace.vImag, _samples);
+}
+
+// Applies the plan's window to vReal; does nothing for Rectangle
+template <typename T>
+void FFTPlan<T>::windowing(const FFTWorkspace<T> &workspace,
+                           FFTDirection dir) const {
+  if (_windowingFactors) {
+    _fft.windowing(workspace.vReal, _samples,
+                   static_cast<const T *>(_windowingFactors), dir);
+  }
+}
+
+template <typename T> uint_fast16_t FFTPlan<T>::samples(void) const {
+  return _samples;
+}
+
+template <typename T> T FFTPlan<T>::samplingFrequency(void) const {
+  return _samplingFrequency;
+}
+
+// The samples / 2 factors, or nullptr for Rectangle
+template <typename T> const T *FFTPlan<T>::windowingFactors(void) const {
+  return _windowingFactors;
+}
+
+template class FFTPlan<double>;
+template class FFTPlan<float>;
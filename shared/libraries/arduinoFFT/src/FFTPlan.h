@@ -0,0 +1,93 @@
+/*
+
+        Shareable FFT plan for ArduinoFFT
+
+        This program is free software: you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation, either version 3 of the License, or
+        (at your option) any later version.
+
+        This program is distributed in the hope that it will be useful,
+        but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+        GNU General Public License for more details.
+
+        You should have received a copy of the GNU General Public License
+        along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef FFTPlan_h /* Prevent loading library twice */
+#define FFTPlan_h
+
+#include "arduinoFFT.h"
+
+// The arrays one transform works on; cheap to make per call or per pipeline
+template <typename T> struct FFTWorkspace {
+  FFTWorkspace(T *real, T *imag) : vReal(real), vImag(imag) {}
+
+  T *vReal;
+  T *vImag;
+};
+
+/*
+  Everything about a transform that does not change between calls: size,
+  sampling frequency, kernel and window factors. The factors are computed in
+  the constructor and never written again, and every method is const and
+  touches only the workspace it is given, so one plan can serve several
+  pipelines at once (vocals, drums and mic analysis, other threads, an ISR)
+  without locks or duplicated tables:
+
+    static float hannFactors[64 / 2];
+    static const FFTPlan<float> plan(64, 8000, FFTWindow::Hann, false,
+                                     FFTAlgorithm::Radix4, hannFactors);
+
+    FFTWorkspace<float> mic(micReal, micImag);
+    plan.windowing(mic, FFTDirection::Forward);
+    plan.compute(mic, FFTDirection::Forward);
+    plan.complexToMagnitude(mic);
+
+  Pass a samples / 2 buffer to keep the factors off the heap; otherwise the
+  plan allocates them, unless the window is Rectangle, which needs none.
+*/
+template <typename T> class FFTPlan {
+public:
+  FFTPlan(uint_fast16_t samples, T samplingFrequency,
+          FFTWindow windowType = FFTWindow::Rectangle,
+          bool withCompensation = false,
+          FFTAlgorithm algorithm = FFTAlgorithm::Radix2,
+          T *windowingFactors = nullptr);
+  ~FFTPlan();
+
+  FFTPlan(const FFTPlan &) = delete;
+  FFTPlan &operator=(const FFTPlan &) = delete;
+
+  void complexToMagnitude(const FFTWorkspace<T> &workspace) const;
+  void compute(const FFTWorkspace<T> &workspace, FFTDirection dir) const;
+  void computePair(const FFTWorkspace<T> &workspace) const;
+  void dcRemoval(const FFTWorkspace<T> &workspace) const;
+
+  void majorPeak(const FFTWorkspace<T> &workspace, T *frequency,
+                 T *magnitude) const;
+  uint_fast8_t majorPeaks(const FFTWorkspace<T> &workspace, FFTPeak<T> *peaks,
+                          uint_fast8_t count) const;
+
+  void pairToMagnitude(const FFTWorkspace<T> &workspace) const;
+
+  void windowing(const FFTWorkspace<T> &workspace, FFTDirection dir) const;
+
+  uint_fast16_t samples(void) const;
+  T samplingFrequency(void) const;
+  const T *windowingFactors(void) const;
+
+private:
+  /* Variables */
+  ArduinoFFT<T> _fft;
+  T *_windowingFactors;
+  T _samplingFrequency;
+  uint_fast16_t _samples;
+  uint_fast8_t _power;
+  bool _ownsWindowingFactors;
+};
+
+#endif
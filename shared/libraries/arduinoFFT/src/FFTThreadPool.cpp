@@ -0,0 +1,159 @@
+/*
+
+        Work-stealing thread pool for host builds of ArduinoFFT
+
+        This program is free software: you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation, either version 3 of the License, or
+        (at your option) any later version.
+
+        This program is distributed in the hope that it will be useful,
+        but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+        GNU General Public License for more details.
+
+        You should have received a copy of the GNU General Public License
+        along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "FFTThreadPool.h"
+
+#ifdef FFT_HOST_BUILD
+
+// Chunks of one parallelFor() call
+struct FFTThreadPool::Group {
+  const Task *task;
+  std::atomic<uint32_t> remaining;
+  std::mutex lock;
+  std::condition_variable done;
+};
+
+FFTThreadPool::FFTThreadPool(unsigned threads) : _pending(0), _nextQueue(0) {
+  if (threads == 0) {
+    threads = std::thread::hardware_concurrency();
+  }
+  if (threads == 0) {
+    threads = 1;
+  }
+  for (unsigned i = 0; i < threads; i++) {
+    _queues.emplace_back(new Queue);
+  }
+  for (unsigned i = 0; i < threads; i++) {
+    _threads.emplace_back(&FFTThreadPool::workerLoop, this, i);
+  }
+}
+
+FFTThreadPool::~FFTThreadPool() {
+  {
+    std::lock_guard<std::mutex> guard(_sleepLock);
+    _stopping = true;
+  }
+  _wake.notify_all();
+  for (std::thread &thread : _threads) {
+    thread.join();
+  }
+}
+
+unsigned FFTThreadPool::size(void) const { return unsigned(_threads.size()); }
+
+FFTThreadPool &FFTThreadPool::shared(void) {
+  static FFTThreadPool pool;
+  return pool;
+}
+
+void FFTThreadPool::parallelFor(uint32_t count, uint32_t grain,
+                                const Task &task) {
+  if (count == 0) {
+    return;
+  }
+  if (grain == 0) {
+    grain = 1;
+  }
+  uint32_t chunks = (count + grain - 1) / grain;
+  if (chunks == 1) {
+    task(0, count);
+    return;
+  }
+
+  Group group;
+  group.task = &task;
+  group.remaining = chunks;
+  // Deal the chunks round-robin, starting after the last call's queue so
+  // concurrent callers spread out
+  size_t queue = _nextQueue.fetch_add(1) % _queues.size();
+  for (uint32_t begin = 0; begin < count; begin += grain) {
+    uint32_t end = count - begin > grain ? begin + grain : count;
+    Queue &q = *_queues[queue];
+    {
+      std::lock_guard<std::mutex> guard(q.lock);
+      q.chunks.push_back(Chunk{&group, begin, end});
+    }
+    queue = (queue + 1) % _queues.size();
+  }
+  {
+    std::lock_guard<std::mutex> guard(_sleepLock);
+    _pending += chunks;
+  }
+  _wake.notify_all();
+
+  // Help until every chunk of this call has been taken, then wait for the
+  // ones still running elsewhere
+  while (group.remaining.load() > 0 && runOne(queue)) {
+  }
+  std::unique_lock<std::mutex> guard(group.lock);
+  group.done.wait(guard, [&]() { return group.remaining.load() == 0; });
+}
+
+// Runs one chunk, preferring the back of queue home and stealing from the
+// front of the others; returns false when every queue is empty
+bool FFTThreadPool::runOne(size_t home) {
+  Chunk chunk;
+  bool found = false;
+  {
+    Queue &q = *_queues[home];
+    std::lock_guard<std::mutex> guard(q.lock);
+    if (!q.chunks.empty()) {
+      chunk = q.chunks.back();
+      q.chunks.pop_back();
+      found = true;
+    }
+  }
+  for (size_t i = 1; !found && i < _queues.size(); i++) {
+    Queue &q = *_queues[(home + i) % _queues.size()];
+    std::lock_guard<std::mutex> guard(q.lock);
+    if (!q.chunks.empty()) {
+      chunk = q.chunks.front();
+      q.chunks.pop_front();
+      found = true;
+    }
+  }
+  if (!found) {
+    return false;
+  }
+  _pending--;
+
+  (*chunk.group->task)(chunk.begin, chunk.end);
+  // The group lives on the caller's stack: count down and notify under its
+  // lock so the caller cannot see zero and return while it is still in use
+  std::lock_guard<std::mutex> guard(chunk.group->lock);
+  if (chunk.group->remaining.fetch_sub(1) == 1) {
+    chunk.group->done.notify_all();
+  }
+  return true;
+}
+
+void FFTThreadPool::workerLoop(size_t index) {
+  for (;;) {
+    if (runOne(index)) {
+      continue;
+    }
+    std::unique_lock<std::mutex> guard(_sleepLock);
+    _wake.wait(guard, [&]() { return _stopping || _pending.load() > 0; });
+    if (_stopping && _pending.load() == 0) {
+      return;
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,93 @@
+/*
+
+        Work-stealing thread pool for host builds of ArduinoFFT
+
+        This program is free software: you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation, either version 3 of the License, or
+        (at your option) any later version.
+
+        This program is distributed in the hope that it will be useful,
+        but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+        GNU General Public License for more details.
+
+        You should have received a copy of the GNU General Public License
+        along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef FFTThreadPool_h /* Prevent loading library twice */
+#define FFTThreadPool_h
+
+#include "arduinoFFT.h"
+
+#ifdef FFT_HOST_BUILD
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+  Fixed set of worker threads, each with its own queue of chunks.
+
+  parallelFor() splits a range into chunks and deals them round-robin onto
+  the queues. A worker takes chunks from the back of its own queue and, when
+  that is empty, steals from the front of the others, so uneven chunks even
+  out without a central queue. The calling thread steals too while it
+  waits, which keeps nested or concurrent calls (several songs analysed at
+  once, each batching its frames) from deadlocking or idling a core.
+
+  Host builds only (FFT_HOST_BUILD).
+*/
+class FFTThreadPool {
+public:
+  typedef std::function<void(uint32_t begin, uint32_t end)> Task;
+
+  // 0 threads means one per hardware thread
+  explicit FFTThreadPool(unsigned threads = 0);
+  ~FFTThreadPool();
+
+  FFTThreadPool(const FFTThreadPool &) = delete;
+  FFTThreadPool &operator=(const FFTThreadPool &) = delete;
+
+  // Runs task over [0, count) in chunks of at most grain items and returns
+  // once every chunk has finished
+  void parallelFor(uint32_t count, uint32_t grain, const Task &task);
+  unsigned size(void) const;
+
+  // Process-wide pool with one thread per hardware thread
+  static FFTThreadPool &shared(void);
+
+private:
+  struct Group;
+  struct Chunk {
+    Group *group;
+    uint32_t begin;
+    uint32_t end;
+  };
+  struct Queue {
+    std::mutex lock;
+    std::deque<Chunk> chunks;
+  };
+
+  /* Variables */
+  std::vector<std::unique_ptr<Queue>> _queues;
+  std::vector<std::thread> _threads;
+  std::mutex _sleepLock;
+  std::condition_variable _wake;
+  std::atomic<uint32_t> _pending;
+  std::atomic<unsigned> _nextQueue;
+  bool _stopping = false;
+  /* Functions */
+  bool runOne(size_t home);
+  void workerLoop(size_t index);
+};
+
+#endif
+#endif
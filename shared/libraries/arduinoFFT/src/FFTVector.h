@@ -0,0 +1,343 @@
+/*
+
+        Vectorised butterflies for host builds of ArduinoFFT
+
+        This program is free software: you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation, either version 3 of the License, or
+        (at your option) any later version.
+
+        This program is distributed in the hope that it will be useful,
+        but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+        GNU General Public License for more details.
+
+        You should have received a copy of the GNU General Public License
+        along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef FFTVector_h /* Prevent loading library twice */
+#define FFTVector_h
+
+/*
+  Backend for FFTAlgorithm::Simd, included by arduinoFFT.cpp on host builds
+  only (see FFT_VECTOR_BACKEND in arduinoFFT.h). FFT_VECTOR_NAME names the
+  instruction set in use.
+
+  The butterflies are the radix-4 ones of butterfliesRadix4(), run on the
+  split vReal/vImag arrays several at a time: a pass with quarter size l1
+  loads lanes consecutive values from each quarter and the matching twiddles
+  from a table, so each instruction does the work of lanes butterflies.
+  The instruction set is chosen at compile time: AVX (build with -mavx2 or
+  -march=native), SSE2 (any x86-64) or NEON (aarch64), with a scalar loop
+  over the same tables elsewhere. Twiddles are computed once per size and
+  direction in long double, so the result is at least as accurate as the
+  recurrence used by the other kernels.
+*/
+
+#include "enumsFFT.h"
+#include <math.h>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+// FFT_DISABLE_SIMD leaves only the scalar loop, e.g. to compare results
+#if !defined(FFT_DISABLE_SIMD)
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace fft_vector {
+
+// Largest power of two the tables are cached for: every length a 32-bit swap
+// index and uint_fast16_t can hold. compute() runs anything longer on the
+// radix-4 kernel instead.
+const uint_fast8_t maxPower = sizeof(uint_fast16_t) >= 4 ? 31 : 15;
+
+/* Operations on one group of lanes; Scalar is the one-lane fallback */
+template <typename T> struct Scalar {
+  typedef T V;
+  static const int lanes = 1;
+  static V splat(T v) { return v; }
+  static V load(const T *p) { return *p; }
+  static void store(T *p, V v) { *p = v; }
+  static V add(V a, V b) { return a + b; }
+  static V sub(V a, V b) { return a - b; }
+  static V mul(V a, V b) { return a * b; }
+};
+
+#if !defined(FFT_DISABLE_SIMD) && defined(__AVX__)
+#define FFT_VECTOR_NAME "avx"
+template <typename T> struct Wide;
+template <> struct Wide<float> {
+  typedef __m256 V;
+  static const int lanes = 8;
+  static V splat(float v) { return _mm256_set1_ps(v); }
+  static V load(const float *p) { return _mm256_loadu_ps(p); }
+  static void store(float *p, V v) { _mm256_storeu_ps(p, v); }
+  static V add(V a, V b) { return _mm256_add_ps(a, b); }
+  static V sub(V a, V b) { return _mm256_sub_ps(a, b); }
+  static V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+};
+template <> struct Wide<double> {
+  typedef __m256d V;
+  static const int lanes = 4;
+  static V splat(double v) { return _mm256_set1_pd(v); }
+  static V load(const double *p) { return _mm256_loadu_pd(p); }
+  static void store(double *p, V v) { _mm256_storeu_pd(p, v); }
+  static V add(V a, V b) { return _mm256_add_pd(a, b); }
+  static V sub(V a, V b) { return _mm256_sub_pd(a, b); }
+  static V mul(V a, V b) { return _mm256_mul_pd(a, b); }
+};
+#endif
+
+#if !defined(FFT_DISABLE_SIMD) && defined(__SSE2__)
+template <typename T> struct Narrow;
+template <> struct Narrow<float> {
+  typedef __m128 V;
+  static const int lanes = 4;
+  static V splat(float v) { return _mm_set1_ps(v); }
+  static V load(const float *p) { return _mm_loadu_ps(p); }
+  static void store(float *p, V v) { _mm_storeu_ps(p, v); }
+  static V add(V a, V b) { return _mm_add_ps(a, b); }
+  static V sub(V a, V b) { return _mm_sub_ps(a, b); }
+  static V mul(V a, V b) { return _mm_mul_ps(a, b); }
+};
+template <> struct Narrow<double> {
+  typedef __m128d V;
+  static const int lanes = 2;
+  static V splat(double v) { return _mm_set1_pd(v); }
+  static V load(const double *p) { return _mm_loadu_pd(p); }
+  static void store(double *p, V v) { _mm_storeu_pd(p, v); }
+  static V add(V a, V b) { return _mm_add_pd(a, b); }
+  static V sub(V a, V b) { return _mm_sub_pd(a, b); }
+  static V mul(V a, V b) { return _mm_mul_pd(a, b); }
+};
+#if !defined(__AVX__)
+#define FFT_VECTOR_NAME "sse2"
+template <typename T> struct Wide : Narrow<T> {};
+#endif
+#elif !defined(FFT_DISABLE_SIMD) && defined(__ARM_NEON) && defined(__aarch64__)
+#define FFT_VECTOR_NAME "neon"
+template <typename T> struct Wide;
+template <> struct Wide<float> {
+  typedef float32x4_t V;
+  static const int lanes = 4;
+  static V splat(float v) { return vdupq_n_f32(v); }
+  static V load(const float *p) { return vld1q_f32(p); }
+  static void store(float *p, V v) { vst1q_f32(p, v); }
+  static V add(V a, V b) { return vaddq_f32(a, b); }
+  static V sub(V a, V b) { return vsubq_f32(a, b); }
+  static V mul(V a, V b) { return vmulq_f32(a, b); }
+};
+template <> struct Wide<double> {
+  typedef float64x2_t V;
+  static const int lanes = 2;
+  static V splat(double v) { return vdupq_n_f64(v); }
+  static V load(const double *p) { return vld1q_f64(p); }
+  static void store(double *p, V v) { vst1q_f64(p, v); }
+  static V add(V a, V b) { return vaddq_f64(a, b); }
+  static V sub(V a, V b) { return vsubq_f64(a, b); }
+  static V mul(V a, V b) { return vmulq_f64(a, b); }
+};
+template <typename T> struct Narrow : Scalar<T> {};
+#else
+#define FFT_VECTOR_NAME "scalar"
+template <typename T> struct Wide : Scalar<T> {};
+template <typename T> struct Narrow : Scalar<T> {};
+#endif
+
+/*
+  Per size and direction: the bit-reversal swaps as index pairs, and the
+  twiddles of every radix-4 pass. For a pass with quarter size l1 the
+  twiddles are six runs of l1 values: the real and imaginary parts of w^j,
+  w^2j and w^3j with w = exp(-+2 pi i / (4 l1)).
+*/
+template <typename T> struct Tables {
+  std::vector<uint32_t> swaps;
+  std::vector<T> twiddles;
+};
+
+template <typename T>
+const Tables<T> &tables(uint_fast8_t power, FFTDirection dir) {
+  static std::once_flag once[2][maxPower + 1];
+  static Tables<T> cache[2][maxPower + 1];
+  uint_fast8_t d = dir == FFTDirection::Forward ? 0 : 1;
+  std::call_once(once[d][power], [&]() {
+    Tables<T> &t = cache[d][power];
+    uint_fast32_t samples = uint_fast32_t(1) << power;
+    for (uint_fast32_t i = 0; i < samples; i++) {
+      uint_fast32_t j = 0;
+      for (uint_fast8_t b = 0; b < power; b++) {
+        j |= ((i >> b) & 1) << (power - 1 - b);
+      }
+      if (i < j) {
+        t.swaps.push_back(uint32_t(i));
+        t.swaps.push_back(uint32_t(j));
+      }
+    }
+    const long double pi = 3.141592653589793238462643383279502884L;
+    long double sign = dir == FFTDirection::Forward ? -1.0L : 1.0L;
+    for (uint_fast32_t l1 = (power & 1) ? 2 : 1; (l1 << 2) <= samples;
+         l1 <<= 2) {
+      size_t base = t.twiddles.size();
+      t.twiddles.resize(base + 6 * l1);
+      for (uint_fast32_t j = 0; j < l1; j++) {
+        for (uint_fast8_t m = 1; m <= 3; m++) {
+          long double angle = sign * 2 * pi * m * j / (4.0L * l1);
+          t.twiddles[base + (2 * m - 2) * l1 + j] = T(cosl(angle));
+          t.twiddles[base + (2 * m - 1) * l1 + j] = T(sinl(angle));
+        }
+      }
+    }
+  });
+  return cache[d][power];
+}
+
+// Bit-reversal permutation from the swap table. Like compute(), vImag is
+// only permuted when it may hold data: for reverse transforms or with
+// COMPLEX_INPUT.
+template <typename T>
+void permute(T *vReal, T *vImag, const std::vector<uint32_t> &swaps,
+             bool withImag) {
+  const uint32_t *s = swaps.data();
+  const uint32_t *end = s + swaps.size();
+  for (; s < end; s += 2) {
+    T t = vReal[s[0]];
+    vReal[s[0]] = vReal[s[1]];
+    vReal[s[1]] = t;
+  }
+  if (withImag) {
+    for (s = swaps.data(); s < end; s += 2) {
+      T t = vImag[s[0]];
+      vImag[s[0]] = vImag[s[1]];
+      vImag[s[1]] = t;
+    }
+  }
+}
+
+// One radix-4 pass over quarter size l1, ops::lanes butterflies at a time.
+// l1 must be a multiple of ops::lanes.
+template <class ops, bool forward, typename T>
+void pass(T *vReal, T *vImag, uint_fast16_t samples, uint_fast16_t l1,
+          const T *tw) {
+  typedef typename ops::V V;
+  uint_fast16_t l4 = l1 << 2;
+  for (uint_fast16_t i0 = 0; i0 < samples; i0 += l4) {
+    T *r0 = vReal + i0;
+    T *m0 = vImag + i0;
+    for (uint_fast16_t j = 0; j < l1; j += ops::lanes) {
+      V w1r = ops::load(tw + j);
+      V w1i = ops::load(tw + l1 + j);
+      V w2r = ops::load(tw + 2 * l1 + j);
+      V w2i = ops::load(tw + 3 * l1 + j);
+      V w3r = ops::load(tw + 4 * l1 + j);
+      V w3i = ops::load(tw + 5 * l1 + j);
+
+      V xr = ops::load(r0 + l1 + j);
+      V xi = ops::load(m0 + l1 + j);
+      V br = ops::sub(ops::mul(w2r, xr), ops::mul(w2i, xi));
+      V bi = ops::add(ops::mul(w2r, xi), ops::mul(w2i, xr));
+      xr = ops::load(r0 + 2 * l1 + j);
+      xi = ops::load(m0 + 2 * l1 + j);
+      V cr = ops::sub(ops::mul(w1r, xr), ops::mul(w1i, xi));
+      V ci = ops::add(ops::mul(w1r, xi), ops::mul(w1i, xr));
+      xr = ops::load(r0 + 3 * l1 + j);
+      xi = ops::load(m0 + 3 * l1 + j);
+      V dr = ops::sub(ops::mul(w3r, xr), ops::mul(w3i, xi));
+      V di = ops::add(ops::mul(w3r, xi), ops::mul(w3i, xr));
+
+      xr = ops::load(r0 + j);
+      xi = ops::load(m0 + j);
+      V ar = ops::add(xr, br);
+      V ai = ops::add(xi, bi);
+      V er = ops::sub(xr, br);
+      V ei = ops::sub(xi, bi);
+      V sr = ops::add(cr, dr);
+      V si = ops::add(ci, di);
+      // (c - d) turned by a quarter, clockwise when going forward
+      V qr = forward ? ops::sub(ci, di) : ops::sub(di, ci);
+      V qi = forward ? ops::sub(dr, cr) : ops::sub(cr, dr);
+
+      ops::store(r0 + j, ops::add(ar, sr));
+      ops::store(m0 + j, ops::add(ai, si));
+      ops::store(r0 + 2 * l1 + j, ops::sub(ar, sr));
+      ops::store(m0 + 2 * l1 + j, ops::sub(ai, si));
+      ops::store(r0 + l1 + j, ops::add(er, qr));
+      ops::store(m0 + l1 + j, ops::add(ei, qi));
+      ops::store(r0 + 3 * l1 + j, ops::sub(er, qr));
+      ops::store(m0 + 3 * l1 + j, ops::sub(ei, qi));
+    }
+  }
+}
+
+// The first pass has no rotations: plain radix-2 (odd power) or radix-4
+// butterflies on neighbouring values
+template <bool forward, typename T>
+void firstPass(T *vReal, T *vImag, uint_fast16_t samples, uint_fast8_t power) {
+  if (power & 1) {
+    for (uint_fast16_t i = 0; i < samples; i += 2) {
+      T tr = vReal[i + 1];
+      T ti = vImag[i + 1];
+      vReal[i + 1] = vReal[i] - tr;
+      vImag[i + 1] = vImag[i] - ti;
+      vReal[i] += tr;
+      vImag[i] += ti;
+    }
+    return;
+  }
+  for (uint_fast16_t i = 0; i < samples; i += 4) {
+    T ar = vReal[i] + vReal[i + 1];
+    T ai = vImag[i] + vImag[i + 1];
+    T er = vReal[i] - vReal[i + 1];
+    T ei = vImag[i] - vImag[i + 1];
+    T sr = vReal[i + 2] + vReal[i + 3];
+    T si = vImag[i + 2] + vImag[i + 3];
+    T dr = vReal[i + 2] - vReal[i + 3];
+    T di = vImag[i + 2] - vImag[i + 3];
+    T qr = forward ? di : -di;
+    T qi = forward ? -dr : dr;
+    vReal[i] = ar + sr;
+    vImag[i] = ai + si;
+    vReal[i + 2] = ar - sr;
+    vImag[i + 2] = ai - si;
+    vReal[i + 1] = er + qr;
+    vImag[i + 1] = ei + qi;
+    vReal[i + 3] = er - qr;
+    vImag[i + 3] = ei - qi;
+  }
+}
+
+template <bool forward, typename T>
+void butterflies(T *vReal, T *vImag, uint_fast16_t samples, uint_fast8_t power,
+                 const T *tw) {
+  if (power == 0) {
+    return;
+  }
+  firstPass<forward>(vReal, vImag, samples, power);
+  uint_fast16_t l1 = (power & 1) ? 2 : 4;
+  // Skip the first pass's twiddles when it was a radix-4 one
+  if (!(power & 1)) {
+    tw += 6;
+  }
+  for (; (uint_fast32_t(l1) << 2) <= samples; l1 <<= 2) {
+    if (l1 % Wide<T>::lanes == 0) {
+      pass<Wide<T>, forward>(vReal, vImag, samples, l1, tw);
+    } else if (l1 % Narrow<T>::lanes == 0) {
+      pass<Narrow<T>, forward>(vReal, vImag, samples, l1, tw);
+    } else {
+      pass<Scalar<T>, forward>(vReal, vImag, samples, l1, tw);
+    }
+    tw += 6 * l1;
+  }
+}
+
+} // namespace fft_vector
+
+#endif
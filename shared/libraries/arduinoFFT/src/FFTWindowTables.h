@@ -0,0 +1,151 @@
+/*
+
+        Compile-time window tables for ArduinoFFT
+
+        This program is free software: you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation, either version 3 of the License, or
+        (at your option) any later version.
+
+        This program is distributed in the hope that it will be useful,
+        but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+        GNU General Public License for more details.
+
+        You should have received a copy of the GNU General Public License
+        along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef FFTWindowTables_h /* Prevent loading library twice */
+#define FFTWindowTables_h
+
+#include "enumsFFT.h"
+#include <stdint.h>
+
+/*
+  FFTWindowTable<T, Window, N, Compensated>::factors holds the first N / 2
+  weighing factors of a window, the same values windowing() would compute,
+  evaluated by the compiler. Only the tables a sketch names are emitted, as
+  read-only data (flash on AVR when USE_AVR_PROGMEM is defined), so using
+  them needs no heap, no cos() calls and switching windows is free:
+
+    FFT.windowing(FFTWindowTable<float, FFTWindow::Hamming, 64>(),
+                  FFTDirection::Forward);
+
+  Only C++11 is required, so this works with the default AVR toolchain.
+*/
+
+#if defined(__AVR__) && defined(USE_AVR_PROGMEM)
+#define FFT_WINDOW_TABLE_ATTR PROGMEM
+#define FFT_WINDOW_TABLE_READ(p) pgm_read_float_near(p)
+#else
+#define FFT_WINDOW_TABLE_ATTR
+#define FFT_WINDOW_TABLE_READ(p) (*(p))
+#endif
+
+namespace fft_window_table {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// cos() for constant expressions: reduce to [-pi, pi], then a Taylor series
+// that reaches double precision on that range
+constexpr double cosTerms(double x2, double term, int n) {
+  return n > 44 ? term
+                : term + cosTerms(x2, -term * x2 / ((n + 1) * (n + 2)), n + 2);
+}
+constexpr double reduce(double x) {
+  return x > kPi ? reduce(x - 2 * kPi) : x;
+}
+constexpr double cosine(double x) {
+  return cosTerms(reduce(x) * reduce(x), 1.0, 0);
+}
+constexpr double absolute(double x) { return x < 0 ? -x : x; }
+
+// Mirrors the formulas in ArduinoFFT<T>::windowing()
+constexpr double weight(FFTWindow window, double i, double samplesMinusOne) {
+  return window == FFTWindow::Hamming
+             ? 0.54 - 0.46 * cosine(2 * kPi * i / samplesMinusOne)
+         : window == FFTWindow::Hann
+             ? 0.54 * (1.0 - cosine(2 * kPi * i / samplesMinusOne))
+         : window == FFTWindow::Triangle
+             ? 1.0 - 2.0 * absolute(i - samplesMinusOne / 2.0) /
+                         samplesMinusOne
+         : window == FFTWindow::Nuttall
+             ? 0.355768 - 0.487396 * cosine(2 * kPi * i / samplesMinusOne) +
+                   0.144232 * cosine(4 * kPi * i / samplesMinusOne) -
+                   0.012604 * cosine(6 * kPi * i / samplesMinusOne)
+         : window == FFTWindow::Blackman
+             ? 0.42323 - 0.49755 * cosine(2 * kPi * i / samplesMinusOne) +
+                   0.07922 * cosine(4 * kPi * i / samplesMinusOne)
+         : window == FFTWindow::Blackman_Nuttall
+             ? 0.3635819 - 0.4891775 * cosine(2 * kPi * i / samplesMinusOne) +
+                   0.1365995 * cosine(4 * kPi * i / samplesMinusOne) -
+                   0.0106411 * cosine(6 * kPi * i / samplesMinusOne)
+         : window == FFTWindow::Blackman_Harris
+             ? 0.35875 - 0.48829 * cosine(2 * kPi * i / samplesMinusOne) +
+                   0.14128 * cosine(4 * kPi * i / samplesMinusOne) -
+                   0.01168 * cosine(6 * kPi * i / samplesMinusOne)
+         : window == FFTWindow::Flat_top
+             ? 0.2810639 - 0.5208972 * cosine(2 * kPi * i / samplesMinusOne) +
+                   0.1980399 * cosine(4 * kPi * i / samplesMinusOne)
+         : window == FFTWindow::Welch
+             ? 1.0 - ((i - samplesMinusOne / 2.0) / (samplesMinusOne / 2.0)) *
+                         ((i - samplesMinusOne / 2.0) / (samplesMinusOne / 2.0))
+             : 1.0;
+}
+
+// Same values as ArduinoFFT<T>::_WindowCompensationFactors
+constexpr double compensation(FFTWindow window) {
+  return window == FFTWindow::Rectangle          ? 2.0
+         : window == FFTWindow::Hamming          ? 3.7098686556
+         : window == FFTWindow::Hann             ? 3.7109453796
+         : window == FFTWindow::Triangle         ? 4.0078372158
+         : window == FFTWindow::Nuttall          ? 5.6326344068
+         : window == FFTWindow::Blackman         ? 4.734694872
+         : window == FFTWindow::Blackman_Nuttall ? 5.511568079
+         : window == FFTWindow::Blackman_Harris  ? 5.5858125034
+         : window == FFTWindow::Flat_top         ? 7.1318078462
+         : window == FFTWindow::Welch            ? 3.0058785726
+                                                 : 1.0;
+}
+
+// Index pack 0..N-1, built in log(N) template depth
+template <unsigned... I> struct Indices {};
+
+template <class A, class B> struct Concat;
+template <unsigned... A, unsigned... B>
+struct Concat<Indices<A...>, Indices<B...>> {
+  typedef Indices<A..., (sizeof...(A) + B)...> type;
+};
+
+template <unsigned N> struct MakeIndices {
+  typedef typename Concat<typename MakeIndices<N / 2>::type,
+                          typename MakeIndices<N - N / 2>::type>::type type;
+};
+template <> struct MakeIndices<0> { typedef Indices<> type; };
+template <> struct MakeIndices<1> { typedef Indices<0> type; };
+
+} // namespace fft_window_table
+
+template <typename T, FFTWindow Window, uint16_t N, bool Compensated = false,
+          class Pack = typename fft_window_table::MakeIndices<N / 2>::type>
+struct FFTWindowTable;
+
+template <typename T, FFTWindow Window, uint16_t N, bool Compensated,
+          unsigned... I>
+struct FFTWindowTable<T, Window, N, Compensated,
+                      fft_window_table::Indices<I...>> {
+  static const uint16_t samples = N;
+  static const T factors[N / 2];
+};
+
+template <typename T, FFTWindow Window, uint16_t N, bool Compensated,
+          unsigned... I>
+const T FFTWindowTable<T, Window, N, Compensated,
+                       fft_window_table::Indices<I...>>::factors[N / 2]
+    FFT_WINDOW_TABLE_ATTR = {
+        T(fft_window_table::weight(Window, I, N - 1.0) *
+          (Compensated ? fft_window_table::compensation(Window) : 1.0))...};
+
+#endif
@@ -0,0 +1,229 @@
+/*
+
+        Streaming polyphase resampler for host builds of ArduinoFFT
+
+        This program is free software: you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation, either version 3 of the License, or
+        (at your option) any later version.
+
+        This program is distributed in the hope that it will be useful,
+        but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+        GNU General Public License for more details.
+
+        You should have received a copy of the GNU General Public License
+        along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "PolyphaseResampler.h"
+
+#ifdef FFT_HOST_BUILD
+
+#include "FFTVector.h"
+#include <algorithm>
+#include <string.h>
+
+// Kaiser window shape; about 80 dB stopband attenuation
+#define RESAMPLER_KAISER_BETA 8.0
+// Cutoff as a fraction of the lower of the two Nyquist frequencies
+#define RESAMPLER_CUTOFF 0.9
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+uint32_t greatestCommonDivisor(uint32_t a, uint32_t b) {
+  while (b) {
+    uint32_t r = a % b;
+    a = b;
+    b = r;
+  }
+  return a;
+}
+
+// Modified Bessel function of the first kind, order 0, for the Kaiser window
+double besselI0(double x) {
+  double sum = 1.0, term = 1.0;
+  for (int k = 1; k < 50 && term > 1e-12 * sum; k++) {
+    term *= (x / (2 * k)) * (x / (2 * k));
+    sum += term;
+  }
+  return sum;
+}
+
+} // namespace
+
+template <typename T>
+PolyphaseResampler<T>::PolyphaseResampler(uint32_t inputRate,
+                                          uint32_t outputRate,
+                                          uint_fast16_t tapsPerPhase) {
+  uint32_t divisor = greatestCommonDivisor(inputRate, outputRate);
+  _up = outputRate / divisor;
+  _down = inputRate / divisor;
+  // Whole vectors of the widest backend (8 floats) per phase
+  _taps = tapsPerPhase < 8 ? 8 : (tapsPerPhase + 7) & ~uint_fast16_t(7);
+
+  // Prototype low-pass at the up-sampled rate, gain up to make up for the
+  // zeros between input samples
+  const uint_fast32_t length = uint_fast32_t(_up) * _taps;
+  const double center = (length - 1) / 2.0;
+  const double cutoff = RESAMPLER_CUTOFF * 0.5 / std::max(_up, _down);
+  const double norm = besselI0(RESAMPLER_KAISER_BETA);
+  std::vector<double> prototype(length);
+  double sum = 0.0;
+  for (uint_fast32_t n = 0; n < length; n++) {
+    double x = n - center;
+    double w = 2 * kPi * cutoff * x;
+    double sinc = x == 0.0 ? 1.0 : sin(w) / w;
+    double r = x / center;
+    double kaiser =
+        besselI0(RESAMPLER_KAISER_BETA * sqrt(1.0 - r * r)) / norm;
+    prototype[n] = sinc * kaiser;
+    sum += prototype[n];
+  }
+
+  // Phase p uses taps p, p + up, p + 2 up...; stored newest input last
+  _coefficients.resize(length);
+  for (uint32_t p = 0; p < _up; p++) {
+    for (uint_fast16_t k = 0; k < _taps; k++) {
+      _coefficients[p * _taps + (_taps - 1 - k)] =
+          T(prototype[p + uint_fast32_t(_up) * k] * _up / sum);
+    }
+  }
+  reset();
+}
+
+// Group delay in output samples
+template <typename T> size_t PolyphaseResampler<T>::delay(void) const {
+  if (_up == _down) {
+    return 0;
+  }
+  return (size_t(_up) * _taps - 1) / (2 * size_t(_down));
+}
+
+template <typename T>
+size_t PolyphaseResampler<T>::maxOutput(size_t samples) const {
+  return samples * _up / _down + 1;
+}
+
+template <typename T>
+size_t PolyphaseResampler<T>::process(const T *input, size_t samples,
+                                      T *output) {
+  if (_up == _down) {
+    memcpy(output, input, samples * sizeof(T));
+    return samples;
+  }
+  _buffer.insert(_buffer.end(), input, input + samples);
+  return filter(output);
+}
+
+template <typename T>
+size_t PolyphaseResampler<T>::process(const int16_t *input, size_t samples,
+                                      int16_t *output) {
+  if (_up == _down) {
+    memcpy(output, input, samples * sizeof(int16_t));
+    return samples;
+  }
+  size_t start = _buffer.size();
+  _buffer.resize(start + samples);
+  T *buffer = &_buffer[start];
+  for (size_t i = 0; i < samples; i++) {
+    buffer[i] = input[i];
+  }
+  _scratch.resize(maxOutput(samples));
+  const T *scratch = _scratch.data();
+  size_t produced = filter(_scratch.data());
+  for (size_t i = 0; i < produced; i++) {
+    T v = std::min(std::max(scratch[i], T(-32768)), T(32767));
+    output[i] = int16_t(v + (v < 0 ? T(-0.5) : T(0.5)));
+  }
+  return produced;
+}
+
+// Forgets the history, e.g. before an unrelated stream
+template <typename T> void PolyphaseResampler<T>::reset(void) {
+  _buffer.assign(_taps - 1, T(0));
+  _base = _taps - 1;
+  _phase = 0;
+}
+
+// Four outputs at once: four independent sums keep the vector unit busy
+// instead of waiting on one chain of adds
+template <typename T>
+void PolyphaseResampler<T>::dot4(const T *const *x, const T *const *h,
+                                 T *output) const {
+  typedef fft_vector::Wide<T> ops;
+  typename ops::V sum[4] = {ops::splat(0), ops::splat(0), ops::splat(0),
+                            ops::splat(0)};
+  for (uint_fast16_t k = 0; k < _taps; k += ops::lanes) {
+    for (int j = 0; j < 4; j++) {
+      sum[j] = ops::add(sum[j], ops::mul(ops::load(x[j] + k),
+                                         ops::load(h[j] + k)));
+    }
+  }
+  T lanes[4][ops::lanes];
+  for (int j = 0; j < 4; j++) {
+    ops::store(lanes[j], sum[j]);
+  }
+  for (int j = 0; j < 4; j++) {
+    T total = 0;
+    for (int i = 0; i < ops::lanes; i++) {
+      total += lanes[j][i];
+    }
+    output[j] = total;
+  }
+}
+
+// Produces every output whose newest input sample is in _buffer, then keeps
+// the last _taps - 1 samples as history for the next call
+template <typename T> size_t PolyphaseResampler<T>::filter(T *output) {
+  const size_t keep = _taps - 1;
+  const size_t end = _buffer.size();
+  const T *x = _buffer.data();
+  const uint32_t baseStep = _down / _up;
+  const uint32_t phaseStep = _down % _up;
+  const T *inputs[4];
+  const T *phases[4];
+  size_t produced = 0;
+  int pending = 0;
+  while (_base < end) {
+    inputs[pending] = x + _base - keep;
+    phases[pending] = &_coefficients[_phase * _taps];
+    if (++pending == 4) {
+      dot4(inputs, phases, output + produced);
+      produced += 4;
+      pending = 0;
+    }
+    _base += baseStep;
+    _phase += phaseStep;
+    if (_phase >= _up) {
+      _phase -= _up;
+      _base++;
+    }
+  }
+  // The last few outputs repeat the final pointers to fill a group
+  if (pending) {
+    T tail[4];
+    for (int j = pending; j < 4; j++) {
+      inputs[j] = inputs[pending - 1];
+      phases[j] = phases[pending - 1];
+    }
+    dot4(inputs, phases, tail);
+    for (int j = 0; j < pending; j++) {
+      output[produced++] = tail[j];
+    }
+  }
+
+  size_t consumed = end - keep;
+  std::copy(_buffer.begin() + consumed, _buffer.end(), _buffer.begin());
+  _buffer.resize(keep);
+  _base -= consumed;
+  return produced;
+}
+
+template class PolyphaseResampler<double>;
+template class PolyphaseResampler<float>;
+
+#endif
@@ -0,0 +1,79 @@
+/*
+
+        Streaming polyphase resampler for host builds of ArduinoFFT
+
+        This program is free software: you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation, either version 3 of the License, or
+        (at your option) any later version.
+
+        This program is distributed in the hope that it will be useful,
+        but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+        GNU General Public License for more details.
+
+        You should have received a copy of the GNU General Public License
+        along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef PolyphaseResampler_h /* Prevent loading library twice */
+#define PolyphaseResampler_h
+
+#include "arduinoFFT.h"
+
+#ifdef FFT_HOST_BUILD
+
+#include <stddef.h>
+#include <vector>
+
+/*
+  Converts a stream between two sample rates, one chunk at a time.
+
+  The ratio is reduced to up / down (24000 -> 48000 is 2 / 1, 44100 -> 24000
+  is 80 / 147) and the signal is filtered by a Kaiser-windowed sinc low-pass
+  at 0.9 times the lower Nyquist frequency, split into up phases of
+  tapsPerPhase taps each. Every output sample is one dot product of a phase
+  with the latest input, run on the vector unit (see FFTVector.h) four
+  outputs at a time. The last
+  tapsPerPhase - 1 input samples are kept between calls, so consecutive
+  chunks join without the edge effects of resampling each chunk on its own.
+  The price is a fixed delay of tapsPerPhase / 2 input samples (delay()
+  reports it in output samples). Call reset() before an unrelated stream.
+
+  process() writes at most maxOutput(samples) values; over a whole stream
+  the output length is the input length times up / down. The int16_t
+  overload rounds and saturates.
+
+  Host builds only (FFT_HOST_BUILD).
+*/
+template <typename T> class PolyphaseResampler {
+public:
+  PolyphaseResampler(uint32_t inputRate, uint32_t outputRate,
+                     uint_fast16_t tapsPerPhase = 32);
+
+  size_t delay(void) const;
+  size_t maxOutput(size_t samples) const;
+
+  size_t process(const T *input, size_t samples, T *output);
+  size_t process(const int16_t *input, size_t samples, int16_t *output);
+
+  void reset(void);
+
+private:
+  /* Variables */
+  std::vector<T> _coefficients; // _up phases of _taps, reversed for dot()
+  std::vector<T> _buffer;       // _taps - 1 samples of history, then input
+  std::vector<T> _scratch;      // Output before int16_t conversion
+  uint32_t _up;
+  uint32_t _down;
+  uint_fast16_t _taps;
+  size_t _base = 0;    // Newest input sample of the next output, in _buffer
+  uint32_t _phase = 0; // Filter phase of the next output
+  /* Functions */
+  void dot4(const T *const *x, const T *const *h, T *output) const;
+  size_t filter(T *output);
+};
+
+#endif
+#endif
@@ -0,0 +1,84 @@
+/*
+
+        C interface to PolyphaseResampler, for use from other languages
+
+        This program is free software: you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation, either version 3 of the License, or
+        (at your option) any later version.
+
+        This program is distributed in the hope that it will be useful,
+        but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+        GNU General Public License for more details.
+
+        You should have received a copy of the GNU General Public License
+        along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "PolyphaseResamplerC.h"
+#include "PolyphaseResampler.h"
+
+#ifdef FFT_HOST_BUILD
+
+#include <new>
+
+struct fft_resampler {
+  PolyphaseResampler<float> resampler;
+
+  fft_resampler(uint32_t inputRate, uint32_t outputRate, uint32_t taps)
+      : resampler(inputRate, outputRate, taps) {}
+};
+
+extern "C" {
+
+fft_resampler *fft_resampler_create(uint32_t input_rate, uint32_t output_rate,
+                                    uint32_t taps_per_phase) {
+  if (!input_rate || !output_rate) {
+    return nullptr;
+  }
+  // The filter tables are std::vectors; no exception may leave extern "C"
+  try {
+    return new fft_resampler(input_rate, output_rate, taps_per_phase);
+  } catch (const std::bad_alloc &) {
+    return nullptr;
+  }
+}
+
+void fft_resampler_destroy(fft_resampler *resampler) { delete resampler; }
+
+size_t fft_resampler_delay(const fft_resampler *resampler) {
+  return resampler->resampler.delay();
+}
+
+size_t fft_resampler_max_output(const fft_resampler *resampler,
+                                size_t samples) {
+  return resampler->resampler.maxOutput(samples);
+}
+
+size_t fft_resampler_process_f32(fft_resampler *resampler, const float *input,
+                                 size_t samples, float *output) {
+  try {
+    return resampler->resampler.process(input, samples, output);
+  } catch (const std::bad_alloc &) {
+    return 0;
+  }
+}
+
+size_t fft_resampler_process_s16(fft_resampler *resampler,
+                                 const int16_t *input, size_t samples,
+                                 int16_t *output) {
+  try {
+    return resampler->resampler.process(input, samples, output);
+  } catch (const std::bad_alloc &) {
+    return 0;
+  }
+}
+
+void fft_resampler_reset(fft_resampler *resampler) {
+  resampler->resampler.reset();
+}
+}
+
+#endif
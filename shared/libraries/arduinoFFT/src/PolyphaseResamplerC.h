@@ -0,0 +1,67 @@
+/*
+
+        C interface to PolyphaseResampler, for use from other languages
+
+        This program is free software: you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation, either version 3 of the License, or
+        (at your option) any later version.
+
+        This program is distributed in the hope that it will be useful,
+        but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+        GNU General Public License for more details.
+
+        You should have received a copy of the GNU General Public License
+        along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef PolyphaseResamplerC_h /* Prevent loading library twice */
+#define PolyphaseResamplerC_h
+
+/*
+  Plain C functions around PolyphaseResampler<float>, so a shared library
+  built from PolyphaseResampler.cpp and PolyphaseResamplerC.cpp can be
+  loaded with ctypes or cffi. Buffers belong to the caller and are read and
+  written in place: process functions write at most
+  fft_resampler_max_output() samples and return how many they wrote.
+  Running out of memory never throws across this interface: create returns
+  NULL and the process functions return 0.
+
+  Build on the host, e.g.
+    g++ -std=c++11 -O3 -shared -fPIC -o libfftresampler.so \
+        PolyphaseResampler.cpp PolyphaseResamplerC.cpp
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct fft_resampler fft_resampler;
+
+/* Returns NULL when a rate is 0 or memory runs out */
+fft_resampler *fft_resampler_create(uint32_t input_rate, uint32_t output_rate,
+                                    uint32_t taps_per_phase);
+void fft_resampler_destroy(fft_resampler *resampler);
+
+size_t fft_resampler_delay(const fft_resampler *resampler);
+size_t fft_resampler_max_output(const fft_resampler *resampler,
+                                size_t samples);
+
+size_t fft_resampler_process_f32(fft_resampler *resampler, const float *input,
+                                 size_t samples, float *output);
+size_t fft_resampler_process_s16(fft_resampler *resampler,
+                                 const int16_t *input, size_t samples,
+                                 int16_t *output);
+
+void fft_resampler_reset(fft_resampler *resampler);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,120 @@
+/*
+
+        Fused spectral feature extraction for ArduinoFFT
+
+        This program is free software: you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation, either version 3 of the License, or
+        (at your option) any later version.
+
+        This program is distributed in the hope that it will be useful,
+        but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+        GNU General Public License for more details.
+
+        You should have received a copy of the GNU General Public License
+        along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "SpectralFeatures.h"
+
+template <typename T>
+SpectralFeatures<T>::SpectralFeatures(uint_fast16_t samples,
+                                      T samplingFrequency,
+                                      const uint_fast16_t *bandEdges,
+                                      uint_fast8_t bandCount,
+                                      T *previousMagnitude)
+    : _bandEdges(bandEdges), _previous(previousMagnitude),
+      _bins((samples >> 1) + 1), _fluxLow(1), _fluxHigh(samples >> 1),
+      _binWidth(samplingFrequency / samples), _bandCount(bandCount) {
+  reset();
+}
+
+// Forgets the previous spectrum; the next frame reports no flux
+template <typename T> void SpectralFeatures<T>::reset(void) {
+  _havePrevious = false;
+}
+
+// Restrict the flux to a bin range; previousMagnitude must cover highBin
+template <typename T>
+void SpectralFeatures<T>::setFluxBand(uint_fast16_t lowBin,
+                                      uint_fast16_t highBin) {
+  if (highBin >= _bins) {
+    highBin = _bins - 1;
+  }
+  _fluxLow = lowBin;
+  _fluxHigh = highBin < lowBin ? lowBin : highBin;
+}
+
+// Share of the energy (0 to 1) that lies below the reported roll-off
+template <typename T> void SpectralFeatures<T>::setRolloff(T fraction) {
+  _rolloff = fraction;
+}
+
+template <typename T>
+void SpectralFeatures<T>::analyze(T *vReal, const T *vImag,
+                                  SpectralFrame<T> &frame) {
+  for (uint_fast8_t b = 0; b < _bandCount; b++) {
+    frame.bands[b] = 0;
+  }
+  T energy = 0;
+  T moment = 0;
+  T flux = 0;
+  bool withFlux = _previous != nullptr;
+  uint_fast8_t band = 0;
+
+  vReal[0] = sq(vReal[0]) + sq(vImag[0]);
+  for (uint_fast16_t i = 1; i < _bins; i++) {
+    T power = sq(vReal[i]) + sq(vImag[i]);
+    vReal[i] = power;
+    energy += power;
+    moment += power * i;
+
+    // Bands are ascending, so the current one only ever moves forward
+    while (band < _bandCount && i >= _bandEdges[band + 1]) {
+      band++;
+    }
+    if (band < _bandCount && i >= _bandEdges[band]) {
+      frame.bands[band] += power;
+    }
+
+    if (withFlux && i >= _fluxLow && i <= _fluxHigh) {
+      T magnitude = sqrt(power);
+      T rise = magnitude - _previous[i];
+      if (_havePrevious && rise > 0) {
+        flux += rise;
+      }
+      _previous[i] = magnitude;
+    }
+  }
+  if (withFlux) {
+    _havePrevious = true;
+  }
+
+  frame.energy = energy;
+  frame.flux = flux;
+  if (energy <= 0) {
+    frame.centroid = 0;
+    frame.rolloff = 0;
+    return;
+  }
+  frame.centroid = moment / energy * _binWidth;
+
+  // The roll-off bin is where the running sum crosses the target share; the
+  // energies are still in cache from the sweep above
+  T target = energy * _rolloff;
+  T running = 0;
+  uint_fast16_t bin = 1;
+  while (bin < _bins - 1) {
+    running += vReal[bin];
+    if (running >= target) {
+      break;
+    }
+    bin++;
+  }
+  frame.rolloff = bin * _binWidth;
+}
+
+template class SpectralFeatures<double>;
+template class SpectralFeatures<float>;
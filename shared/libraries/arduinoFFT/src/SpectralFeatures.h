@@ -0,0 +1,71 @@
+/*
+
+        Fused spectral feature extraction for ArduinoFFT
+
+        This program is free software: you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation, either version 3 of the License, or
+        (at your option) any later version.
+
+        This program is distributed in the hope that it will be useful,
+        but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+        GNU General Public License for more details.
+
+        You should have received a copy of the GNU General Public License
+        along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef SpectralFeatures_h /* Prevent loading library twice */
+#define SpectralFeatures_h
+
+#include "arduinoFFT.h"
+
+template <typename T> struct SpectralFrame {
+  T *bands;   // Energy per band, bandCount values supplied by the caller
+  T energy;   // Total energy of bins 1 to samples / 2 (DC excluded)
+  T centroid; // Energy-weighted mean frequency in Hz
+  T rolloff;  // Frequency in Hz below which the roll-off share of energy lies
+  T flux;     // Half-wave rectified magnitude rise over the flux band
+};
+
+/*
+  Frame features from the complex spectrum in one sweep.
+
+  Call analyze() right after compute(), instead of complexToMagnitude()
+  followed by separate loops over vReal. Each bin is read once and turned
+  into its energy (re^2 + im^2), which feeds the band sums, the total and the
+  centroid without any sqrt(). Magnitudes, and so sqrt(), are only computed
+  for the flux band, and only when a previous-spectrum buffer was given.
+
+  Bands are given as bandCount + 1 ascending bin edges; band b covers bins
+  bandEdges[b] up to but excluding bandEdges[b + 1]. On return vReal holds
+  the energy of bins 0 to samples / 2, which the roll-off search reuses.
+*/
+template <typename T> class SpectralFeatures {
+public:
+  SpectralFeatures(uint_fast16_t samples, T samplingFrequency,
+                   const uint_fast16_t *bandEdges, uint_fast8_t bandCount,
+                   T *previousMagnitude = nullptr);
+
+  void analyze(T *vReal, const T *vImag, SpectralFrame<T> &frame);
+  void reset(void);
+
+  void setFluxBand(uint_fast16_t lowBin, uint_fast16_t highBin);
+  void setRolloff(T fraction);
+
+private:
+  /* Variables */
+  const uint_fast16_t *_bandEdges;
+  T *_previous;
+  uint_fast16_t _bins;
+  uint_fast16_t _fluxLow;
+  uint_fast16_t _fluxHigh;
+  T _binWidth;
+  T _rolloff = 0.85;
+  uint_fast8_t _bandCount;
+  bool _havePrevious;
+};
+
+#endif
@@ -0,0 +1,131 @@
+/*
+
+        Streaming short-time Fourier transform for ArduinoFFT
+
+        This program is free software: you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation, either version 3 of the License, or
+        (at your option) any later version.
+
+        This program is distributed in the hope that it will be useful,
+        but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+        GNU General Public License for more details.
+
+        You should have received a copy of the GNU General Public License
+        along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "StreamingSTFT.h"
+
+template <typename T>
+StreamingSTFT<T>::StreamingSTFT(T *ring, T *vReal, T *vImag, T *windowFactors,
+                                uint_fast16_t samples, uint_fast16_t hop,
+                                FFTWindow windowType)
+    : _ring(ring), _vReal(vReal), _vImag(vImag),
+      _windowFactors(windowFactors), _samples(samples), _mask(samples - 1),
+      _power(0), _hop(hop ? hop : 1), _windowType(windowType) {
+  if (_hop > samples) {
+    _hop = samples;
+  }
+  while ((uint_fast16_t(1) << _power) < samples) {
+    _power++;
+  }
+  reset();
+}
+
+template <typename T>
+void StreamingSTFT<T>::setCallback(FrameCallback callback, void *context) {
+  _callback = callback;
+  _context = context;
+}
+
+// Convert frames to magnitudes before the callback
+template <typename T>
+void StreamingSTFT<T>::setMagnitudeOutput(bool magnitude) {
+  _magnitude = magnitude;
+}
+
+// Adds one sample; returns the number of frames emitted (0 or 1)
+template <typename T> uint_fast16_t StreamingSTFT<T>::push(T sample) {
+  _ring[_head] = sample;
+  _head = (_head + 1) & _mask;
+  if (_filled < _samples) {
+    _filled++;
+  }
+  if (++_sinceFrame >= _hop && _filled == _samples) {
+    emitFrame();
+    return 1;
+  }
+  return 0;
+}
+
+// Adds a block of samples; returns the number of frames emitted
+template <typename T>
+uint_fast16_t StreamingSTFT<T>::push(const T *data, uint_fast16_t count) {
+  uint_fast16_t frames = 0;
+  for (uint_fast16_t i = 0; i < count; i++) {
+    frames += push(data[i]);
+  }
+  return frames;
+}
+
+template <typename T>
+uint_fast16_t StreamingSTFT<T>::push(const int16_t *data,
+                                     uint_fast16_t count) {
+  uint_fast16_t frames = 0;
+  for (uint_fast16_t i = 0; i < count; i++) {
+    frames += push(T(data[i]));
+  }
+  return frames;
+}
+
+// Forgets buffered samples; the next frame needs a full ring again
+template <typename T> void StreamingSTFT<T>::reset(void) {
+  _head = 0;
+  _filled = 0;
+  _sinceFrame = 0;
+  _frames = 0;
+}
+
+template <typename T> uint32_t StreamingSTFT<T>::frameCount(void) const {
+  return _frames;
+}
+
+template <typename T> uint_fast16_t StreamingSTFT<T>::hop(void) const {
+  return _hop;
+}
+
+template <typename T> void StreamingSTFT<T>::emitFrame(void) {
+  // Unroll the ring, oldest sample first; _head points at the oldest
+  uint_fast16_t tail = _samples - _head;
+  for (uint_fast16_t i = 0; i < tail; i++) {
+    _vReal[i] = _ring[_head + i];
+  }
+  for (uint_fast16_t i = 0; i < _head; i++) {
+    _vReal[tail + i] = _ring[i];
+  }
+  for (uint_fast16_t i = 0; i < _samples; i++) {
+    _vImag[i] = 0;
+  }
+
+  // The first frame fills the window cache, later frames reuse it
+  _fft.windowing(_vReal, _samples,
+                 _windowReady ? FFTWindow::Precompiled : _windowType,
+                 FFTDirection::Forward, _windowFactors);
+  _windowReady = true;
+  _fft.compute(_vReal, _vImag, _samples, _power, FFTDirection::Forward);
+  if (_magnitude) {
+    _fft.complexToMagnitude(_vReal, _vImag, _samples);
+  }
+
+  _sinceFrame = 0;
+  _frames++;
+  if (_callback) {
+    _callback(_vReal, _vImag, _samples, _context);
+  }
+}
+
+template class StreamingSTFT<double>;
+template class StreamingSTFT<float>;
@@ -0,0 +1,83 @@
+/*
+
+        Streaming short-time Fourier transform for ArduinoFFT
+
+        This program is free software: you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation, either version 3 of the License, or
+        (at your option) any later version.
+
+        This program is distributed in the hope that it will be useful,
+        but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+        GNU General Public License for more details.
+
+        You should have received a copy of the GNU General Public License
+        along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef StreamingSTFT_h /* Prevent loading library twice */
+#define StreamingSTFT_h
+
+#include "arduinoFFT.h"
+
+/*
+  Continuous, overlapping FFT frames from a sample stream.
+
+  Samples are pushed one at a time or in blocks into a ring buffer. Every
+  hop samples (once the ring is full) the latest frame is unrolled into
+  vReal, windowed with cached factors, transformed and handed to the
+  callback. A hop of samples / 2 gives 50% overlap, samples / 4 gives 75%.
+
+  All buffers are supplied by the caller: ring and vReal/vImag hold samples
+  values, windowFactors holds samples / 2. samples must be a power of 2.
+*/
+template <typename T> class StreamingSTFT {
+public:
+  // Called with the transformed frame; with magnitude output enabled vReal
+  // holds samples / 2 + 1 magnitudes and vImag is scratch
+  typedef void (*FrameCallback)(T *vReal, T *vImag, uint_fast16_t samples,
+                                void *context);
+
+  StreamingSTFT(T *ring, T *vReal, T *vImag, T *windowFactors,
+                uint_fast16_t samples, uint_fast16_t hop,
+                FFTWindow windowType = FFTWindow::Hann);
+
+  void setCallback(FrameCallback callback, void *context = nullptr);
+  void setMagnitudeOutput(bool magnitude);
+
+  uint_fast16_t push(T sample);
+  uint_fast16_t push(const T *data, uint_fast16_t count);
+  uint_fast16_t push(const int16_t *data, uint_fast16_t count);
+  void reset(void);
+
+  uint32_t frameCount(void) const;
+  uint_fast16_t hop(void) const;
+
+private:
+  /* Variables */
+  ArduinoFFT<T> _fft;
+  T *_ring;
+  T *_vReal;
+  T *_vImag;
+  T *_windowFactors;
+  uint_fast16_t _samples;
+  uint_fast16_t _mask;
+  uint_fast8_t _power;
+  uint_fast16_t _hop;
+  FFTWindow _windowType;
+  bool _windowReady = false;
+  bool _magnitude = false;
+  FrameCallback _callback = nullptr;
+  void *_context = nullptr;
+  /* Stream state */
+  uint_fast16_t _head;
+  uint_fast16_t _filled;
+  uint_fast16_t _sinceFrame;
+  uint32_t _frames;
+  /* Functions */
+  void emitFrame(void);
+};
+
+#endif
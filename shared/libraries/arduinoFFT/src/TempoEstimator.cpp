@@ -0,0 +1,140 @@
+/*
+
+        Autocorrelation tempo estimator for ArduinoFFT
+
+        This program is free software: you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation, either version 3 of the License, or
+        (at your option) any later version.
+
+        This program is distributed in the hope that it will be useful,
+        but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+        GNU General Public License for more details.
+
+        You should have received a copy of the GNU General Public License
+        along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "TempoEstimator.h"
+
+template <typename T>
+TempoEstimator<T>::TempoEstimator(T envelopeRate, T minBpm, T maxBpm)
+    : _envelopeRate(envelopeRate),
+      _minLag((uint_fast16_t)(envelopeRate * 60 / maxBpm)),
+      _maxLag((uint_fast16_t)(envelopeRate * 60 / minBpm + 1)) {
+  if (_minLag < 2) {
+    _minLag = 2;
+  }
+}
+
+// Replaces the first length values of vReal with their autocorrelation,
+// normalised so lag 0 is 1 and corrected for the shrinking overlap. samples
+// is the FFT size and must be a power of 2; with samples >= 2 * length no lag
+// wraps around. vImag is used as scratch space.
+template <typename T>
+void TempoEstimator<T>::autocorrelation(T *vReal, T *vImag,
+                                        uint_fast16_t length,
+                                        uint_fast16_t samples) const {
+  // Remove the mean so the constant part does not dominate every lag
+  T mean = 0;
+  for (uint_fast16_t i = 0; i < length; i++) {
+    mean += vReal[i];
+  }
+  mean /= length;
+  for (uint_fast16_t i = 0; i < samples; i++) {
+    vReal[i] = i < length ? vReal[i] - mean : 0;
+    vImag[i] = 0;
+  }
+
+  _fft.compute(vReal, vImag, samples, FFTDirection::Forward);
+  // Power spectrum, which is real and symmetric
+  for (uint_fast16_t i = 0; i < samples; i++) {
+    vReal[i] = sq(vReal[i]) + sq(vImag[i]);
+    vImag[i] = 0;
+  }
+  _fft.compute(vReal, vImag, samples, FFTDirection::Reverse);
+
+  T energy = vReal[0];
+  if (energy <= 0) {
+    for (uint_fast16_t i = 0; i < length; i++) {
+      vReal[i] = 0;
+    }
+    return;
+  }
+  for (uint_fast16_t lag = 0; lag < length; lag++) {
+    vReal[lag] = vReal[lag] * length / (energy * (length - lag));
+  }
+}
+
+// Fills candidates with up to maxCandidates tempos, strongest first, and
+// returns how many were found. vReal holds the envelope on entry and its
+// autocorrelation on return; both arrays must hold samples values.
+template <typename T>
+uint_fast8_t TempoEstimator<T>::estimate(T *vReal, T *vImag,
+                                         uint_fast16_t length,
+                                         uint_fast16_t samples,
+                                         TempoCandidate<T> *candidates,
+                                         uint_fast8_t maxCandidates) const {
+  // Keep every lag we look at (up to twice the longest) free of wrap-around
+  if (length + 2 * _maxLag > samples) {
+    length = samples > 2 * _maxLag ? samples - 2 * _maxLag : samples / 2;
+  }
+  if (length <= _minLag + 1 || maxCandidates == 0) {
+    return 0;
+  }
+  autocorrelation(vReal, vImag, length, samples);
+
+  uint_fast16_t lastLag = _maxLag < length - 1 ? _maxLag : length - 1;
+  uint_fast8_t found = 0;
+  for (uint_fast16_t lag = _minLag; lag < lastLag; lag++) {
+    T s = score(vReal, lag, length);
+    if (s <= 0 || s < score(vReal, lag - 1, length) ||
+        s <= score(vReal, lag + 1, length)) {
+      continue;
+    }
+
+    // Parabolic interpolation of the peak position, kept within the bin
+    T left = vReal[lag - 1];
+    T right = vReal[lag + 1];
+    T curvature = left - 2 * vReal[lag] + right;
+    T offset = curvature < 0 ? (left - right) / (2 * curvature) : 0;
+    if (offset > 0.5) {
+      offset = 0.5;
+    } else if (offset < -0.5) {
+      offset = -0.5;
+    }
+    T bpm = _envelopeRate * 60 / (lag + offset);
+
+    // Insert into the ranked list, dropping the weakest when full
+    uint_fast8_t slot = found;
+    while (slot > 0 && candidates[slot - 1].strength < s) {
+      if (slot < maxCandidates) {
+        candidates[slot] = candidates[slot - 1];
+      }
+      slot--;
+    }
+    if (slot < maxCandidates) {
+      candidates[slot].bpm = bpm;
+      candidates[slot].strength = s;
+      if (found < maxCandidates) {
+        found++;
+      }
+    }
+  }
+  return found;
+}
+
+template <typename T>
+T TempoEstimator<T>::score(const T *r, uint_fast16_t lag,
+                           uint_fast16_t length) const {
+  T s = r[lag];
+  if (2 * lag < length) {
+    s += r[2 * lag] / 2;
+  }
+  return s;
+}
+
+template class TempoEstimator<double>;
+template class TempoEstimator<float>;
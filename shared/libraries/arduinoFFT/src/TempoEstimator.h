@@ -0,0 +1,59 @@
+/*
+
+        Autocorrelation tempo estimator for ArduinoFFT
+
+        This program is free software: you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation, either version 3 of the License, or
+        (at your option) any later version.
+
+        This program is distributed in the hope that it will be useful,
+        but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+        GNU General Public License for more details.
+
+        You should have received a copy of the GNU General Public License
+        along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef TempoEstimator_h /* Prevent loading library twice */
+#define TempoEstimator_h
+
+#include "arduinoFFT.h"
+
+template <typename T> struct TempoCandidate {
+  T bpm;      // Tempo in beats per minute
+  T strength; // Normalised autocorrelation score, higher is better
+};
+
+/*
+  Offline tempo estimation from an onset-strength envelope (e.g. spectral
+  flux, one value per analysis hop).
+
+  The envelope's autocorrelation is computed in O(N log N) as
+  IFFT(|FFT(x)|^2) with ArduinoFFT's Forward and Reverse transforms. Peaks in
+  the allowed lag range become tempo candidates, ranked by their correlation
+  plus half the correlation at twice the lag (the bar-level repetition).
+*/
+template <typename T> class TempoEstimator {
+public:
+  TempoEstimator(T envelopeRate, T minBpm = 60, T maxBpm = 200);
+
+  void autocorrelation(T *vReal, T *vImag, uint_fast16_t length,
+                       uint_fast16_t samples) const;
+  uint_fast8_t estimate(T *vReal, T *vImag, uint_fast16_t length,
+                        uint_fast16_t samples, TempoCandidate<T> *candidates,
+                        uint_fast8_t maxCandidates) const;
+
+private:
+  /* Variables */
+  ArduinoFFT<T> _fft;
+  T _envelopeRate;
+  uint_fast16_t _minLag;
+  uint_fast16_t _maxLag;
+  /* Functions */
+  T score(const T *r, uint_fast16_t lag, uint_fast16_t length) const;
+};
+
+#endif
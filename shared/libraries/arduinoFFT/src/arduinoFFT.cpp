@@ -20,6 +20,24 @@
 */
 
 #include "arduinoFFT.h"
+#ifdef FFT_VECTOR_BACKEND
+#include "FFTVector.h"
+#endif
+#ifdef FFT_HOST_BUILD
+#include "FFTMixedRadix.h"
+#endif
+
+// Host builds scan for peaks with vector compares; define FFT_DISABLE_SIMD to
+// force the portable scan
+#ifndef FFT_DISABLE_SIMD
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#endif
 
 template <typename T> ArduinoFFT<T>::ArduinoFFT() {}
 
@@ -30,6 +48,7 @@ ArduinoFFT<T>::ArduinoFFT(T *vReal, T *vImag, uint_fast16_t samples,
       _vReal(vReal) {
   if (windowingFactors) {
     _precompiledWindowingFactors = new T[samples / 2];
+    _ownsWindowingFactors = true;
   }
   _power = exponent(samples);
 #ifdef FFT_SPEED_OVER_PRECISION
@@ -37,9 +56,23 @@ ArduinoFFT<T>::ArduinoFFT(T *vReal, T *vImag, uint_fast16_t samples,
 #endif
 }
 
+// Caches windowing factors in a caller-supplied buffer of samples / 2 values
+// (e.g. a static array) instead of the heap
+template <typename T>
+ArduinoFFT<T>::ArduinoFFT(T *vReal, T *vImag, uint_fast16_t samples,
+                          T samplingFrequency,
+                          FFTWindowBuffer<T> windowingFactors)
+    : _precompiledWindowingFactors(windowingFactors.factors), _samples(samples),
+      _samplingFrequency(samplingFrequency), _vImag(vImag), _vReal(vReal) {
+  _power = exponent(samples);
+#ifdef FFT_SPEED_OVER_PRECISION
+  _oneOverSamples = 1.0 / samples;
+#endif
+}
+
 template <typename T> ArduinoFFT<T>::~ArduinoFFT(void) {
   // Destructor
-  if (_precompiledWindowingFactors) {
+  if (_ownsWindowingFactors) {
     delete[] _precompiledWindowingFactors;
   }
 }
@@ -72,65 +105,39 @@ void ArduinoFFT<T>::compute(T *vReal, T *vImag, uint_fast16_t samples,
 template <typename T>
 void ArduinoFFT<T>::compute(T *vReal, T *vImag, uint_fast16_t samples,
                             uint_fast8_t power, FFTDirection dir) const {
+#ifdef FFT_HOST_BUILD
+  // Other lengths (e.g. 960 or 1200-sample chunks) go to a cached mixed-radix
+  // or Bluestein plan; boards still need a power of two
+  if (samples & (samples - 1)) {
+    FFTMixedRadix<T>::cached(samples).compute(vReal, vImag, dir);
+    return;
+  }
+#endif
 #ifdef FFT_SPEED_OVER_PRECISION
   T oneOverSamples = this->_oneOverSamples;
   if (!this->_oneOverSamples)
     oneOverSamples = 1.0 / samples;
 #endif
-  // Reverse bits
-  uint_fast16_t j = 0;
-  for (uint_fast16_t i = 0; i < (samples - 1); i++) {
-    if (i < j) {
-      swap(&vReal[i], &vReal[j]);
-      #ifdef COMPLEX_INPUT
-      swap(&vImag[i], &vImag[j]);
-      #endif
-      if (dir == FFTDirection::Reverse)
-        swap(&vImag[i], &vImag[j]);
-    }
-    uint_fast16_t k = (samples >> 1);
-
-    while (k <= j) {
-      j -= k;
-      k >>= 1;
-    }
-    j += k;
-  }
-  // Compute the FFT
-  T c1 = -1.0;
-  T c2 = 0.0;
-  uint_fast16_t l2 = 1;
-  for (uint_fast8_t l = 0; (l < power); l++) {
-    uint_fast16_t l1 = l2;
-    l2 <<= 1;
-    T u1 = 1.0;
-    T u2 = 0.0;
-    for (j = 0; j < l1; j++) {
-      for (uint_fast16_t i = j; i < samples; i += l2) {
-        uint_fast16_t i1 = i + l1;
-        T t1 = u1 * vReal[i1] - u2 * vImag[i1];
-        T t2 = u1 * vImag[i1] + u2 * vReal[i1];
-        vReal[i1] = vReal[i] - t1;
-        vImag[i1] = vImag[i] - t2;
-        vReal[i] += t1;
-        vImag[i] += t2;
-      }
-      T z = ((u1 * c1) - (u2 * c2));
-      u2 = ((u1 * c2) + (u2 * c1));
-      u1 = z;
+  if (this->_algorithm == FFTAlgorithm::Simd) {
+#ifdef FFT_VECTOR_BACKEND
+    if (power <= fft_vector::maxPower) {
+      // Reverses bits itself, from a cached table
+      butterfliesSimd(vReal, vImag, samples, power, dir);
+    } else {
+      reverseBits(vReal, vImag, samples, dir);
+      butterfliesRadix4(vReal, vImag, samples, power, dir);
     }
-
-#if defined(__AVR__) && defined(USE_AVR_PROGMEM)
-    c2 = pgm_read_float_near(&(_c2[l]));
-    c1 = pgm_read_float_near(&(_c1[l]));
 #else
-    T cTemp = 0.5 * c1;
-    c2 = sqrt_internal(0.5 - cTemp);
-    c1 = sqrt_internal(0.5 + cTemp);
+    reverseBits(vReal, vImag, samples, dir);
+    butterfliesRadix4(vReal, vImag, samples, power, dir);
 #endif
-
-    if (dir == FFTDirection::Forward) {
-      c2 = -c2;
+  } else {
+    reverseBits(vReal, vImag, samples, dir);
+    // Compute the FFT
+    if (this->_algorithm == FFTAlgorithm::Radix4) {
+      butterfliesRadix4(vReal, vImag, samples, power, dir);
+    } else {
+      butterfliesRadix2(vReal, vImag, samples, power, dir);
     }
   }
   // Scaling for reverse transform
@@ -147,6 +154,192 @@ void ArduinoFFT<T>::compute(T *vReal, T *vImag, uint_fast16_t samples,
   }
 }
 
+template <typename T>
+void ArduinoFFT<T>::computeBegin(FFTProgress<T> *progress,
+                                 FFTDirection dir) const {
+  computeBegin(progress, this->_samples, dir);
+}
+
+/*
+  Time-sliced transform for cooperative loops: computeBegin() sets up a
+  progress token and each computeStep() call does a bounded slice of the
+  work, so a sketch can service motors or other deadlines in between. The
+  slices are the bit reversal, each radix-2 butterfly stage and, for
+  FFTDirection::Reverse, the scaling. The result is identical to compute()
+  with FFTAlgorithm::Radix2. samples must be a power of two.
+*/
+template <typename T>
+void ArduinoFFT<T>::computeBegin(FFTProgress<T> *progress,
+                                 uint_fast16_t samples,
+                                 FFTDirection dir) const {
+  progress->dir = dir;
+  progress->samples = samples;
+  progress->power = exponent(samples);
+  progress->stage = 0;
+  progress->i = 0;
+  progress->j = 0;
+}
+
+template <typename T> void ArduinoFFT<T>::computePair(void) const {
+  computePair(this->_vReal, this->_vImag, this->_samples);
+}
+
+/*
+  Forward transforms of two real signals for the cost of one: the first in
+  vReal, the second in vImag. They are transformed as one complex signal
+  z = x + iy and separated by conjugate symmetry, X[k] = (Z[k] + Z*[N-k]) / 2
+  and Y[k] = (Z[k] - Z*[N-k]) / 2i. The spectra share the arrays:
+
+    bins 0 < k < samples / 2:  X[k] in slot k, Y[k] in slot samples - k
+    bins 0 and samples / 2:    X in vReal, Y in vImag (both are real)
+
+  pairToMagnitude() turns that into the magnitudes of X in vReal and of Y in
+  vImag, like complexToMagnitude().
+*/
+template <typename T>
+void ArduinoFFT<T>::computePair(T *vReal, T *vImag,
+                                uint_fast16_t samples) const {
+  // The forward kernels assume a real input; Reverse(conj(z)) = conj(Z) / N
+  // gives the complex transform without that assumption
+  for (uint_fast16_t i = 0; i < samples; i++) {
+    vImag[i] = -vImag[i];
+  }
+  compute(vReal, vImag, samples, FFTDirection::Reverse);
+
+  // With W = conj(Z) / N: X[k] = N/2 (W*[k] + W[N-k]),
+  // Y[k] = N/2 (-(Wi[k] + Wi[N-k]), Wr[N-k] - Wr[k])
+  T half = T(samples) / 2;
+  vImag[0] = -vImag[0] * samples;
+  vReal[0] *= samples;
+  uint_fast16_t k = 1;
+  for (; k < samples - k; k++) {
+    uint_fast16_t m = samples - k;
+    T ar = vReal[k], ai = vImag[k];
+    T br = vReal[m], bi = vImag[m];
+    vReal[k] = half * (ar + br);
+    vImag[k] = half * (bi - ai);
+    vReal[m] = -half * (ai + bi);
+    vImag[m] = half * (br - ar);
+  }
+  if (k == samples - k) {
+    vImag[k] = -vImag[k] * samples;
+    vReal[k] *= samples;
+  }
+}
+
+template <typename T>
+bool ArduinoFFT<T>::computeStep(FFTProgress<T> *progress,
+                                uint_fast16_t budget) const {
+  return computeStep(this->_vReal, this->_vImag, progress, budget);
+}
+
+// Does up to budget units of work, each one bit reversal index, butterfly or
+// scaled sample, or the rest of the current stage when budget is 0. Returns
+// true once the transform is complete.
+template <typename T>
+bool ArduinoFFT<T>::computeStep(T *vReal, T *vImag, FFTProgress<T> *progress,
+                                uint_fast16_t budget) const {
+  FFTProgress<T> &p = *progress;
+  const uint_fast16_t samples = p.samples;
+  const uint_fast8_t startStage = p.stage;
+  uint_fast16_t work = 0;
+  while (p.stage <= p.power + 1) {
+    if (budget ? work == budget : p.stage != startStage) {
+      break;
+    }
+    if (p.stage == 0) {
+      // One index of reverseBits()
+      if (p.i + 1 >= samples) {
+        p.stage = 1;
+        p.i = 0;
+        p.j = 0;
+        p.c1 = -1.0;
+        p.c2 = 0.0;
+        p.u1 = 1.0;
+        p.u2 = 0.0;
+        continue;
+      }
+      if (p.i < p.j) {
+        swap(&vReal[p.i], &vReal[p.j]);
+#ifdef COMPLEX_INPUT
+        swap(&vImag[p.i], &vImag[p.j]);
+#endif
+        if (p.dir == FFTDirection::Reverse)
+          swap(&vImag[p.i], &vImag[p.j]);
+      }
+      uint_fast16_t k = (samples >> 1);
+      while (k <= p.j) {
+        p.j -= k;
+        k >>= 1;
+      }
+      p.j += k;
+      p.i++;
+    } else if (p.stage <= p.power) {
+      // One butterfly of butterfliesRadix2(), in the same order
+      uint_fast16_t l1 = (uint_fast16_t)1 << (p.stage - 1);
+      uint_fast16_t i1 = p.i + l1;
+      T t1 = p.u1 * vReal[i1] - p.u2 * vImag[i1];
+      T t2 = p.u1 * vImag[i1] + p.u2 * vReal[i1];
+      vReal[i1] = vReal[p.i] - t1;
+      vImag[i1] = vImag[p.i] - t2;
+      vReal[p.i] += t1;
+      vImag[p.i] += t2;
+      p.i += l1 << 1;
+      if (p.i >= samples) {
+        T z = ((p.u1 * p.c1) - (p.u2 * p.c2));
+        p.u2 = ((p.u1 * p.c2) + (p.u2 * p.c1));
+        p.u1 = z;
+        p.i = ++p.j;
+        if (p.j == l1) {
+          twiddleStep(&p.c1, &p.c2, p.stage - 1, p.dir);
+          p.stage++;
+          p.i = 0;
+          p.j = 0;
+          p.u1 = 1.0;
+          p.u2 = 0.0;
+        }
+      }
+    } else {
+      // Scaling for reverse transform
+      if (p.dir == FFTDirection::Forward || p.i == samples) {
+        p.stage++;
+        continue;
+      }
+#ifdef FFT_SPEED_OVER_PRECISION
+      T oneOverSamples = this->_oneOverSamples;
+      if (!this->_oneOverSamples)
+        oneOverSamples = 1.0 / samples;
+      vReal[p.i] *= oneOverSamples;
+      vImag[p.i] *= oneOverSamples;
+#else
+      vReal[p.i] /= samples;
+      vImag[p.i] /= samples;
+#endif
+      p.i++;
+    }
+    work++;
+  }
+  return p.stage > p.power + 1;
+}
+
+// Fills samples / 2 weighing factors without touching any signal, the same
+// values windowing() records
+template <typename T>
+void ArduinoFFT<T>::computeWindowingFactors(T *windowingFactors,
+                                            uint_fast16_t samples,
+                                            FFTWindow windowType,
+                                            bool withCompensation) const {
+  T samplesMinusOne = (T(samples) - 1.0);
+  for (uint_fast16_t i = 0; i < (samples >> 1); i++) {
+    T weighingFactor = windowWeight(windowType, i, samplesMinusOne);
+    if (withCompensation) {
+      weighingFactor *=
+          _WindowCompensationFactors[static_cast<uint_fast8_t>(windowType)];
+    }
+    windowingFactors[i] = weighingFactor;
+  }
+}
+
 template <typename T> void ArduinoFFT<T>::dcRemoval(void) const {
   dcRemoval(this->_vReal, this->_samples);
 }
@@ -259,27 +452,135 @@ void ArduinoFFT<T>::majorPeakParabola(T *vData, uint_fast16_t samples,
   }
 }
 
+template <typename T>
+uint_fast8_t ArduinoFFT<T>::majorPeaks(FFTPeak<T> *peaks,
+                                       uint_fast8_t count) const {
+  return majorPeaks(this->_vReal, this->_samples, this->_samplingFrequency,
+                    peaks, count);
+}
+
+// Finds the count strongest local maxima of a magnitude spectrum in one pass
+// and returns how many were found. peaks is filled strongest first, each
+// refined by parabolic interpolation like majorPeakParabola(). While
+// scanning, peaks is a min-heap of the best candidates, so bins below the
+// weakest of them are rejected with a single compare.
+template <typename T>
+uint_fast8_t ArduinoFFT<T>::majorPeaks(T *vData, uint_fast16_t samples,
+                                       T samplingFrequency, FFTPeak<T> *peaks,
+                                       uint_fast8_t count) const {
+  if (count == 0 || samples < 4) {
+    return 0;
+  }
+  uint_fast8_t found = 0;
+  T floor = 0;
+  // Bin 0 holds the DC offset and the last bin has no right neighbour
+  uint_fast16_t i = 1;
+  uint_fast16_t end = samples >> 1;
+  for (; i + FFT_PEAK_BLOCK <= end; i += FFT_PEAK_BLOCK) {
+    uint_fast8_t mask = peakMask(&vData[i], floor);
+    while (mask) {
+      uint_fast8_t lane = 0;
+      while (!(mask & (1 << lane))) {
+        lane++;
+      }
+      mask &= mask - 1;
+      pushPeak(peaks, count, &found, i + lane, vData[i + lane], &floor);
+    }
+  }
+  for (; i < end; i++) {
+    if (vData[i] > floor && vData[i - 1] < vData[i] &&
+        vData[i] > vData[i + 1]) {
+      pushPeak(peaks, count, &found, i, vData[i], &floor);
+    }
+  }
+
+  // Interpolate the winners, then order them strongest first
+  for (uint_fast8_t p = 0; p < found; p++) {
+    uint_fast16_t bin = peaks[p].bin;
+    T left = vData[bin - 1];
+    T right = vData[bin + 1];
+    T curvature = left - 2 * vData[bin] + right;
+    T delta = curvature < 0 ? 0.5 * (left - right) / curvature : 0;
+    peaks[p].frequency = ((bin + delta) * samplingFrequency) / samples;
+    peaks[p].magnitude = vData[bin] - 0.25 * (left - right) * delta;
+  }
+  for (uint_fast8_t p = 1; p < found; p++) {
+    FFTPeak<T> peak = peaks[p];
+    uint_fast8_t q = p;
+    while (q > 0 && peaks[q - 1].magnitude < peak.magnitude) {
+      peaks[q] = peaks[q - 1];
+      q--;
+    }
+    peaks[q] = peak;
+  }
+  return found;
+}
+
+template <typename T> void ArduinoFFT<T>::pairToMagnitude(void) const {
+  pairToMagnitude(this->_vReal, this->_vImag, this->_samples);
+}
+
+// After computePair(): magnitudes of the first signal's bins 0 to
+// samples / 2 in vReal, and of the second signal's in vImag
+template <typename T>
+void ArduinoFFT<T>::pairToMagnitude(T *vReal, T *vImag,
+                                    uint_fast16_t samples) const {
+  // Bins 0 and samples / 2 are real
+  vReal[0] = vReal[0] < 0 ? -vReal[0] : vReal[0];
+  vImag[0] = vImag[0] < 0 ? -vImag[0] : vImag[0];
+  uint_fast16_t k = 1;
+  for (; k < samples - k; k++) {
+    T x = sqrt_internal(sq(vReal[k]) + sq(vImag[k]));
+    T y = sqrt_internal(sq(vReal[samples - k]) + sq(vImag[samples - k]));
+    vReal[k] = x;
+    vImag[k] = y;
+  }
+  if (k == samples - k) {
+    vReal[k] = vReal[k] < 0 ? -vReal[k] : vReal[k];
+    vImag[k] = vImag[k] < 0 ? -vImag[k] : vImag[k];
+  }
+}
+
 template <typename T> uint8_t ArduinoFFT<T>::revision(void) {
   return (FFT_LIB_REV);
 }
 
+// Selects the butterfly kernel used by compute(); the output is the same
+template <typename T>
+void ArduinoFFT<T>::setAlgorithm(FFTAlgorithm algorithm) {
+  _algorithm = algorithm;
+}
+
 // Replace the data array pointers
 template <typename T>
 void ArduinoFFT<T>::setArrays(T *vReal, T *vImag, uint_fast16_t samples) {
   _vReal = vReal;
   _vImag = vImag;
-  if (samples) {
+  if (samples && samples != _samples) {
     _samples = samples;
 #ifdef FFT_SPEED_OVER_PRECISION
     _oneOverSamples = 1.0 / samples;
 #endif
-    if (_precompiledWindowingFactors) {
+    // Cached factors no longer match; only a buffer we own is resized
+    _isPrecompiled = false;
+    if (_ownsWindowingFactors) {
       delete[] _precompiledWindowingFactors;
+      _precompiledWindowingFactors = new T[samples / 2];
     }
-    _precompiledWindowingFactors = new T[samples / 2];
   }
 }
 
+// Uses a caller-supplied buffer of samples / 2 values for the windowing cache
+template <typename T>
+void ArduinoFFT<T>::setWindowingFactors(T *windowingFactors) {
+  if (_ownsWindowingFactors) {
+    delete[] _precompiledWindowingFactors;
+    _ownsWindowingFactors = false;
+  }
+  _precompiledWindowingFactors = windowingFactors;
+  _isPrecompiled = false;
+}
+
 template <typename T>
 void ArduinoFFT<T>::windowing(FFTWindow windowType, FFTDirection dir,
                               bool withCompensation) {
@@ -312,21 +613,7 @@ void ArduinoFFT<T>::windowing(T *vData, uint_fast16_t samples,
   // Weighing factors are computed once before multiple use of FFT
   // The weighing function is symmetric; half the weighs are recorded
   if (windowingFactors != nullptr && windowType == FFTWindow::Precompiled) {
-    for (uint_fast16_t i = 0; i < (samples >> 1); i++) {
-      if (dir == FFTDirection::Forward) {
-        vData[i] *= windowingFactors[i];
-        vData[samples - (i + 1)] *= windowingFactors[i];
-      } else {
-#ifdef FFT_SPEED_OVER_PRECISION
-        T inverse = 1.0 / windowingFactors[i];
-        vData[i] *= inverse;
-        vData[samples - (i + 1)] *= inverse;
-#else
-        vData[i] /= windowingFactors[i];
-        vData[samples - (i + 1)] /= windowingFactors[i];
-#endif
-      }
-    }
+    windowing(vData, samples, static_cast<const T *>(windowingFactors), dir);
   } else {
     T samplesMinusOne = (T(samples) - 1.0);
     T compensationFactor;
@@ -335,60 +622,7 @@ void ArduinoFFT<T>::windowing(T *vData, uint_fast16_t samples,
           _WindowCompensationFactors[static_cast<uint_fast8_t>(windowType)];
     }
     for (uint_fast16_t i = 0; i < (samples >> 1); i++) {
-      T indexMinusOne = T(i);
-      T ratio = (indexMinusOne / samplesMinusOne);
-      T weighingFactor = 1.0;
-      // Compute and record weighting factor
-      switch (windowType) {
-      case FFTWindow::Hamming: // hamming
-        weighingFactor = 0.54 - (0.46 * cos(twoPi * ratio));
-        break;
-      case FFTWindow::Hann: // hann
-        weighingFactor = 0.54 * (1.0 - cos(twoPi * ratio));
-        break;
-      case FFTWindow::Triangle: // triangle (Bartlett)
-#if defined(ESP8266) || defined(ESP32)
-        weighingFactor =
-            1.0 - ((2.0 * fabs(indexMinusOne - (samplesMinusOne / 2.0))) /
-                   samplesMinusOne);
-#else
-        weighingFactor =
-            1.0 - ((2.0 * abs(indexMinusOne - (samplesMinusOne / 2.0))) /
-                   samplesMinusOne);
-#endif
-        break;
-      case FFTWindow::Nuttall: // nuttall
-        weighingFactor = 0.355768 - (0.487396 * (cos(twoPi * ratio))) +
-                         (0.144232 * (cos(fourPi * ratio))) -
-                         (0.012604 * (cos(sixPi * ratio)));
-        break;
-      case FFTWindow::Blackman: // blackman
-        weighingFactor = 0.42323 - (0.49755 * (cos(twoPi * ratio))) +
-                         (0.07922 * (cos(fourPi * ratio)));
-        break;
-      case FFTWindow::Blackman_Nuttall: // blackman nuttall
-        weighingFactor = 0.3635819 - (0.4891775 * (cos(twoPi * ratio))) +
-                         (0.1365995 * (cos(fourPi * ratio))) -
-                         (0.0106411 * (cos(sixPi * ratio)));
-        break;
-      case FFTWindow::Blackman_Harris: // blackman harris
-        weighingFactor = 0.35875 - (0.48829 * (cos(twoPi * ratio))) +
-                         (0.14128 * (cos(fourPi * ratio))) -
-                         (0.01168 * (cos(sixPi * ratio)));
-        break;
-      case FFTWindow::Flat_top: // flat top
-        weighingFactor = 0.2810639 - (0.5208972 * cos(twoPi * ratio)) +
-                         (0.1980399 * cos(fourPi * ratio));
-        break;
-      case FFTWindow::Welch: // welch
-        weighingFactor = 1.0 - sq((indexMinusOne - samplesMinusOne / 2.0) /
-                                  (samplesMinusOne / 2.0));
-        break;
-      default:
-        // This is Rectangle windowing which doesn't do anything
-        // and Precompiled which shouldn't be selected
-        break;
-      }
+      T weighingFactor = windowWeight(windowType, i, samplesMinusOne);
       if (withCompensation) {
         weighingFactor *= compensationFactor;
       }
@@ -412,7 +646,217 @@ void ArduinoFFT<T>::windowing(T *vData, uint_fast16_t samples,
   }
 }
 
-// Private functions
+// Applies samples / 2 factors from computeWindowingFactors() or an earlier
+// windowing() call. Touches nothing but vData, so it is safe to call on an
+// object shared between threads or with an ISR.
+template <typename T>
+void ArduinoFFT<T>::windowing(T *vData, uint_fast16_t samples,
+                              const T *windowingFactors,
+                              FFTDirection dir) const {
+  for (uint_fast16_t i = 0; i < (samples >> 1); i++) {
+    if (dir == FFTDirection::Forward) {
+      vData[i] *= windowingFactors[i];
+      vData[samples - (i + 1)] *= windowingFactors[i];
+    } else {
+#ifdef FFT_SPEED_OVER_PRECISION
+      T inverse = 1.0 / windowingFactors[i];
+      vData[i] *= inverse;
+      vData[samples - (i + 1)] *= inverse;
+#else
+      vData[i] /= windowingFactors[i];
+      vData[samples - (i + 1)] /= windowingFactors[i];
+#endif
+    }
+  }
+}
+
+template <typename T>
+void ArduinoFFT<T>::reverseBits(T *vReal, T *vImag, uint_fast16_t samples,
+                                FFTDirection dir) const {
+  uint_fast16_t j = 0;
+  for (uint_fast16_t i = 0; i < (samples - 1); i++) {
+    if (i < j) {
+      swap(&vReal[i], &vReal[j]);
+      #ifdef COMPLEX_INPUT
+      swap(&vImag[i], &vImag[j]);
+      #endif
+      if (dir == FFTDirection::Reverse)
+        swap(&vImag[i], &vImag[j]);
+    }
+    uint_fast16_t k = (samples >> 1);
+
+    while (k <= j) {
+      j -= k;
+      k >>= 1;
+    }
+    j += k;
+  }
+}
+
+
+template <typename T>
+void ArduinoFFT<T>::butterfliesRadix2(T *vReal, T *vImag,
+                                      uint_fast16_t samples,
+                                      uint_fast8_t power,
+                                      FFTDirection dir) const {
+  T c1 = -1.0;
+  T c2 = 0.0;
+  uint_fast16_t j;
+  uint_fast16_t l2 = 1;
+  for (uint_fast8_t l = 0; (l < power); l++) {
+    uint_fast16_t l1 = l2;
+    l2 <<= 1;
+    T u1 = 1.0;
+    T u2 = 0.0;
+    for (j = 0; j < l1; j++) {
+      for (uint_fast16_t i = j; i < samples; i += l2) {
+        uint_fast16_t i1 = i + l1;
+        T t1 = u1 * vReal[i1] - u2 * vImag[i1];
+        T t2 = u1 * vImag[i1] + u2 * vReal[i1];
+        vReal[i1] = vReal[i] - t1;
+        vImag[i1] = vImag[i] - t2;
+        vReal[i] += t1;
+        vImag[i] += t2;
+      }
+      T z = ((u1 * c1) - (u2 * c2));
+      u2 = ((u1 * c2) + (u2 * c1));
+      u1 = z;
+    }
+    twiddleStep(&c1, &c2, l, dir);
+  }
+}
+
+// Each radix-4 butterfly does the work of two radix-2 stages with three
+// complex rotations instead of four. An odd power starts with one radix-2
+// stage, which needs no rotation.
+template <typename T>
+void ArduinoFFT<T>::butterfliesRadix4(T *vReal, T *vImag,
+                                      uint_fast16_t samples,
+                                      uint_fast8_t power,
+                                      FFTDirection dir) const {
+  uint_fast8_t l = 0;
+  uint_fast16_t l1 = 1;
+  if (power & 1) {
+    for (uint_fast16_t i = 0; i < samples; i += 2) {
+      T t1 = vReal[i + 1];
+      T t2 = vImag[i + 1];
+      vReal[i + 1] = vReal[i] - t1;
+      vImag[i + 1] = vImag[i] - t2;
+      vReal[i] += t1;
+      vImag[i] += t2;
+    }
+    l = 1;
+    l1 = 2;
+  }
+  // c1 and c2 hold cos and sin of pi / 2^k, halved as k grows like in the
+  // radix-2 loop. _c1[k] and _c2[k] hold the values for pi / 2^(k + 1).
+  T c1 = -1.0;
+  T c2 = 0.0;
+#if !(defined(__AVR__) && defined(USE_AVR_PROGMEM))
+  uint_fast8_t k = 0;
+#endif
+  // Forward transforms rotate clockwise
+  T sign = dir == FFTDirection::Forward ? -1.0 : 1.0;
+
+  for (; l + 1 < power; l += 2) {
+    // This pass spans stages l and l + 1; its base angle is pi / 2^(l + 1)
+#if defined(__AVR__) && defined(USE_AVR_PROGMEM)
+    c1 = pgm_read_float_near(&(_c1[l]));
+    c2 = pgm_read_float_near(&(_c2[l]));
+#else
+    for (; k <= l; k++) {
+      T cTemp = 0.5 * c1;
+      c2 = sqrt_internal(0.5 - cTemp);
+      c1 = sqrt_internal(0.5 + cTemp);
+    }
+#endif
+    T s2 = sign * c2;
+    uint_fast16_t l4 = l1 << 2;
+    T u1 = 1.0;
+    T u2 = 0.0;
+    for (uint_fast16_t j = 0; j < l1; j++) {
+      // Rotations by w, w^2 and w^3
+      T v1 = u1 * u1 - u2 * u2;
+      T v2 = 2 * u1 * u2;
+      T w1 = v1 * u1 - v2 * u2;
+      T w2 = v1 * u2 + v2 * u1;
+      for (uint_fast16_t i = j; i < samples; i += l4) {
+        uint_fast16_t i1 = i + l1;
+        uint_fast16_t i2 = i1 + l1;
+        uint_fast16_t i3 = i2 + l1;
+        T br = v1 * vReal[i1] - v2 * vImag[i1];
+        T bi = v1 * vImag[i1] + v2 * vReal[i1];
+        T cr = u1 * vReal[i2] - u2 * vImag[i2];
+        T ci = u1 * vImag[i2] + u2 * vReal[i2];
+        T dr = w1 * vReal[i3] - w2 * vImag[i3];
+        T di = w1 * vImag[i3] + w2 * vReal[i3];
+        T ar = vReal[i] + br;
+        T ai = vImag[i] + bi;
+        T er = vReal[i] - br;
+        T ei = vImag[i] - bi;
+        T sr = cr + dr;
+        T si = ci + di;
+        // (c - d) turned by a quarter, clockwise when going forward
+        T qr = -sign * (ci - di);
+        T qi = sign * (cr - dr);
+        vReal[i] = ar + sr;
+        vImag[i] = ai + si;
+        vReal[i2] = ar - sr;
+        vImag[i2] = ai - si;
+        vReal[i1] = er + qr;
+        vImag[i1] = ei + qi;
+        vReal[i3] = er - qr;
+        vImag[i3] = ei - qi;
+      }
+      T z = u1 * c1 - u2 * s2;
+      u2 = u1 * s2 + u2 * c1;
+      u1 = z;
+    }
+    l1 = l4;
+  }
+}
+
+#ifdef FFT_VECTOR_BACKEND
+template <typename T>
+void ArduinoFFT<T>::butterfliesSimd(T *vReal, T *vImag, uint_fast16_t samples,
+                                    uint_fast8_t power,
+                                    FFTDirection dir) const {
+  const fft_vector::Tables<T> &tables = fft_vector::tables<T>(power, dir);
+#ifdef COMPLEX_INPUT
+  bool withImag = true;
+#else
+  bool withImag = dir == FFTDirection::Reverse;
+#endif
+  fft_vector::permute(vReal, vImag, tables.swaps, withImag);
+  const T *tw = tables.twiddles.data();
+  if (dir == FFTDirection::Forward) {
+    fft_vector::butterflies<true>(vReal, vImag, samples, power, tw);
+  } else {
+    fft_vector::butterflies<false>(vReal, vImag, samples, power, tw);
+  }
+}
+#endif
+
+template <typename T>
+void ArduinoFFT<T>::applyWindowTable(T *vData, uint_fast16_t samples,
+                                     const T *table, FFTDirection dir) const {
+  for (uint_fast16_t i = 0; i < (samples >> 1); i++) {
+    T weighingFactor = FFT_WINDOW_TABLE_READ(&table[i]);
+    if (dir == FFTDirection::Forward) {
+      vData[i] *= weighingFactor;
+      vData[samples - (i + 1)] *= weighingFactor;
+    } else {
+#ifdef FFT_SPEED_OVER_PRECISION
+      T inverse = 1.0 / weighingFactor;
+      vData[i] *= inverse;
+      vData[samples - (i + 1)] *= inverse;
+#else
+      vData[i] /= weighingFactor;
+      vData[samples - (i + 1)] /= weighingFactor;
+#endif
+    }
+  }
+}
 
 template <typename T>
 uint_fast8_t ArduinoFFT<T>::exponent(uint_fast16_t value) const {
@@ -442,6 +886,158 @@ void ArduinoFFT<T>::findMaxY(T *vData, uint_fast16_t length, T *maxY,
   *maxY = vData[*index];
 }
 
+// Bit n is set when vData[n] is a local maximum above floor; vData[-1] and
+// vData[FFT_PEAK_BLOCK] must be readable
+template <typename T>
+uint_fast8_t ArduinoFFT<T>::peakMask(const T *vData, T floor) const {
+  uint_fast8_t mask = 0;
+  for (uint_fast8_t n = 0; n < FFT_PEAK_BLOCK; n++) {
+    if (vData[n] > floor && vData[n - 1] < vData[n] &&
+        vData[n] > vData[n + 1]) {
+      mask |= 1 << n;
+    }
+  }
+  return mask;
+}
+
+#ifndef FFT_DISABLE_SIMD
+#if defined(__AVX__)
+template <>
+uint_fast8_t ArduinoFFT<float>::peakMask(const float *vData,
+                                         float floor) const {
+  __m256 c = _mm256_loadu_ps(vData);
+  __m256 up = _mm256_cmp_ps(c, _mm256_loadu_ps(vData - 1), _CMP_GT_OQ);
+  __m256 down = _mm256_cmp_ps(c, _mm256_loadu_ps(vData + 1), _CMP_GT_OQ);
+  __m256 high = _mm256_cmp_ps(c, _mm256_set1_ps(floor), _CMP_GT_OQ);
+  return _mm256_movemask_ps(_mm256_and_ps(_mm256_and_ps(up, down), high));
+}
+
+template <>
+uint_fast8_t ArduinoFFT<double>::peakMask(const double *vData,
+                                          double floor) const {
+  __m256d f = _mm256_set1_pd(floor);
+  uint_fast8_t mask = 0;
+  for (uint_fast8_t n = 0; n < FFT_PEAK_BLOCK; n += 4) {
+    __m256d c = _mm256_loadu_pd(vData + n);
+    __m256d up = _mm256_cmp_pd(c, _mm256_loadu_pd(vData + n - 1), _CMP_GT_OQ);
+    __m256d down =
+        _mm256_cmp_pd(c, _mm256_loadu_pd(vData + n + 1), _CMP_GT_OQ);
+    __m256d high = _mm256_cmp_pd(c, f, _CMP_GT_OQ);
+    mask |= _mm256_movemask_pd(_mm256_and_pd(_mm256_and_pd(up, down), high))
+            << n;
+  }
+  return mask;
+}
+#elif defined(__SSE2__)
+template <>
+uint_fast8_t ArduinoFFT<float>::peakMask(const float *vData,
+                                         float floor) const {
+  __m128 f = _mm_set1_ps(floor);
+  uint_fast8_t mask = 0;
+  for (uint_fast8_t n = 0; n < FFT_PEAK_BLOCK; n += 4) {
+    __m128 c = _mm_loadu_ps(vData + n);
+    __m128 up = _mm_cmpgt_ps(c, _mm_loadu_ps(vData + n - 1));
+    __m128 down = _mm_cmpgt_ps(c, _mm_loadu_ps(vData + n + 1));
+    __m128 high = _mm_cmpgt_ps(c, f);
+    mask |= _mm_movemask_ps(_mm_and_ps(_mm_and_ps(up, down), high)) << n;
+  }
+  return mask;
+}
+
+template <>
+uint_fast8_t ArduinoFFT<double>::peakMask(const double *vData,
+                                          double floor) const {
+  __m128d f = _mm_set1_pd(floor);
+  uint_fast8_t mask = 0;
+  for (uint_fast8_t n = 0; n < FFT_PEAK_BLOCK; n += 2) {
+    __m128d c = _mm_loadu_pd(vData + n);
+    __m128d up = _mm_cmpgt_pd(c, _mm_loadu_pd(vData + n - 1));
+    __m128d down = _mm_cmpgt_pd(c, _mm_loadu_pd(vData + n + 1));
+    __m128d high = _mm_cmpgt_pd(c, f);
+    mask |= _mm_movemask_pd(_mm_and_pd(_mm_and_pd(up, down), high)) << n;
+  }
+  return mask;
+}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+template <>
+uint_fast8_t ArduinoFFT<float>::peakMask(const float *vData,
+                                         float floor) const {
+  static const uint32_t bits[4] = {1, 2, 4, 8};
+  uint32x4_t weights = vld1q_u32(bits);
+  float32x4_t f = vdupq_n_f32(floor);
+  uint_fast8_t mask = 0;
+  for (uint_fast8_t n = 0; n < FFT_PEAK_BLOCK; n += 4) {
+    float32x4_t c = vld1q_f32(vData + n);
+    uint32x4_t up = vcgtq_f32(c, vld1q_f32(vData + n - 1));
+    uint32x4_t down = vcgtq_f32(c, vld1q_f32(vData + n + 1));
+    uint32x4_t peak = vandq_u32(vandq_u32(up, down), vcgtq_f32(c, f));
+    mask |= vaddvq_u32(vandq_u32(peak, weights)) << n;
+  }
+  return mask;
+}
+
+template <>
+uint_fast8_t ArduinoFFT<double>::peakMask(const double *vData,
+                                          double floor) const {
+  static const uint64_t bits[2] = {1, 2};
+  uint64x2_t weights = vld1q_u64(bits);
+  float64x2_t f = vdupq_n_f64(floor);
+  uint_fast8_t mask = 0;
+  for (uint_fast8_t n = 0; n < FFT_PEAK_BLOCK; n += 2) {
+    float64x2_t c = vld1q_f64(vData + n);
+    uint64x2_t up = vcgtq_f64(c, vld1q_f64(vData + n - 1));
+    uint64x2_t down = vcgtq_f64(c, vld1q_f64(vData + n + 1));
+    uint64x2_t peak = vandq_u64(vandq_u64(up, down), vcgtq_f64(c, f));
+    mask |= vaddvq_u64(vandq_u64(peak, weights)) << n;
+  }
+  return mask;
+}
+#endif
+#endif
+
+// Offers a local maximum to the min-heap of the count best peaks; floor is
+// raised to the weakest kept peak once the heap is full
+template <typename T>
+void ArduinoFFT<T>::pushPeak(FFTPeak<T> *heap, uint_fast8_t count,
+                             uint_fast8_t *found, uint_fast16_t bin, T value,
+                             T *floor) const {
+  uint_fast8_t slot;
+  if (*found < count) {
+    // Sift the new peak up from the end
+    slot = (*found)++;
+    while (slot > 0 && heap[(slot - 1) >> 1].magnitude > value) {
+      heap[slot] = heap[(slot - 1) >> 1];
+      slot = (slot - 1) >> 1;
+    }
+  } else {
+    if (value <= heap[0].magnitude) {
+      return;
+    }
+    // Replace the weakest peak and sift down
+    slot = 0;
+    for (;;) {
+      uint_fast8_t child = 2 * slot + 1;
+      if (child >= count) {
+        break;
+      }
+      if (child + 1 < count &&
+          heap[child + 1].magnitude < heap[child].magnitude) {
+        child++;
+      }
+      if (heap[child].magnitude >= value) {
+        break;
+      }
+      heap[slot] = heap[child];
+      slot = child;
+    }
+  }
+  heap[slot].bin = bin;
+  heap[slot].magnitude = value;
+  if (*found == count) {
+    *floor = heap[0].magnitude;
+  }
+}
+
 template <typename T>
 void ArduinoFFT<T>::parabola(T x1, T y1, T x2, T y2, T x3, T y3, T *a, T *b,
                              T *c) const {
@@ -464,6 +1060,85 @@ template <typename T> void ArduinoFFT<T>::swap(T *a, T *b) const {
   *b = temp;
 }
 
+// Twiddle step (cos, sin) of radix-2 stage l + 1 from that of stage l
+template <typename T>
+void ArduinoFFT<T>::twiddleStep(T *c1, T *c2, uint_fast8_t l,
+                                FFTDirection dir) const {
+#if defined(__AVR__) && defined(USE_AVR_PROGMEM)
+  *c2 = pgm_read_float_near(&(_c2[l]));
+  *c1 = pgm_read_float_near(&(_c1[l]));
+#else
+  (void)l;
+  T cTemp = 0.5 * *c1;
+  *c2 = sqrt_internal(0.5 - cTemp);
+  *c1 = sqrt_internal(0.5 + cTemp);
+#endif
+
+  if (dir == FFTDirection::Forward) {
+    *c2 = -*c2;
+  }
+}
+
+// Weighing factor of sample i; the window is symmetric, so i < samples / 2
+template <typename T>
+T ArduinoFFT<T>::windowWeight(FFTWindow windowType, uint_fast16_t i,
+                              T samplesMinusOne) const {
+  T indexMinusOne = T(i);
+  T ratio = (indexMinusOne / samplesMinusOne);
+  T weighingFactor = 1.0;
+  switch (windowType) {
+  case FFTWindow::Hamming: // hamming
+    weighingFactor = 0.54 - (0.46 * cos(twoPi * ratio));
+    break;
+  case FFTWindow::Hann: // hann
+    weighingFactor = 0.54 * (1.0 - cos(twoPi * ratio));
+    break;
+  case FFTWindow::Triangle: // triangle (Bartlett)
+#if defined(ESP8266) || defined(ESP32)
+    weighingFactor =
+        1.0 - ((2.0 * fabs(indexMinusOne - (samplesMinusOne / 2.0))) /
+               samplesMinusOne);
+#else
+    weighingFactor =
+        1.0 - ((2.0 * abs(indexMinusOne - (samplesMinusOne / 2.0))) /
+               samplesMinusOne);
+#endif
+    break;
+  case FFTWindow::Nuttall: // nuttall
+    weighingFactor = 0.355768 - (0.487396 * (cos(twoPi * ratio))) +
+                     (0.144232 * (cos(fourPi * ratio))) -
+                     (0.012604 * (cos(sixPi * ratio)));
+    break;
+  case FFTWindow::Blackman: // blackman
+    weighingFactor = 0.42323 - (0.49755 * (cos(twoPi * ratio))) +
+                     (0.07922 * (cos(fourPi * ratio)));
+    break;
+  case FFTWindow::Blackman_Nuttall: // blackman nuttall
+    weighingFactor = 0.3635819 - (0.4891775 * (cos(twoPi * ratio))) +
+                     (0.1365995 * (cos(fourPi * ratio))) -
+                     (0.0106411 * (cos(sixPi * ratio)));
+    break;
+  case FFTWindow::Blackman_Harris: // blackman harris
+    weighingFactor = 0.35875 - (0.48829 * (cos(twoPi * ratio))) +
+                     (0.14128 * (cos(fourPi * ratio))) -
+                     (0.01168 * (cos(sixPi * ratio)));
+    break;
+  case FFTWindow::Flat_top: // flat top
+    weighingFactor = 0.2810639 - (0.5208972 * cos(twoPi * ratio)) +
+                     (0.1980399 * cos(fourPi * ratio));
+    break;
+  case FFTWindow::Welch: // welch
+    weighingFactor = 1.0 - sq((indexMinusOne - samplesMinusOne / 2.0) /
+                              (samplesMinusOne / 2.0));
+    break;
+  default:
+    // This is Rectangle windowing which doesn't do anything
+    // and Precompiled which shouldn't be selected
+    break;
+  }
+  return weighingFactor;
+}
+
 #ifdef FFT_SQRT_APPROXIMATION
 // Fast inverse square root aka "Quake 3 fast inverse square root", multiplied
 // by x. Uses one iteration of Halley's method for precision. See:
@@ -42,6 +42,7 @@
 #include <stdint.h>
 #endif
 #include "enumsFFT.h"
+#include "FFTWindowTables.h"
 
 // This definition uses a low-precision square root approximation instead of the
 // regular sqrt() call
@@ -55,11 +56,55 @@
 
 #define FFT_LIB_REV 0x20
 
+// Builds for a PC or a Raspberry Pi rather than a board. They run
+// FFTAlgorithm::Simd on the vector unit (see FFTVector.h), where boards fall
+// back to the scalar radix-4 kernel, and get FFTBatch and FFTThreadPool.
+#if !defined(ARDUINO) && !defined(__AVR__)
+#define FFT_HOST_BUILD
+#define FFT_VECTOR_BACKEND
+#endif
+
+// Bins tested per step by the peak scan in majorPeaks()
+#define FFT_PEAK_BLOCK 8
+
+// One spectral peak as returned by majorPeaks()
+template <typename T> struct FFTPeak {
+  T frequency;       // Interpolated peak frequency in Hz
+  T magnitude;       // Interpolated peak height
+  uint_fast16_t bin; // Bin of the local maximum
+};
+
+// Caller-owned storage of samples / 2 values for the cached windowing
+// factors, e.g. a static array. Wrapped in a type so that a literal 0 or NULL
+// passed to the constructor still picks the bool overload.
+template <typename T> struct FFTWindowBuffer {
+  explicit FFTWindowBuffer(T *buffer) : factors(buffer) {}
+
+  T *factors;
+};
+
+// Resume point of a time-sliced transform, see computeBegin() and
+// computeStep(). Owned by the caller; one per transform in flight.
+template <typename T> struct FFTProgress {
+  FFTDirection dir;      // Direction given to computeBegin()
+  uint_fast16_t samples; // Transform length, a power of two
+  uint_fast8_t power;    // log2(samples)
+  uint_fast8_t stage;    // 0 bit reversal, 1..power butterflies, then scaling
+  uint_fast16_t i;       // Position within the stage
+  uint_fast16_t j;       // Bit-reversed index, or twiddle index of the stage
+  T c1, c2;              // Twiddle step of the current butterfly stage
+  T u1, u2;              // Current twiddle
+};
+
 template <typename T> class ArduinoFFT {
 public:
   ArduinoFFT();
+  // windowingFactors = true caches the factors in a heap array of
+  // samples / 2 values; pass an FFTWindowBuffer instead to avoid allocating
   ArduinoFFT(T *vReal, T *vImag, uint_fast16_t samples, T samplingFrequency,
              bool windowingFactors = false);
+  ArduinoFFT(T *vReal, T *vImag, uint_fast16_t samples, T samplingFrequency,
+             FFTWindowBuffer<T> windowingFactors);
 
   ~ArduinoFFT();
 
@@ -88,15 +133,46 @@ public:
   void majorPeakParabola(T *vData, uint_fast16_t samples, T samplingFrequency,
                          T *frequency, T *magnitude) const;
 
+  uint_fast8_t majorPeaks(FFTPeak<T> *peaks, uint_fast8_t count) const;
+  uint_fast8_t majorPeaks(T *vData, uint_fast16_t samples, T samplingFrequency,
+                          FFTPeak<T> *peaks, uint_fast8_t count) const;
+
+  void computeBegin(FFTProgress<T> *progress, FFTDirection dir) const;
+  void computeBegin(FFTProgress<T> *progress, uint_fast16_t samples,
+                    FFTDirection dir) const;
+  bool computeStep(FFTProgress<T> *progress, uint_fast16_t budget = 0) const;
+  bool computeStep(T *vReal, T *vImag, FFTProgress<T> *progress,
+                   uint_fast16_t budget = 0) const;
+
+  void computePair(void) const;
+  void computePair(T *vReal, T *vImag, uint_fast16_t samples) const;
+
+  void computeWindowingFactors(T *windowingFactors, uint_fast16_t samples,
+                               FFTWindow windowType,
+                               bool withCompensation = false) const;
+
+  void pairToMagnitude(void) const;
+  void pairToMagnitude(T *vReal, T *vImag, uint_fast16_t samples) const;
+
   uint8_t revision(void);
 
+  void setAlgorithm(FFTAlgorithm algorithm);
   void setArrays(T *vReal, T *vImag, uint_fast16_t samples = 0);
+  void setWindowingFactors(T *windowingFactors);
 
   void windowing(FFTWindow windowType, FFTDirection dir,
                  bool withCompensation = false);
   void windowing(T *vData, uint_fast16_t samples, FFTWindow windowType,
                  FFTDirection dir, T *windowingFactors = nullptr,
                  bool withCompensation = false);
+  void windowing(T *vData, uint_fast16_t samples, const T *windowingFactors,
+                 FFTDirection dir) const;
+  template <FFTWindow W, uint16_t N, bool C>
+  void windowing(const FFTWindowTable<T, W, N, C> &table,
+                 FFTDirection dir) const;
+  template <FFTWindow W, uint16_t N, bool C>
+  void windowing(T *vData, const FFTWindowTable<T, W, N, C> &table,
+                 FFTDirection dir) const;
 
 private:
   /* Variables */
@@ -104,21 +180,41 @@ private:
 #ifdef FFT_SPEED_OVER_PRECISION
   T _oneOverSamples = 0.0;
 #endif
+  FFTAlgorithm _algorithm = FFTAlgorithm::Radix2;
   bool _isPrecompiled = false;
+  bool _ownsWindowingFactors = false;
   bool _precompiledWithCompensation = false;
   uint_fast8_t _power = 0;
   T *_precompiledWindowingFactors = nullptr;
-  uint_fast16_t _samples;
+  uint_fast16_t _samples = 0;
   T _samplingFrequency;
   T *_vImag;
   T *_vReal;
   FFTWindow _windowFunction;
   /* Functions */
+  void reverseBits(T *vReal, T *vImag, uint_fast16_t samples,
+                   FFTDirection dir) const;
+  void butterfliesRadix2(T *vReal, T *vImag, uint_fast16_t samples,
+                         uint_fast8_t power, FFTDirection dir) const;
+  void butterfliesRadix4(T *vReal, T *vImag, uint_fast16_t samples,
+                         uint_fast8_t power, FFTDirection dir) const;
+#ifdef FFT_VECTOR_BACKEND
+  void butterfliesSimd(T *vReal, T *vImag, uint_fast16_t samples,
+                       uint_fast8_t power, FFTDirection dir) const;
+#endif
+  void applyWindowTable(T *vData, uint_fast16_t samples, const T *table,
+                        FFTDirection dir) const;
   uint_fast8_t exponent(uint_fast16_t value) const;
   void findMaxY(T *vData, uint_fast16_t length, T *maxY,
                 uint_fast16_t *index) const;
   void parabola(T x1, T y1, T x2, T y2, T x3, T y3, T *a, T *b, T *c) const;
+  uint_fast8_t peakMask(const T *vData, T floor) const;
+  void pushPeak(FFTPeak<T> *heap, uint_fast8_t count, uint_fast8_t *found,
+                uint_fast16_t bin, T value, T *floor) const;
   void swap(T *a, T *b) const;
+  void twiddleStep(T *c1, T *c2, uint_fast8_t l, FFTDirection dir) const;
+  T windowWeight(FFTWindow windowType, uint_fast16_t i,
+                 T samplesMinusOne) const;
 
 #ifdef FFT_SQRT_APPROXIMATION
   float sqrt_internal(float x) const;
@@ -126,6 +222,21 @@ private:
 #endif
 };
 
+// Applies a compile-time window table (see FFTWindowTables.h) to vReal
+template <typename T>
+template <FFTWindow W, uint16_t N, bool C>
+void ArduinoFFT<T>::windowing(const FFTWindowTable<T, W, N, C> &table,
+                              FFTDirection dir) const {
+  windowing(this->_vReal, table, dir);
+}
+
+template <typename T>
+template <FFTWindow W, uint16_t N, bool C>
+void ArduinoFFT<T>::windowing(T *vData, const FFTWindowTable<T, W, N, C> &,
+                              FFTDirection dir) const {
+  applyWindowTable(vData, N, FFTWindowTable<T, W, N, C>::factors, dir);
+}
+
 #if defined(__AVR__) && defined(USE_AVR_PROGMEM)
 static const float _c1[] PROGMEM = {
     0.0000000000, 0.7071067812, 0.9238795325, 0.9807852804, 0.9951847267,
@@ -40,4 +40,10 @@ enum class FFTWindow {
 };
 
 enum class FFTDirection { Forward, Reverse };
+
+enum class FFTAlgorithm {
+  Radix2, // radix-2 decimation in time
+  Radix4, // radix-4 butterflies, about 25% fewer multiplies, same output
+  Simd    // radix-4 on SSE2/AVX/NEON vectors on host builds, else Radix4
+};
 #endif
\ No newline at end of file
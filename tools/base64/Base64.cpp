@@ -0,0 +1,296 @@
+#include "Base64.h"
+
+#if !defined(BASE64_DISABLE_SIMD)
+#if defined(__AVX2__)
+#define BASE64_AVX2
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#define BASE64_SSSE3
+#include <tmmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define BASE64_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace {
+
+const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+const uint8_t INVALID = 0xFF;
+
+/// Character to 6-bit value, INVALID for anything outside the alphabet
+struct DecodeTable {
+    uint8_t values[256];
+
+    DecodeTable() {
+        for (uint8_t& value : values) value = INVALID;
+        for (uint8_t i = 0; i < 64; i++) values[uint8_t(ALPHABET[i])] = i;
+    }
+};
+
+const DecodeTable DECODE;
+
+#if defined(BASE64_AVX2) || defined(BASE64_SSSE3)
+
+// The x86 paths follow Muła and Lemire, "Faster Base64 Encoding and Decoding
+// Using AVX2 Instructions" (2018): split with multiplies, translate with an
+// offset picked by pshufb, and validate with two nibble lookups.
+
+// Byte shuffle that gives each 32-bit lane the three input bytes it encodes
+#define BASE64_ENCODE_SHUFFLE 1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10
+// Offset from a 6-bit value to its character, by range (see translate())
+#define BASE64_ENCODE_OFFSETS 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 65, 0, 0
+// Decode validation: a character is invalid when the two entries share a bit
+#define BASE64_DECODE_LO 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, \
+                         0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A
+#define BASE64_DECODE_HI 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, \
+                         0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10
+// Offset from a character to its 6-bit value, by high nibble ('/' is 1 + 0x2)
+#define BASE64_DECODE_ROLL 0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0
+// Packed output bytes of each 32-bit lane, in order
+#define BASE64_DECODE_PACK 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1
+
+#endif
+
+#if defined(BASE64_AVX2)
+
+// 24 bytes to 32 characters; reads 28 bytes
+inline void encodeBlock(const uint8_t* in, char* out) {
+    __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 12));
+    __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+    v = _mm256_shuffle_epi8(v, _mm256_setr_epi8(BASE64_ENCODE_SHUFFLE, BASE64_ENCODE_SHUFFLE));
+    __m256i ac = _mm256_mulhi_epu16(_mm256_and_si256(v, _mm256_set1_epi32(0x0FC0FC00)),
+                                    _mm256_set1_epi32(0x04000040));
+    __m256i bd = _mm256_mullo_epi16(_mm256_and_si256(v, _mm256_set1_epi32(0x003F03F0)),
+                                    _mm256_set1_epi32(0x01000010));
+    __m256i indices = _mm256_or_si256(ac, bd);
+    // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+    __m256i range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    range = _mm256_or_si256(range, _mm256_and_si256(
+        _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices), _mm256_set1_epi8(13)));
+    __m256i offsets = _mm256_shuffle_epi8(
+        _mm256_setr_epi8(BASE64_ENCODE_OFFSETS, BASE64_ENCODE_OFFSETS), range);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_add_epi8(indices, offsets));
+}
+
+// 32 characters to 24 bytes; writes 32
+inline bool decodeBlock(const char* in, uint8_t* out) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+    __m256i hiNibbles = _mm256_and_si256(_mm256_srli_epi32(v, 4), _mm256_set1_epi8(0x0F));
+    __m256i loNibbles = _mm256_and_si256(v, _mm256_set1_epi8(0x0F));
+    __m256i lo = _mm256_shuffle_epi8(_mm256_setr_epi8(BASE64_DECODE_LO, BASE64_DECODE_LO), loNibbles);
+    __m256i hi = _mm256_shuffle_epi8(_mm256_setr_epi8(BASE64_DECODE_HI, BASE64_DECODE_HI), hiNibbles);
+    if (!_mm256_testz_si256(lo, hi)) {
+        return false;
+    }
+    __m256i slash = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('/'));
+    __m256i roll = _mm256_shuffle_epi8(_mm256_setr_epi8(BASE64_DECODE_ROLL, BASE64_DECODE_ROLL),
+                                       _mm256_add_epi8(slash, hiNibbles));
+    v = _mm256_add_epi8(v, roll);
+    v = _mm256_maddubs_epi16(v, _mm256_set1_epi32(0x01400140));
+    v = _mm256_madd_epi16(v, _mm256_set1_epi32(0x00011000));
+    v = _mm256_shuffle_epi8(v, _mm256_setr_epi8(BASE64_DECODE_PACK, BASE64_DECODE_PACK));
+    v = _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), v);
+    return true;
+}
+
+const size_t ENCODE_BYTES = 24;
+const size_t ENCODE_READ = 28;
+const size_t DECODE_CHARS = 32;
+const size_t DECODE_WRITE = 32;
+
+#elif defined(BASE64_SSSE3)
+
+// 12 bytes to 16 characters; reads 16 bytes
+inline void encodeBlock(const uint8_t* in, char* out) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    v = _mm_shuffle_epi8(v, _mm_setr_epi8(BASE64_ENCODE_SHUFFLE));
+    __m128i ac = _mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0FC0FC00)),
+                                 _mm_set1_epi32(0x04000040));
+    __m128i bd = _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003F03F0)),
+                                 _mm_set1_epi32(0x01000010));
+    __m128i indices = _mm_or_si128(ac, bd);
+    __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    range = _mm_or_si128(range, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices),
+                                              _mm_set1_epi8(13)));
+    __m128i offsets = _mm_shuffle_epi8(_mm_setr_epi8(BASE64_ENCODE_OFFSETS), range);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_add_epi8(indices, offsets));
+}
+
+// 16 characters to 12 bytes; writes 16
+inline bool decodeBlock(const char* in, uint8_t* out) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    __m128i hiNibbles = _mm_and_si128(_mm_srli_epi32(v, 4), _mm_set1_epi8(0x0F));
+    __m128i loNibbles = _mm_and_si128(v, _mm_set1_epi8(0x0F));
+    __m128i lo = _mm_shuffle_epi8(_mm_setr_epi8(BASE64_DECODE_LO), loNibbles);
+    __m128i hi = _mm_shuffle_epi8(_mm_setr_epi8(BASE64_DECODE_HI), hiNibbles);
+    // SSSE3 has no ptest: every byte of lo & hi must be zero
+    __m128i shared = _mm_and_si128(lo, hi);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(shared, _mm_setzero_si128())) != 0xFFFF) {
+        return false;
+    }
+    __m128i slash = _mm_cmpeq_epi8(v, _mm_set1_epi8('/'));
+    __m128i roll = _mm_shuffle_epi8(_mm_setr_epi8(BASE64_DECODE_ROLL), _mm_add_epi8(slash, hiNibbles));
+    v = _mm_add_epi8(v, roll);
+    v = _mm_maddubs_epi16(v, _mm_set1_epi32(0x01400140));
+    v = _mm_madd_epi16(v, _mm_set1_epi32(0x00011000));
+    v = _mm_shuffle_epi8(v, _mm_setr_epi8(BASE64_DECODE_PACK));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), v);
+    return true;
+}
+
+const size_t ENCODE_BYTES = 12;
+const size_t ENCODE_READ = 16;
+const size_t DECODE_CHARS = 16;
+const size_t DECODE_WRITE = 16;
+
+#elif defined(BASE64_NEON)
+
+// 48 bytes to 64 characters: vld3 splits the byte triples, vst4 interleaves
+// the four 6-bit groups again, and one 64-entry table lookup translates them
+inline void encodeBlock(const uint8_t* in, char* out) {
+    static const uint8x16x4_t alphabet = vld1q_u8_x4(reinterpret_cast<const uint8_t*>(ALPHABET));
+    uint8x16x3_t bytes = vld3q_u8(in);
+    uint8x16x4_t chars;
+    chars.val[0] = vshrq_n_u8(bytes.val[0], 2);
+    chars.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(bytes.val[0], 4), vshrq_n_u8(bytes.val[1], 4)),
+                            vdupq_n_u8(0x3F));
+    chars.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(bytes.val[1], 2), vshrq_n_u8(bytes.val[2], 6)),
+                            vdupq_n_u8(0x3F));
+    chars.val[3] = vandq_u8(bytes.val[2], vdupq_n_u8(0x3F));
+    for (int i = 0; i < 4; i++) {
+        chars.val[i] = vqtbl4q_u8(alphabet, chars.val[i]);
+    }
+    vst4q_u8(reinterpret_cast<uint8_t*>(out), chars);
+}
+
+// 64 characters to 48 bytes. Two 64-entry lookups cover ASCII; they hold
+// value + 1 so that 0 (also what an out-of-range index gives) means invalid
+inline bool decodeBlock(const char* in, uint8_t* out) {
+    struct Tables {
+        uint8_t values[128];
+        Tables() {
+            for (int c = 0; c < 128; c++) {
+                values[c] = DECODE.values[c] == INVALID ? 0 : DECODE.values[c] + 1;
+            }
+        }
+    };
+    static const Tables tables;
+    static const uint8x16x4_t low = vld1q_u8_x4(tables.values);
+    static const uint8x16x4_t high = vld1q_u8_x4(tables.values + 64);
+
+    uint8x16x4_t chars = vld4q_u8(reinterpret_cast<const uint8_t*>(in));
+    uint8x16_t invalid = vdupq_n_u8(0);
+    for (int i = 0; i < 4; i++) {
+        uint8x16_t c = chars.val[i];
+        uint8x16_t value = vorrq_u8(vqtbl4q_u8(low, c), vqtbl4q_u8(high, vsubq_u8(c, vdupq_n_u8(64))));
+        invalid = vorrq_u8(invalid, vceqq_u8(value, vdupq_n_u8(0)));
+        chars.val[i] = vsubq_u8(value, vdupq_n_u8(1));
+    }
+    if (vmaxvq_u8(invalid)) {
+        return false;
+    }
+    uint8x16x3_t bytes;
+    bytes.val[0] = vorrq_u8(vshlq_n_u8(chars.val[0], 2), vshrq_n_u8(chars.val[1], 4));
+    bytes.val[1] = vorrq_u8(vshlq_n_u8(chars.val[1], 4), vshrq_n_u8(chars.val[2], 2));
+    bytes.val[2] = vorrq_u8(vshlq_n_u8(chars.val[2], 6), chars.val[3]);
+    vst3q_u8(out, bytes);
+    return true;
+}
+
+const size_t ENCODE_BYTES = 48;
+const size_t ENCODE_READ = 48;
+const size_t DECODE_CHARS = 64;
+const size_t DECODE_WRITE = 48;
+
+#endif
+
+} // namespace
+
+size_t base64Encode(const uint8_t* in, size_t bytes, char* out) {
+    char* start = out;
+    size_t i = 0;
+#if defined(BASE64_AVX2) || defined(BASE64_SSSE3) || defined(BASE64_NEON)
+    for (; i + ENCODE_READ <= bytes; i += ENCODE_BYTES) {
+        encodeBlock(in + i, out);
+        out += ENCODE_BYTES / 3 * 4;
+    }
+#endif
+    for (; i + 3 <= bytes; i += 3) {
+        uint32_t group = (uint32_t(in[i]) << 16) | (uint32_t(in[i + 1]) << 8) | in[i + 2];
+        *out++ = ALPHABET[group >> 18];
+        *out++ = ALPHABET[(group >> 12) & 63];
+        *out++ = ALPHABET[(group >> 6) & 63];
+        *out++ = ALPHABET[group & 63];
+    }
+    if (i < bytes) {
+        uint32_t group = uint32_t(in[i]) << 16;
+        if (i + 1 < bytes) group |= uint32_t(in[i + 1]) << 8;
+        *out++ = ALPHABET[group >> 18];
+        *out++ = ALPHABET[(group >> 12) & 63];
+        *out++ = i + 1 < bytes ? ALPHABET[(group >> 6) & 63] : '=';
+        *out++ = '=';
+    }
+    return size_t(out - start);
+}
+
+long base64Decode(const char* in, size_t chars, uint8_t* out) {
+    if (chars % 4) {
+        return -1;
+    }
+    // Padding only ends the last quartet, which the scalar loop decodes
+    size_t padding = 0;
+    if (chars && in[chars - 1] == '=') padding = in[chars - 2] == '=' ? 2 : 1;
+    size_t length = chars - padding;
+
+    uint8_t* start = out;
+    size_t i = 0;
+#if defined(BASE64_AVX2) || defined(BASE64_SSSE3) || defined(BASE64_NEON)
+    size_t total = length * 3 / 4;
+    // A block may write past its own bytes, so keep clear of the end of out
+    while (i + DECODE_CHARS <= length &&
+           size_t(out - start) + DECODE_WRITE <= total &&
+           decodeBlock(in + i, out)) {
+        i += DECODE_CHARS;
+        out += DECODE_CHARS / 4 * 3;
+    }
+#endif
+    for (; i + 4 <= length; i += 4) {
+        const uint8_t* q = reinterpret_cast<const uint8_t*>(in + i);
+        uint8_t a = DECODE.values[q[0]], b = DECODE.values[q[1]];
+        uint8_t c = DECODE.values[q[2]], d = DECODE.values[q[3]];
+        if ((a | b | c | d) & 0xC0) {
+            return -1;
+        }
+        uint32_t group = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6) | d;
+        *out++ = uint8_t(group >> 16);
+        *out++ = uint8_t(group >> 8);
+        *out++ = uint8_t(group);
+    }
+    if (padding) {
+        const uint8_t* q = reinterpret_cast<const uint8_t*>(in + i);
+        uint8_t a = DECODE.values[q[0]], b = DECODE.values[q[1]];
+        uint8_t c = padding == 1 ? DECODE.values[q[2]] : 0;
+        if ((a | b | c) & 0xC0) {
+            return -1;
+        }
+        *out++ = uint8_t((a << 2) | (b >> 4));
+        if (padding == 1) *out++ = uint8_t((b << 4) | (c >> 2));
+    }
+    return long(out - start);
+}
+
+const char* base64Backend() {
+#if defined(BASE64_AVX2)
+    return "avx2";
+#elif defined(BASE64_SSSE3)
+    return "ssse3";
+#elif defined(BASE64_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
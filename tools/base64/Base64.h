@@ -0,0 +1,46 @@
+#ifndef BASE64_H
+#define BASE64_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file Base64.h
+ * @brief Base64 (RFC 4648, with padding) into buffers the caller owns
+ *
+ * The instruction set is chosen at compile time, as for the FFT kernels:
+ * AVX2 (-mavx2 or -march=native), SSSE3 (-mssse3), NEON (aarch64) or a
+ * scalar loop. Define BASE64_DISABLE_SIMD to build only the scalar loop.
+ */
+
+/// Characters base64Encode() writes for bytes of input
+inline size_t base64EncodedSize(size_t bytes) {
+    return (bytes + 2) / 3 * 4;
+}
+
+/// Room base64Decode() needs for chars of input (padding makes it an upper bound)
+inline size_t base64DecodedSize(size_t chars) {
+    return chars / 4 * 3;
+}
+
+/**
+ * @brief Encode bytes into out, which must hold base64EncodedSize(bytes)
+ * @return Characters written; no terminator is added
+ */
+size_t base64Encode(const uint8_t* in, size_t bytes, char* out);
+
+/**
+ * @brief Decode chars into out, which must hold base64DecodedSize(chars)
+ *
+ * Strict: the length must be a multiple of four, and only the last two
+ * characters may be '='. Whitespace and line breaks are rejected.
+ *
+ * @return Bytes written, or -1 when in is not valid base64 (out may then
+ *         hold partial output)
+ */
+long base64Decode(const char* in, size_t chars, uint8_t* out);
+
+/// Instruction set compiled in: "avx2", "ssse3", "neon" or "scalar"
+const char* base64Backend();
+
+#endif // BASE64_H
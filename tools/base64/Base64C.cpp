@@ -0,0 +1,26 @@
+#include "Base64C.h"
+#include "Base64.h"
+
+extern "C" {
+
+size_t base64_encoded_size(size_t bytes) {
+    return base64EncodedSize(bytes);
+}
+
+size_t base64_decoded_size(size_t chars) {
+    return base64DecodedSize(chars);
+}
+
+size_t base64_encode(const uint8_t *in, size_t bytes, char *out) {
+    return base64Encode(in, bytes, out);
+}
+
+// Invalid input is not printed: callers fall back to a lenient decoder
+long base64_decode(const char *in, size_t chars, uint8_t *out) {
+    return base64Decode(in, chars, out);
+}
+
+const char *base64_backend(void) {
+    return base64Backend();
+}
+}
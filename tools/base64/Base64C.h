@@ -0,0 +1,32 @@
+#ifndef BASE64C_H
+#define BASE64C_H
+
+/**
+ * @file Base64C.h
+ * @brief C interface to the base64 codec, loaded by the assistant with ctypes
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+size_t base64_encoded_size(size_t bytes);
+size_t base64_decoded_size(size_t chars);
+
+/// Characters written to out, which must hold base64_encoded_size(bytes)
+size_t base64_encode(const uint8_t *in, size_t bytes, char *out);
+
+/// Bytes written to out, which must hold base64_decoded_size(chars); -1 for invalid input
+long base64_decode(const char *in, size_t chars, uint8_t *out);
+
+/// "avx2", "ssse3", "neon" or "scalar"
+const char *base64_backend(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BASE64C_H
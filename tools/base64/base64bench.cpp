@@ -0,0 +1,203 @@
+/**
+ * @file base64bench.cpp
+ * @brief Throughput benchmark and correctness check for tools/base64
+ *
+ * Checks base64Encode() and base64Decode() against a plain reference codec
+ * for every length up to 1 KiB, and checks that corrupt, truncated and
+ * wrongly padded input is rejected. It then times both directions at the
+ * sizes the assistant sees: a 40 ms audio delta at 24 kHz, a 50 ms mic
+ * block and a whole 64 KiB response, next to the reference. Exits with
+ * status 1 on any mismatch, so it can double as a regression check.
+ *
+ * Usage:
+ * ```
+ * base64bench [--ms MS]
+ * ```
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Base64.h"
+
+namespace {
+
+const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+struct Size {
+    size_t bytes;
+    const char* name;
+};
+
+// 40 ms of 24 kHz int16 (a response delta), 50 ms (a mic block), a long reply
+const Size SIZES[] = {
+    {1920, "delta 40ms"},
+    {2400, "mic 50ms"},
+    {65536, "64 KiB"},
+};
+
+void printUsage() {
+    std::cerr << "Usage: base64bench [--ms MS]\n"
+              << "  --ms MS  time spent per measurement (default 200)\n";
+}
+
+// One character at a time, as a textbook would write it
+std::string referenceEncode(const std::vector<uint8_t>& in) {
+    std::string out;
+    for (size_t i = 0; i < in.size(); i += 3) {
+        uint32_t group = uint32_t(in[i]) << 16;
+        if (i + 1 < in.size()) group |= uint32_t(in[i + 1]) << 8;
+        if (i + 2 < in.size()) group |= in[i + 2];
+        out += ALPHABET[group >> 18];
+        out += ALPHABET[(group >> 12) & 63];
+        out += i + 1 < in.size() ? ALPHABET[(group >> 6) & 63] : '=';
+        out += i + 2 < in.size() ? ALPHABET[group & 63] : '=';
+    }
+    return out;
+}
+
+std::vector<uint8_t> referenceDecode(const std::string& in) {
+    static int values[256];
+    if (!values['B']) {
+        for (int& value : values) value = -1;
+        for (int i = 0; i < 64; i++) values[uint8_t(ALPHABET[i])] = i;
+    }
+    std::vector<uint8_t> out;
+    uint32_t group = 0;
+    int bits = 0;
+    for (char c : in) {
+        int value = values[uint8_t(c)];
+        if (value < 0) break;
+        group = (group << 6) | uint32_t(value);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out.push_back(uint8_t(group >> bits));
+        }
+    }
+    return out;
+}
+
+bool checkRoundTrips() {
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> byte(0, 255);
+    for (size_t n = 0; n <= 1024; n++) {
+        std::vector<uint8_t> data(n);
+        for (uint8_t& b : data) b = uint8_t(byte(rng));
+        std::string expected = referenceEncode(data);
+
+        std::string encoded(base64EncodedSize(n), '\0');
+        size_t chars = base64Encode(data.data(), n, &encoded[0]);
+        if (chars != expected.size() || encoded != expected) {
+            std::cerr << "base64bench: encode mismatch at " << n << " bytes\n";
+            return false;
+        }
+        std::vector<uint8_t> decoded(base64DecodedSize(chars));
+        long bytes = base64Decode(encoded.data(), chars, decoded.data());
+        decoded.resize(bytes < 0 ? 0 : size_t(bytes));
+        if (bytes != long(n) || decoded != data || referenceDecode(encoded) != data) {
+            std::cerr << "base64bench: decode mismatch at " << n << " bytes\n";
+            return false;
+        }
+
+        // Any foreign character, wherever a vector block would see it
+        if (chars >= 4) {
+            std::string corrupt = encoded;
+            corrupt[size_t(rng()) % (chars - 2)] = "!\n-_ "[n % 5];
+            if (base64Decode(corrupt.data(), chars, decoded.data()) >= 0) {
+                std::cerr << "base64bench: accepted a bad character at " << n << " bytes\n";
+                return false;
+            }
+        }
+    }
+
+    std::vector<uint8_t> out(16);
+    const char* bad[] = {"QUJD=", "QU=D", "Q===", "=QUJ", "QUJDR"};
+    for (const char* input : bad) {
+        if (base64Decode(input, std::strlen(input), out.data()) >= 0) {
+            std::cerr << "base64bench: accepted \"" << input << "\"\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename F>
+double mbPerSecond(size_t bytes, int ms, F run) {
+    run();  // warm up caches
+    using Clock = std::chrono::steady_clock;
+    const auto budget = std::chrono::milliseconds(ms);
+    long iterations = 0;
+    auto start = Clock::now();
+    auto now = start;
+    do {
+        for (int i = 0; i < 16; i++) run();
+        iterations += 16;
+        now = Clock::now();
+    } while (now - start < budget);
+    double seconds = std::chrono::duration<double>(now - start).count();
+    return double(bytes) * iterations / seconds / 1e6;
+}
+
+void bench(const Size& size, int ms) {
+    std::mt19937 rng(1234);
+    std::vector<uint8_t> data(size.bytes);
+    for (uint8_t& b : data) b = uint8_t(rng());
+    std::string text(base64EncodedSize(size.bytes), '\0');
+    base64Encode(data.data(), data.size(), &text[0]);
+    std::vector<uint8_t> decoded(base64DecodedSize(text.size()));
+    volatile size_t sink = 0;
+
+    double encode = mbPerSecond(size.bytes, ms, [&]() {
+        sink = sink + base64Encode(data.data(), data.size(), &text[0]);
+    });
+    double encodeRef = mbPerSecond(size.bytes, ms, [&]() {
+        sink = sink + referenceEncode(data).size();
+    });
+    double decode = mbPerSecond(size.bytes, ms, [&]() {
+        sink = sink + size_t(base64Decode(text.data(), text.size(), decoded.data()));
+    });
+    double decodeRef = mbPerSecond(size.bytes, ms, [&]() {
+        sink = sink + referenceDecode(text).size();
+    });
+
+    std::cout << std::left << std::setw(12) << size.name << std::right << std::fixed
+              << std::setprecision(0) << std::setw(10) << encode << std::setw(8)
+              << std::setprecision(1) << encode / encodeRef << "x" << std::setprecision(0)
+              << std::setw(10) << decode << std::setw(8) << std::setprecision(1)
+              << decode / decodeRef << "x" << std::defaultfloat << "\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int ms = 200;
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && std::strcmp(argv[i], "--ms") == 0) {
+            ms = std::atoi(argv[++i]);
+        } else {
+            printUsage();
+            return 2;
+        }
+    }
+    if (ms <= 0) {
+        printUsage();
+        return 2;
+    }
+
+    std::cout << "base64 backend: " << base64Backend() << "\n";
+    if (!checkRoundTrips()) {
+        return 1;
+    }
+    std::cout << "size           encode MB/s  vs ref   decode MB/s  vs ref\n";
+    for (const Size& size : SIZES) {
+        bench(size, ms);
+    }
+    return 0;
+}
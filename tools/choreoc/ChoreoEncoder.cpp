@@ -0,0 +1,85 @@
+#include "ChoreoEncoder.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+namespace {
+
+void appendVarint(std::vector<uint8_t>& out, uint32_t value) {
+    do {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        if (value) byte |= CHOREO_VARINT_MORE;
+        out.push_back(byte);
+    } while (value);
+}
+
+} // namespace
+
+std::vector<uint8_t> encodeChoreography(std::vector<Track> tracks) {
+    if (tracks.empty() || tracks.size() > 255) {
+        throw std::runtime_error("choreography needs 1-255 tracks");
+    }
+
+    std::vector<uint8_t> blob = {CHOREO_MAGIC_0, CHOREO_MAGIC_1, CHOREO_VERSION,
+                                 static_cast<uint8_t>(tracks.size())};
+    blob.resize(CHOREO_HEADER_SIZE + tracks.size() * 2);
+
+    for (size_t i = 0; i < tracks.size(); i++) {
+        Track& track = tracks[i];
+        std::stable_sort(track.begin(), track.end(),
+                         [](const Keyframe& a, const Keyframe& b) { return a.timeMs < b.timeMs; });
+
+        if (track.empty() || track.back().direction != CHOREO_DIR_END) {
+            Keyframe end;
+            end.timeMs = track.empty() ? 0 : track.back().timeMs;
+            end.direction = CHOREO_DIR_END;
+            track.push_back(end);
+        }
+
+        if (blob.size() > 0xFFFF) {
+            throw std::runtime_error("choreography exceeds 64 KB");
+        }
+        blob[CHOREO_HEADER_SIZE + i * 2] = blob.size() & 0xFF;
+        blob[CHOREO_HEADER_SIZE + i * 2 + 1] = blob.size() >> 8;
+
+        uint32_t previous = 0;
+        for (const Keyframe& key : track) {
+            appendVarint(blob, key.timeMs - previous);
+            previous = key.timeMs;
+
+            blob.push_back((key.direction & CHOREO_DIR_MASK) |
+                           ((key.easing << CHOREO_EASE_SHIFT) & CHOREO_EASE_MASK));
+            if (key.direction == CHOREO_DIR_FORWARD || key.direction == CHOREO_DIR_BACKWARD) {
+                blob.push_back(key.speed);
+            }
+            if (key.direction == CHOREO_DIR_END) break;
+        }
+    }
+
+    if (blob.size() > 0xFFFF) {
+        throw std::runtime_error("choreography exceeds 64 KB");
+    }
+    return blob;
+}
+
+void writeChoreographyHeader(std::ostream& out, const std::vector<uint8_t>& blob,
+                             const std::string& name, const std::string& source) {
+    std::string guard = name + "_H";
+
+    out << "// Generated by tools/choreoc from " << source << " - do not edit.\n"
+        << "#ifndef " << guard << "\n"
+        << "#define " << guard << "\n\n"
+        << "#include <Arduino.h>\n\n"
+        << "const uint16_t " << name << "_SIZE = " << blob.size() << ";\n\n"
+        << "const uint8_t " << name << "[] PROGMEM = {";
+
+    char hex[8];
+    for (size_t i = 0; i < blob.size(); i++) {
+        out << (i % 12 == 0 ? "\n    " : " ");
+        std::snprintf(hex, sizeof(hex), "0x%02X,", blob[i]);
+        out << hex;
+    }
+    out << "\n};\n\n#endif // " << guard << "\n";
+}
@@ -0,0 +1,57 @@
+#ifndef CHOREOENCODER_H
+#define CHOREOENCODER_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "ChoreoFormat.h"
+
+/**
+ * @file ChoreoEncoder.h
+ * @brief Host-side encoder for the choreography format in ChoreoFormat.h
+ *
+ * Turns per-track keyframe lists with absolute time stamps into the
+ * delta-encoded blob the firmware streams from flash, and writes it either
+ * as a raw binary or as a PROGMEM C header.
+ */
+
+/**
+ * @brief One keyframe with an absolute time stamp
+ */
+struct Keyframe {
+    uint32_t timeMs = 0;                  ///< Absolute time from choreography start (ms)
+    uint8_t direction = CHOREO_DIR_STOP;  ///< CHOREO_DIR_* value
+    uint8_t speed = 0;                    ///< Target PWM speed 0-255
+    uint8_t easing = CHOREO_EASE_STEP;    ///< CHOREO_EASE_* value
+};
+
+/// Keyframes of one motor track, in any order
+using Track = std::vector<Keyframe>;
+
+/**
+ * @brief Encode tracks into a choreography blob
+ *
+ * Keyframes are sorted by time (stable, so equal time stamps keep their
+ * order). Every track gets an end keyframe at its last time stamp unless it
+ * already ends with an explicit CHOREO_DIR_END keyframe.
+ *
+ * @param tracks One keyframe list per track, indexed by CHOREO_TRACK_*
+ * @return Encoded blob
+ * @throws std::runtime_error if the track count or blob size is out of range
+ */
+std::vector<uint8_t> encodeChoreography(std::vector<Track> tracks);
+
+/**
+ * @brief Write a blob as a C header with a PROGMEM array
+ *
+ * @param out Output stream
+ * @param blob Encoded choreography
+ * @param name Array name, e.g. CHOREO_SINGING
+ * @param source Source description placed in the header comment
+ */
+void writeChoreographyHeader(std::ostream& out, const std::vector<uint8_t>& blob,
+                             const std::string& name, const std::string& source);
+
+#endif // CHOREOENCODER_H
@@ -0,0 +1,372 @@
+#include "SongCompiler.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "WavReader.h"
+#include "FFTBatch.h"
+#include "TempoEstimator.h"
+
+namespace {
+
+const double VOCAL_BAND_LOW_HZ = 80.0;
+const double VOCAL_BAND_HIGH_HZ = 8000.0;
+const double DRUM_BAND_LOW_HZ = 30.0;
+const double DRUM_BAND_HIGH_HZ = 250.0;
+const double DRUM_FRAME_SECONDS = 0.023;    // ~1024 samples at 44.1 kHz
+const double ONSET_THRESHOLD_RATIO = 1.5;   // flux must exceed the local mean by this much
+const int ONSET_CONTEXT_MS = 100;           // local mean window, each side
+const int ONSET_PEAK_MS = 30;               // flux must be the local max over this radius
+const double TEMPO_MIN_BPM = 60.0;
+const double TEMPO_MAX_BPM = 200.0;
+const size_t FFT_BATCH_FRAMES = 256;        // hops per FFTBatch call, spread over the cores
+
+uint16_t nextPowerOfTwo(uint32_t value) {
+    uint32_t n = 1;
+    while (n < value) n <<= 1;
+    return n > 0x8000 ? 0x8000 : n;
+}
+
+// Hops go two per transform (computePair): even hops in the real half of a
+// pair, odd hops in the imaginary half
+float* pairedFrame(std::vector<float>& re, std::vector<float>& im, size_t hop, uint16_t n) {
+    return (hop & 1 ? im.data() : re.data()) + (hop / 2) * n;
+}
+
+// Bin k (0 < k < n / 2) of a hop after computePair(): the even hop's is in
+// slot k of its pair, the odd hop's in slot n - k
+float binPower(const std::vector<float>& re, const std::vector<float>& im, size_t hop,
+               uint16_t n, uint16_t k) {
+    size_t slot = (hop / 2) * n + (hop & 1 ? n - k : k);
+    return re[slot] * re[slot] + im[slot] * im[slot];
+}
+
+// np.interp() over a two-point range, clamped to the end values
+double interpolate(double x, double x0, double x1, double y0, double y1) {
+    if (x <= x0) return y0;
+    if (x >= x1) return y1;
+    return y0 + (y1 - y0) * (x - x0) / (x1 - x0);
+}
+
+uint8_t percentToSpeed(double percent) {
+    return static_cast<uint8_t>(std::lround(std::clamp(percent, 0.0, 100.0) * 255.0 / 100.0));
+}
+
+Keyframe keyframe(uint32_t timeMs, uint8_t direction, uint8_t speed = 0) {
+    Keyframe key;
+    key.timeMs = timeMs;
+    key.direction = direction;
+    key.speed = speed;
+    return key;
+}
+
+float applyGain(float sample, double gain) {
+    return static_cast<float>(std::clamp(sample * gain, -32768.0, 32767.0));
+}
+
+// Vocal-band RMS per hop over a CHUNK_MS window, via Parseval on the spectrum
+std::vector<double> vocalEnvelope(const WavData& wav, const SongMetadata& meta,
+                                  const SongOptions& options) {
+    const uint32_t hop = std::max<uint32_t>(1, wav.sampleRate * options.hopMs / 1000);
+    const uint32_t window = std::max<uint32_t>(1, wav.sampleRate * options.chunkMs / 1000);
+    const uint16_t n = nextPowerOfTwo(window);
+    const uint32_t used = std::min<uint32_t>(window, n);
+
+    const uint16_t kLow = std::max(1, int(std::ceil(VOCAL_BAND_LOW_HZ * n / wav.sampleRate)));
+    const uint16_t kHigh =
+        std::min(n / 2 - 1, int(std::floor(VOCAL_BAND_HIGH_HZ * n / wav.sampleRate)));
+
+    const size_t frames = (wav.samples.size() + hop - 1) / hop;
+    FFTBatch<float> batch(n);
+    batch.setPaired(true);
+    std::vector<float> re(FFT_BATCH_FRAMES / 2 * n), im(FFT_BATCH_FRAMES / 2 * n);
+    std::vector<double> envelope;
+
+    for (size_t first = 0; first < frames; first += FFT_BATCH_FRAMES) {
+        size_t batchFrames = std::min(FFT_BATCH_FRAMES, frames - first);
+        size_t pairs = (batchFrames + 1) / 2;
+        for (size_t f = 0; f < 2 * pairs; f++) {
+            float* frame = pairedFrame(re, im, f, n);
+            size_t start = (first + f) * hop;
+            size_t count = f < batchFrames ? std::min<size_t>(used, wav.samples.size() - start) : 0;
+            for (size_t i = 0; i < n; i++) {
+                frame[i] = i < count ? applyGain(wav.samples[start + i], meta.gain) : 0.0f;
+            }
+        }
+        batch.compute(re.data(), im.data(), pairs, FFTDirection::Forward);
+
+        for (size_t f = 0; f < batchFrames; f++) {
+            size_t count = std::min<size_t>(used, wav.samples.size() - (first + f) * hop);
+
+            // One-sided band energy; sum(x^2) == sum(|X|^2) / n
+            double energy = 0.0;
+            for (uint16_t k = kLow; k <= kHigh; k++) {
+                energy += binPower(re, im, f, n, k);
+            }
+            envelope.push_back(std::sqrt(2.0 * energy / n / count));
+        }
+    }
+    return envelope;
+}
+
+// Low-band half-wave rectified spectral flux, one value per hop
+std::vector<double> drumFlux(const WavData& wav, const SongMetadata& meta,
+                             const SongOptions& options) {
+    const uint32_t hop = std::max<uint32_t>(1, wav.sampleRate * options.hopMs / 1000);
+    const uint16_t n = nextPowerOfTwo(uint32_t(wav.sampleRate * DRUM_FRAME_SECONDS));
+
+    const uint16_t kLow = std::max(1, int(std::floor(DRUM_BAND_LOW_HZ * n / wav.sampleRate)));
+    const uint16_t kHigh = std::max<int>(
+        kLow, std::min(n / 2 - 1, int(std::ceil(DRUM_BAND_HIGH_HZ * n / wav.sampleRate))));
+
+    const size_t frames = (wav.samples.size() + hop - 1) / hop;
+    FFTBatch<float> batch(n);
+    batch.setWindow(FFTWindow::Hann);
+    batch.setPaired(true);
+    std::vector<float> re(FFT_BATCH_FRAMES / 2 * n), im(FFT_BATCH_FRAMES / 2 * n);
+    std::vector<float> previous(kHigh + 1, 0.0f);
+    std::vector<double> flux;
+
+    for (size_t first = 0; first < frames; first += FFT_BATCH_FRAMES) {
+        size_t batchFrames = std::min(FFT_BATCH_FRAMES, frames - first);
+        size_t pairs = (batchFrames + 1) / 2;
+        for (size_t f = 0; f < 2 * pairs; f++) {
+            float* frame = pairedFrame(re, im, f, n);
+            size_t start = (first + f) * hop;
+            for (size_t i = 0; i < n; i++) {
+                bool inside = f < batchFrames && start + i < wav.samples.size();
+                frame[i] = inside ? wav.samples[start + i] : 0.0f;
+            }
+        }
+        batch.compute(re.data(), im.data(), pairs, FFTDirection::Forward);
+
+        // Half-wave rectified flux over the kick/snare band; frames depend on
+        // the previous one, so this part stays in order
+        for (size_t f = 0; f < batchFrames; f++) {
+            double sum = 0.0;
+            for (uint16_t k = kLow; k <= kHigh; k++) {
+                float magnitude = std::sqrt(binPower(re, im, f, n, k));
+                sum += std::max(0.0f, magnitude - previous[k]);
+                previous[k] = magnitude;
+            }
+            flux.push_back(sum * meta.gain);
+        }
+    }
+    return flux;
+}
+
+// Flux peaks loud enough for a tail flap, returned as times in ms
+std::vector<uint32_t> drumOnsets(const WavData& wav, const std::vector<double>& flux,
+                                 const SongMetadata& meta, const SongOptions& options) {
+    const uint32_t hop = std::max<uint32_t>(1, wav.sampleRate * options.hopMs / 1000);
+    const uint32_t rmsWindow = std::max<uint32_t>(1, wav.sampleRate * options.chunkMs / 1000);
+
+    // Running sum of squares for time-domain RMS at any onset
+    std::vector<double> squares(wav.samples.size() + 1, 0.0);
+    for (size_t i = 0; i < wav.samples.size(); i++) {
+        double s = applyGain(wav.samples[i], meta.gain);
+        squares[i + 1] = squares[i] + s * s;
+    }
+
+    const int context = std::max(1, ONSET_CONTEXT_MS / options.hopMs);
+    const int radius = std::max(1, ONSET_PEAK_MS / options.hopMs);
+    std::vector<uint32_t> onsets;
+
+    for (int i = 0; i < int(flux.size()); i++) {
+        int from = std::max(0, i - context);
+        int to = std::min(int(flux.size()) - 1, i + context);
+        double mean = 0.0;
+        for (int j = from; j <= to; j++) mean += flux[j];
+        mean /= (to - from + 1);
+        if (flux[i] <= mean * ONSET_THRESHOLD_RATIO) continue;
+
+        bool peak = true;
+        for (int j = std::max(0, i - radius); j <= std::min(int(flux.size()) - 1, i + radius); j++) {
+            if (flux[j] > flux[i] || (flux[j] == flux[i] && j < i)) {
+                peak = false;
+                break;
+            }
+        }
+        if (!peak) continue;
+
+        size_t begin = size_t(i) * hop;
+        size_t end = std::min(wav.samples.size(), begin + rmsWindow);
+        double rms = std::sqrt((squares[end] - squares[begin]) / std::max<size_t>(1, end - begin));
+        if (rms > meta.tailThreshold) {
+            onsets.push_back(uint32_t(i) * options.hopMs);
+        }
+    }
+    return onsets;
+}
+
+Track mouthTrack(const std::vector<double>& envelope, const SongOptions& options) {
+    Track track;
+    bool open = false;
+    long lastFlap = -options.minFlapGapMs;
+    long openUntil = 0;
+
+    for (size_t i = 0; i < envelope.size(); i++) {
+        long now = long(i) * options.hopMs;
+        double rms = envelope[i];
+
+        if (rms < options.mouthThreshold / 2 && now >= openUntil) {
+            if (open) track.push_back(keyframe(now, CHOREO_DIR_STOP));
+            open = false;
+            continue;
+        }
+        if (rms <= options.mouthThreshold || now - lastFlap < options.minFlapGapMs) continue;
+
+        double normalized = std::clamp(rms / 32768.0, 0.0, 1.0);
+        double speed = interpolate(normalized, 0.005, 0.15, 25, 100);
+        double durationMs = std::clamp(interpolate(normalized, 0.005, 0.15, 15, 70), 15.0,
+                                       double(options.chunkMs));
+
+        lastFlap = now;
+        openUntil = now + long(durationMs);
+        track.push_back(keyframe(now, CHOREO_DIR_FORWARD, percentToSpeed(speed)));
+        open = true;
+    }
+    if (open) track.push_back(keyframe(uint32_t(envelope.size()) * options.hopMs, CHOREO_DIR_STOP));
+    return track;
+}
+
+Track bodyTrack(const std::vector<uint32_t>& onsets, const SongMetadata& meta,
+                const SongOptions& options) {
+    Track track;
+
+    std::vector<std::pair<uint32_t, uint32_t>> headSpans;
+    for (const auto& move : meta.headMoves) {
+        uint32_t start = uint32_t(std::lround(std::max(0.0, move.first) * 1000));
+        uint32_t end = start + uint32_t(std::lround(std::max(0.0, move.second) * 1000));
+        headSpans.push_back({start, end});
+
+        track.push_back(keyframe(start, CHOREO_DIR_FORWARD, percentToSpeed(options.headSpeedPercent)));
+        if (start + options.headRampMs < end) {
+            track.push_back(keyframe(start + options.headRampMs, CHOREO_DIR_FORWARD, 255));
+        }
+        track.push_back(keyframe(end, CHOREO_DIR_STOP));
+    }
+
+    double beatMs = 60000.0 / (meta.bpm > 0 ? meta.bpm : 120.0);
+    if (meta.halfTempoTailFlap) beatMs *= 2;
+    long leadMs = std::lround(meta.compensateTail * beatMs);
+    long minGapMs = std::max<long>(options.tailDurationMs + options.hopMs, std::lround(0.75 * beatMs));
+
+    long lastFlap = -minGapMs;
+    for (uint32_t onset : onsets) {
+        long start = std::max<long>(0, long(onset) - leadMs);
+        long end = start + options.tailDurationMs;
+        if (start - lastFlap < minGapMs) continue;
+
+        // The head and the tail share the body motor on a two-motor fish
+        bool blocked = false;
+        for (const auto& span : headSpans) {
+            if (start < long(span.second) && end > long(span.first)) blocked = true;
+        }
+        if (blocked) continue;
+
+        track.push_back(keyframe(start, CHOREO_DIR_BACKWARD, percentToSpeed(options.tailSpeedPercent)));
+        track.push_back(keyframe(end, CHOREO_DIR_STOP));
+        lastFlap = start;
+    }
+    return track;
+}
+
+} // namespace
+
+SongMetadata loadSongMetadata(const std::string& path) {
+    SongMetadata meta;
+    std::ifstream in(path);
+    std::string line;
+
+    while (std::getline(in, line)) {
+        size_t split = line.find('=');
+        if (split == std::string::npos) continue;
+        std::string key = line.substr(0, split);
+        std::string value = line.substr(split + 1);
+        key.erase(0, key.find_first_not_of(" \t"));
+        key.erase(key.find_last_not_of(" \t\r") + 1);
+
+        try {
+            if (key == "bpm") {
+                meta.bpm = std::stod(value);
+                meta.hasBpm = true;
+            } else if (key == "gain") {
+                meta.gain = std::stod(value);
+            } else if (key == "tail_threshold") {
+                meta.tailThreshold = std::stod(value);
+            } else if (key == "compensate_tail") {
+                meta.compensateTail = std::stod(value);
+            } else if (key == "half_tempo_tail_flap") {
+                value.erase(0, value.find_first_not_of(" \t"));
+                value.erase(value.find_last_not_of(" \t\r") + 1);
+                std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+                meta.halfTempoTailFlap = value == "true";
+            } else if (key == "head_moves") {
+                std::istringstream moves(value);
+                std::string move;
+                while (std::getline(moves, move, ',')) {
+                    size_t colon = move.find(':');
+                    if (colon == std::string::npos) continue;
+                    meta.headMoves.push_back(
+                        {std::stod(move.substr(0, colon)), std::stod(move.substr(colon + 1))});
+                }
+            }
+        } catch (const std::logic_error&) {
+            throw std::runtime_error(path + ": bad value for " + key);
+        }
+    }
+    return meta;
+}
+
+namespace {
+
+std::vector<TempoCandidate<double>> estimateTempo(const std::vector<double>& flux,
+                                                  const SongOptions& options,
+                                                  size_t maxCandidates) {
+    TempoEstimator<double> estimator(1000.0 / options.hopMs, TEMPO_MIN_BPM, TEMPO_MAX_BPM);
+    size_t maxLag = size_t(std::ceil(60000.0 / options.hopMs / TEMPO_MIN_BPM)) + 1;
+
+    size_t n = 1;
+    while (n < flux.size() + 2 * maxLag) n <<= 1;
+    std::vector<double> re(flux.begin(), flux.end()), im(n);
+    re.resize(n);
+
+    std::vector<TempoCandidate<double>> candidates(std::min<size_t>(maxCandidates, 255));
+    candidates.resize(estimator.estimate(re.data(), im.data(), flux.size(), n, candidates.data(),
+                                         uint8_t(candidates.size())));
+    return candidates;
+}
+
+} // namespace
+
+std::vector<TempoCandidate<double>> estimateSongTempo(const std::string& songDir,
+                                                      const SongOptions& options,
+                                                      size_t maxCandidates) {
+    SongMetadata meta = loadSongMetadata(songDir + "/metadata.txt");
+    WavData drums = readWav(songDir + "/drums.wav");
+    return estimateTempo(drumFlux(drums, meta, options), options, maxCandidates);
+}
+
+std::vector<Track> compileSong(const std::string& songDir, const SongOptions& options) {
+    SongMetadata meta = loadSongMetadata(songDir + "/metadata.txt");
+    WavData vocals = readWav(songDir + "/vocals.wav");
+    WavData drums = readWav(songDir + "/drums.wav");
+    std::vector<double> flux = drumFlux(drums, meta, options);
+
+    // Songs without a bpm line get the strongest estimate instead of 120
+    if (!meta.hasBpm) {
+        std::vector<TempoCandidate<double>> tempo = estimateTempo(flux, options, 1);
+        if (!tempo.empty()) meta.bpm = tempo.front().bpm;
+    }
+
+    std::vector<Track> tracks(CHOREO_TRACK_BODY + 1);
+    tracks[CHOREO_TRACK_MOUTH] = mouthTrack(vocalEnvelope(vocals, meta, options), options);
+    tracks[CHOREO_TRACK_BODY] =
+        bodyTrack(drumOnsets(drums, flux, meta, options), meta, options);
+    return tracks;
+}
@@ -0,0 +1,92 @@
+#ifndef SONGCOMPILER_H
+#define SONGCOMPILER_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ChoreoEncoder.h"
+#include "TempoEstimator.h"
+
+/**
+ * @file SongCompiler.h
+ * @brief Offline stem analysis that turns a song folder into keyframes
+ *
+ * Reads `vocals.wav`, `drums.wav` and `metadata.txt` from a song folder in
+ * the assistant's `sounds/songs/` layout and produces mouth and body tracks:
+ * - mouth: vocal-band envelope, mapped to flaps exactly like
+ *   `flap_from_pcm_chunk()` in `core/movements.py`
+ * - body: head moves from `head_moves`, tail flaps on drum onsets (spectral
+ *   flux) that clear `tail_threshold`, pulled early by `compensate_tail`
+ *
+ * The same drum flux drives the tempo estimate when `bpm` is not given.
+ */
+
+/**
+ * @brief Values read from a song's metadata.txt
+ *
+ * Defaults match `load_song_metadata()` in `core/audio.py`.
+ */
+struct SongMetadata {
+    double bpm = 120.0;                                 ///< Tempo in beats per minute
+    bool hasBpm = false;                                ///< bpm came from the file
+    double gain = 1.0;                                  ///< Stem gain before thresholds
+    double tailThreshold = 1500.0;                      ///< Drum RMS needed for a tail flap
+    double compensateTail = 0.0;                        ///< Tail lead time in beats
+    bool halfTempoTailFlap = false;                     ///< Flap on every second beat
+    std::vector<std::pair<double, double>> headMoves;   ///< (start s, duration s)
+};
+
+/**
+ * @brief Analysis and motion settings
+ *
+ * Defaults match the assistant's constants (`CHUNK_MS`, `DEFAULT_*` motor
+ * values in `core/constants.py`).
+ */
+struct SongOptions {
+    int chunkMs = 50;               ///< Lip-sync window, as CHUNK_MS
+    int hopMs = 10;                 ///< Analysis hop (keyframe time resolution)
+    double mouthThreshold = 1500.0; ///< Vocal RMS that opens the mouth
+    int minFlapGapMs = 100;         ///< Minimum time between mouth flaps
+    int headSpeedPercent = 80;      ///< Head extend speed
+    int headRampMs = 500;           ///< Time at head speed before holding at full power
+    int tailSpeedPercent = 80;      ///< Tail flap speed
+    int tailDurationMs = 200;       ///< Tail flap length
+};
+
+/**
+ * @brief Parse a metadata.txt file; a missing file yields defaults
+ *
+ * @param path Path to metadata.txt
+ */
+SongMetadata loadSongMetadata(const std::string& path);
+
+/**
+ * @brief Estimate a song's tempo from the onset envelope of drums.wav
+ *
+ * Autocorrelation of the drum spectral flux (see TempoEstimator.h); runs in
+ * O(N log N) over the whole song.
+ *
+ * @param songDir Folder containing drums.wav and optionally metadata.txt
+ * @param options Analysis settings (hopMs sets the envelope rate)
+ * @param maxCandidates Number of candidates to return
+ * @return Tempo candidates, strongest first
+ * @throws std::runtime_error if drums.wav cannot be read
+ */
+std::vector<TempoCandidate<double>> estimateSongTempo(const std::string& songDir,
+                                                      const SongOptions& options,
+                                                      size_t maxCandidates = 5);
+
+/**
+ * @brief Analyse a song folder and build its choreography tracks
+ *
+ * A metadata.txt without a `bpm` line uses the strongest tempo estimate.
+ *
+ * @param songDir Folder containing vocals.wav, drums.wav and metadata.txt
+ * @param options Analysis settings
+ * @return Tracks indexed by CHOREO_TRACK_MOUTH and CHOREO_TRACK_BODY
+ * @throws std::runtime_error if a stem cannot be read
+ */
+std::vector<Track> compileSong(const std::string& songDir, const SongOptions& options);
+
+#endif // SONGCOMPILER_H
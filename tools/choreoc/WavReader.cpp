@@ -0,0 +1,71 @@
+#include "WavReader.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+uint32_t readU32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (uint32_t(p[3]) << 24);
+}
+
+uint16_t readU16(const uint8_t* p) {
+    return p[0] | (p[1] << 8);
+}
+
+} // namespace
+
+WavData readWav(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("cannot open " + path);
+
+    uint8_t riff[12];
+    if (!in.read(reinterpret_cast<char*>(riff), sizeof(riff)) ||
+        std::memcmp(riff, "RIFF", 4) || std::memcmp(riff + 8, "WAVE", 4)) {
+        throw std::runtime_error(path + ": not a RIFF/WAVE file");
+    }
+
+    WavData wav;
+    uint16_t bitsPerSample = 0;
+    bool haveFormat = false;
+
+    // Walk the chunk list until the data chunk; fmt must come first
+    uint8_t chunk[8];
+    while (in.read(reinterpret_cast<char*>(chunk), sizeof(chunk))) {
+        uint32_t size = readU32(chunk + 4);
+
+        if (!std::memcmp(chunk, "fmt ", 4)) {
+            std::vector<uint8_t> fmt(size);
+            if (size < 16 || !in.read(reinterpret_cast<char*>(fmt.data()), size)) {
+                throw std::runtime_error(path + ": truncated fmt chunk");
+            }
+            uint16_t format = readU16(&fmt[0]);
+            wav.channels = readU16(&fmt[2]);
+            wav.sampleRate = readU32(&fmt[4]);
+            bitsPerSample = readU16(&fmt[14]);
+            if ((format != 1 && format != 0xFFFE) || bitsPerSample != 16 || wav.channels == 0) {
+                throw std::runtime_error(path + ": only 16-bit PCM is supported");
+            }
+            haveFormat = true;
+        } else if (!std::memcmp(chunk, "data", 4)) {
+            if (!haveFormat) throw std::runtime_error(path + ": data before fmt chunk");
+
+            std::vector<int16_t> pcm(size / sizeof(int16_t));
+            in.read(reinterpret_cast<char*>(pcm.data()), pcm.size() * sizeof(int16_t));
+            pcm.resize(in.gcount() / sizeof(int16_t));
+
+            size_t frames = pcm.size() / wav.channels;
+            wav.samples.resize(frames);
+            for (size_t i = 0; i < frames; i++) {
+                float sum = 0;
+                for (uint16_t c = 0; c < wav.channels; c++) sum += pcm[i * wav.channels + c];
+                wav.samples[i] = sum / wav.channels;
+            }
+            return wav;
+        } else {
+            in.seekg(size + (size & 1), std::ios::cur);
+        }
+    }
+    throw std::runtime_error(path + ": no data chunk");
+}
@@ -0,0 +1,34 @@
+#ifndef WAVREADER_H
+#define WAVREADER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file WavReader.h
+ * @brief Minimal RIFF/WAVE reader for 16-bit PCM song stems
+ */
+
+/**
+ * @brief Decoded WAV file, downmixed to mono
+ */
+struct WavData {
+    uint32_t sampleRate = 0;        ///< Frames per second
+    uint16_t channels = 0;          ///< Channel count of the source file
+    std::vector<float> samples;     ///< Mono samples in int16 units (-32768..32767)
+};
+
+/**
+ * @brief Read a 16-bit PCM WAV file and average its channels
+ *
+ * Mirrors `reshape((-1, channels)).mean(axis=1)` in the assistant's song
+ * playback so thresholds tuned there carry over.
+ *
+ * @param path File to read
+ * @return Decoded mono samples
+ * @throws std::runtime_error if the file is missing or not 16-bit PCM
+ */
+WavData readWav(const std::string& path);
+
+#endif // WAVREADER_H
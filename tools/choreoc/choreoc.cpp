@@ -0,0 +1,281 @@
+/**
+ * @file choreoc.cpp
+ * @brief Choreography compiler for Billy Bass
+ *
+ * Compiles a text timeline into the compact keyframe format described in
+ * ChoreoFormat.h, either as a PROGMEM C header for the firmware or as a raw
+ * binary.
+ *
+ * Timeline syntax, one keyframe per line, `#` starts a comment:
+ * ```
+ * # time_ms  track  direction  [speed]  [easing]
+ * 0          mouth  forward    100
+ * 400        mouth  backward   100
+ * 800        mouth  stop
+ * 2400       body   forward    120      linear
+ * ```
+ * - track: mouth, body, tail or a track number
+ * - direction: forward, backward, stop, end (speed only for forward/backward)
+ * - easing: step (default), linear, in, out
+ *
+ * Song mode analyses song folders offline (vocal envelope for the mouth,
+ * drum onsets and head_moves for the body, see SongCompiler.h) and writes
+ * `choreo.bbc` into each folder. Songs are compiled in parallel. Tempo mode
+ * prints ranked tempo estimates for song folders, e.g. to fill in `bpm`.
+ *
+ * Usage:
+ * ```
+ * choreoc [-n NAME] [-b] [-o OUTPUT] TIMELINE
+ * choreoc --song [-j JOBS] [--chunk-ms MS] SONG_DIR...
+ * choreoc --tempo [-j JOBS] SONG_DIR...
+ * ```
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ChoreoEncoder.h"
+#include "SongCompiler.h"
+
+namespace {
+
+void printUsage() {
+    std::cerr << "Usage: choreoc [-n NAME] [-b] [-o OUTPUT] TIMELINE\n"
+              << "       choreoc --song [-j JOBS] [--chunk-ms MS] SONG_DIR...\n"
+              << "       choreoc --tempo [-j JOBS] SONG_DIR...\n"
+              << "  -n NAME        array name for the C header (default CHOREO_DATA)\n"
+              << "  -b             write a raw binary instead of a C header\n"
+              << "  -o OUTPUT      output file (default stdout)\n"
+              << "  --song         compile song folders into SONG_DIR/choreo.bbc\n"
+              << "  --tempo        print tempo candidates (BPM, strength) for song folders\n"
+              << "  -j JOBS        songs processed in parallel (default: all cores)\n"
+              << "  --chunk-ms MS  lip-sync window, as CHUNK_MS (default 50)\n";
+}
+
+void writeBinary(const std::string& path, const std::vector<uint8_t>& blob) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out || !out.write(reinterpret_cast<const char*>(blob.data()), blob.size())) {
+        throw std::runtime_error("cannot write " + path);
+    }
+}
+
+// Run a task for every song folder on a pool of worker threads; each task
+// returns the line to report for its folder
+int forEachSong(const std::vector<std::string>& songDirs, unsigned jobs,
+                const std::function<std::string(const std::string&)>& task) {
+    std::atomic<size_t> next(0);
+    std::atomic<int> failures(0);
+    std::mutex logMutex;
+
+    auto worker = [&]() {
+        for (size_t i = next++; i < songDirs.size(); i = next++) {
+            const std::string& dir = songDirs[i];
+            try {
+                std::string report = task(dir);
+
+                std::lock_guard<std::mutex> lock(logMutex);
+                std::cout << report << "\n";
+            } catch (const std::exception& e) {
+                failures++;
+                std::lock_guard<std::mutex> lock(logMutex);
+                std::cerr << "choreoc: " << dir << ": " << e.what() << "\n";
+            }
+        }
+    };
+
+    jobs = std::max(1u, std::min<unsigned>(jobs, songDirs.size()));
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < jobs; i++) threads.emplace_back(worker);
+    worker();
+    for (std::thread& thread : threads) thread.join();
+
+    return failures ? 1 : 0;
+}
+
+std::string compileSongFolder(const std::string& dir, const SongOptions& options) {
+    std::vector<uint8_t> blob = encodeChoreography(compileSong(dir, options));
+    writeBinary(dir + "/choreo.bbc", blob);
+    return dir + "/choreo.bbc: " + std::to_string(blob.size()) + " bytes";
+}
+
+std::string reportSongTempo(const std::string& dir, const SongOptions& options) {
+    std::ostringstream report;
+    report << dir << ":" << std::fixed;
+    for (const TempoCandidate<double>& candidate : estimateSongTempo(dir, options)) {
+        report << " " << std::setprecision(1) << candidate.bpm << " ("
+               << std::setprecision(2) << candidate.strength << ")";
+    }
+    return report.str();
+}
+
+int parseTrack(const std::string& token) {
+    if (token == "mouth") return CHOREO_TRACK_MOUTH;
+    if (token == "body" || token == "head") return CHOREO_TRACK_BODY;
+    if (token == "tail") return CHOREO_TRACK_TAIL;
+
+    char* end = nullptr;
+    long track = std::strtol(token.c_str(), &end, 10);
+    if (*end != '\0' || track < 0 || track > 254) {
+        throw std::runtime_error("unknown track '" + token + "'");
+    }
+    return static_cast<int>(track);
+}
+
+uint8_t parseDirection(const std::string& token) {
+    if (token == "forward") return CHOREO_DIR_FORWARD;
+    if (token == "backward") return CHOREO_DIR_BACKWARD;
+    if (token == "stop") return CHOREO_DIR_STOP;
+    if (token == "end") return CHOREO_DIR_END;
+    throw std::runtime_error("unknown direction '" + token + "'");
+}
+
+uint8_t parseEasing(const std::string& token) {
+    if (token == "step") return CHOREO_EASE_STEP;
+    if (token == "linear") return CHOREO_EASE_LINEAR;
+    if (token == "in") return CHOREO_EASE_IN;
+    if (token == "out") return CHOREO_EASE_OUT;
+    throw std::runtime_error("unknown easing '" + token + "'");
+}
+
+std::vector<Track> parseTimeline(std::istream& in) {
+    std::vector<Track> tracks;
+    std::string line;
+    int lineNumber = 0;
+
+    while (std::getline(in, line)) {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+
+        std::istringstream fields(line);
+        std::vector<std::string> tokens;
+        for (std::string token; fields >> token;) tokens.push_back(token);
+        if (tokens.empty()) continue;
+
+        try {
+            if (tokens.size() < 3) {
+                throw std::runtime_error("expected: time_ms track direction [speed] [easing]");
+            }
+
+            Keyframe key;
+            char* end = nullptr;
+            unsigned long time = std::strtoul(tokens[0].c_str(), &end, 10);
+            if (*end != '\0') throw std::runtime_error("bad time '" + tokens[0] + "'");
+            key.timeMs = static_cast<uint32_t>(time);
+
+            int track = parseTrack(tokens[1]);
+            key.direction = parseDirection(tokens[2]);
+
+            size_t next = 3;
+            if (key.direction == CHOREO_DIR_FORWARD || key.direction == CHOREO_DIR_BACKWARD) {
+                if (tokens.size() <= next) throw std::runtime_error("missing speed");
+                long speed = std::strtol(tokens[next].c_str(), &end, 10);
+                if (*end != '\0' || speed < 0 || speed > 255) {
+                    throw std::runtime_error("speed must be 0-255");
+                }
+                key.speed = static_cast<uint8_t>(speed);
+                next++;
+            }
+            if (tokens.size() > next) key.easing = parseEasing(tokens[next++]);
+            if (tokens.size() > next) throw std::runtime_error("trailing '" + tokens[next] + "'");
+
+            if (tracks.size() <= static_cast<size_t>(track)) tracks.resize(track + 1);
+            tracks[track].push_back(key);
+        } catch (const std::runtime_error& e) {
+            throw std::runtime_error("line " + std::to_string(lineNumber) + ": " + e.what());
+        }
+    }
+
+    if (tracks.empty()) throw std::runtime_error("timeline has no keyframes");
+    return tracks;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string name = "CHOREO_DATA";
+    std::string output;
+    std::vector<std::string> inputs;
+    bool binary = false;
+    bool song = false;
+    bool tempo = false;
+    unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+    SongOptions options;
+
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "-n") && i + 1 < argc) {
+            name = argv[++i];
+        } else if (!std::strcmp(argv[i], "-o") && i + 1 < argc) {
+            output = argv[++i];
+        } else if (!std::strcmp(argv[i], "-b")) {
+            binary = true;
+        } else if (!std::strcmp(argv[i], "--song")) {
+            song = true;
+        } else if (!std::strcmp(argv[i], "--tempo")) {
+            tempo = true;
+        } else if (!std::strcmp(argv[i], "-j") && i + 1 < argc) {
+            jobs = std::max(1, std::atoi(argv[++i]));
+        } else if (!std::strcmp(argv[i], "--chunk-ms") && i + 1 < argc) {
+            options.chunkMs = std::max(options.hopMs, std::atoi(argv[++i]));
+        } else if (argv[i][0] != '-') {
+            inputs.push_back(argv[i]);
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+    if (inputs.empty() || (song && tempo) || (!song && !tempo && inputs.size() > 1)) {
+        printUsage();
+        return 1;
+    }
+    if (song) {
+        return forEachSong(inputs, jobs, [&](const std::string& dir) {
+            return compileSongFolder(dir, options);
+        });
+    }
+    if (tempo) {
+        return forEachSong(inputs, jobs, [&](const std::string& dir) {
+            return reportSongTempo(dir, options);
+        });
+    }
+
+    const std::string& input = inputs.front();
+    try {
+        std::ifstream in(input);
+        if (!in) throw std::runtime_error("cannot open " + input);
+        std::vector<uint8_t> blob = encodeChoreography(parseTimeline(in));
+
+        if (binary && !output.empty()) {
+            writeBinary(output, blob);
+        } else {
+            std::ofstream file;
+            if (!output.empty()) {
+                file.open(output);
+                if (!file) throw std::runtime_error("cannot write " + output);
+            }
+            std::ostream& out = output.empty() ? std::cout : file;
+
+            if (binary) {
+                out.write(reinterpret_cast<const char*>(blob.data()), blob.size());
+            } else {
+                writeChoreographyHeader(out, blob, name, input);
+            }
+        }
+        std::cerr << input << ": " << blob.size() << " bytes\n";
+    } catch (const std::exception& e) {
+        std::cerr << "choreoc: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
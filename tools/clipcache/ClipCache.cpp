@@ -0,0 +1,115 @@
+#include "ClipCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "LipSync.h"
+#include "MappedWav.h"
+#include "PolyphaseResampler.h"
+
+namespace {
+
+/// Mono float at the output rate, aligned with the input
+std::vector<float> decodeMono(const MappedWav& wav, uint32_t outputRate) {
+    const size_t frames = wav.frames();
+    const uint16_t channels = wav.channels();
+    std::vector<float> mono(frames);
+    const int16_t* samples = wav.data();
+    for (size_t i = 0; i < frames; i++) {
+        int32_t sum = 0;
+        for (uint16_t c = 0; c < channels; c++) sum += samples[i * channels + c];
+        mono[i] = float(sum) / channels;
+    }
+    if (wav.sampleRate() == outputRate) {
+        return mono;
+    }
+
+    PolyphaseResampler<float> resampler(wav.sampleRate(), outputRate);
+    const size_t wanted = size_t(uint64_t(frames) * outputRate / wav.sampleRate());
+    const size_t delay = resampler.delay();
+    // Zeros after the clip flush the filter's delay out
+    size_t flush = (delay + 1) * wav.sampleRate() / outputRate + 1;
+    mono.resize(frames + flush, 0.0f);
+
+    std::vector<float> output(resampler.maxOutput(mono.size()));
+    size_t produced = resampler.process(mono.data(), mono.size(), output.data());
+    size_t start = std::min(delay, produced);
+    output.erase(output.begin(), output.begin() + start);
+    output.resize(std::min(wanted, produced - start));
+    return output;
+}
+
+} // namespace
+
+ClipCache::ClipCache(const ClipCacheConfig& config) : _config(config) {
+    if (!_config.outputRate || !_config.chunkMs) {
+        throw std::runtime_error("output rate and chunk length must not be 0");
+    }
+}
+
+size_t ClipCache::add(const std::string& path) {
+    MappedWav wav(path);
+    std::vector<float> mono = decodeMono(wav, _config.outputRate);
+
+    double sumSquares = 0;
+    float peak = 0;
+    for (float v : mono) {
+        sumSquares += double(v) * v;
+        peak = std::max(peak, std::fabs(v));
+    }
+    float gain = 1.0f;
+    if (!mono.empty() && sumSquares > 0) {
+        float rms = float(std::sqrt(sumSquares / mono.size()));
+        gain = std::min(_config.targetRms / rms, _config.peakLimit / peak);
+    }
+
+    std::vector<int16_t> scaled(mono.size());
+    for (size_t i = 0; i < mono.size(); i++) {
+        float v = std::min(std::max(std::round(mono[i] * gain), -32768.0f), 32767.0f);
+        scaled[i] = int16_t(v);
+    }
+
+    Clip clip;
+    clip.offset = _arena.size() / 2;
+    clip.frames = scaled.size();
+
+    LipSyncConfig lipSyncConfig;
+    lipSyncConfig.threshold = _config.threshold;
+    lipSyncConfig.minFlapGapMs = _config.minFlapGapMs;
+    LipSync lipSync(lipSyncConfig);
+    const size_t chunk = size_t(_config.outputRate) * _config.chunkMs / 1000;
+    for (size_t first = 0; first < scaled.size(); first += chunk) {
+        uint16_t count = uint16_t(std::min(chunk, scaled.size() - first));
+        uint32_t nowMs = uint32_t(uint64_t(first) * 1000 / _config.outputRate);
+        LipSyncCommand command = lipSync.process(&scaled[first], count, nowMs, _config.chunkMs);
+        if (command.mouth != LIPSYNC_MOUTH_HOLD) {
+            ClipKeyframe key;
+            key.frame = uint32_t(first);
+            key.mouth = command.mouth;
+            key.mouthSpeed = command.mouthSpeed;
+            key.mouthMs = command.mouthMs;
+            clip.keyframes.push_back(key);
+        }
+    }
+
+    _arena.reserve(_arena.size() + scaled.size() * 2);
+    for (int16_t s : scaled) {
+        _arena.push_back(s);
+        _arena.push_back(s);
+    }
+    _clips.push_back(std::move(clip));
+    return _clips.size() - 1;
+}
+
+const int16_t* ClipCache::samples(size_t clip) const {
+    return _arena.data() + _clips.at(clip).offset * 2;
+}
+
+size_t ClipCache::frames(size_t clip) const {
+    return _clips.at(clip).frames;
+}
+
+const std::vector<ClipKeyframe>& ClipCache::keyframes(size_t clip) const {
+    return _clips.at(clip).keyframes;
+}
@@ -0,0 +1,86 @@
+#ifndef CLIPCACHE_H
+#define CLIPCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file ClipCache.h
+ * @brief Short clips decoded once, ready to write to the sound card
+ */
+
+/**
+ * @brief A mouth command at a frame of a cached clip
+ *
+ * Only the frames where LipSync changes the mouth get one; in between the
+ * mouth holds.
+ */
+struct ClipKeyframe {
+    uint32_t frame = 0;         ///< Output frame from the start of the clip
+    uint8_t mouth = 0;          ///< LIPSYNC_MOUTH_OPEN or LIPSYNC_MOUTH_STOP
+    uint8_t mouthSpeed = 0;
+    uint16_t mouthMs = 0;
+};
+static_assert(sizeof(ClipKeyframe) == 8, "ClipKeyframe is shared with ctypes");
+
+/**
+ * @brief How clips are converted when they are added
+ */
+struct ClipCacheConfig {
+    uint32_t outputRate = 48000;    ///< Rate of the output stream
+    uint16_t chunkMs = 50;          ///< Mouth analysis frame, as CHUNK_MS
+    uint16_t targetRms = 3000;      ///< Loudness every clip is brought to, twice threshold
+    uint16_t peakLimit = 29490;     ///< Gain is lowered to keep peaks below this
+    uint16_t threshold = 1500;      ///< LipSync threshold, as flap_from_pcm_chunk()
+    uint16_t minFlapGapMs = 100;
+};
+
+/**
+ * @brief One arena of interleaved stereo int16 at the output rate
+ *
+ * add() maps a 16-bit WAV, downmixes it, resamples it to the output rate
+ * (the delay of the polyphase filter is removed, so frame 0 is the clip's
+ * first sample), scales it to targetRms without letting a peak pass
+ * peakLimit, and appends it to the arena as stereo. The mouth is analysed
+ * on the same signal with the LipSync rules of live speech, and its
+ * commands are kept as keyframes. The playback volume is left to the
+ * player, so it can change without reloading the cache.
+ *
+ * Playing a clip is then only writing a slice of the arena and firing the
+ * keyframes that fall in it. The arena grows while clips are added; take
+ * pointers only once loading is over.
+ */
+class ClipCache {
+public:
+    explicit ClipCache(const ClipCacheConfig& config = ClipCacheConfig());
+
+    /**
+     * @brief Decode a clip into the arena
+     * @return Its index
+     * @throws std::runtime_error if the file is not 16-bit PCM WAV
+     */
+    size_t add(const std::string& path);
+
+    size_t count() const { return _clips.size(); }
+    const ClipCacheConfig& config() const { return _config; }
+
+    /// First stereo frame of a clip; valid until the next add()
+    const int16_t* samples(size_t clip) const;
+    size_t frames(size_t clip) const;
+    const std::vector<ClipKeyframe>& keyframes(size_t clip) const;
+
+private:
+    struct Clip {
+        size_t offset;      ///< First frame in _arena
+        size_t frames;
+        std::vector<ClipKeyframe> keyframes;
+    };
+
+    ClipCacheConfig _config;
+    std::vector<int16_t> _arena;
+    std::vector<Clip> _clips;
+};
+
+#endif // CLIPCACHE_H
@@ -0,0 +1,63 @@
+#include "ClipCacheC.h"
+#include "ClipCache.h"
+
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+
+struct clip_cache {
+    std::unique_ptr<ClipCache> cache;
+};
+
+static_assert(sizeof(clip_keyframe) == sizeof(ClipKeyframe),
+              "clip_keyframe must mirror ClipKeyframe");
+
+extern "C" {
+
+clip_cache *clip_cache_create(uint32_t output_rate, uint16_t chunk_ms) {
+    try {
+        ClipCacheConfig config;
+        config.outputRate = output_rate;
+        config.chunkMs = chunk_ms;
+        return new clip_cache{std::make_unique<ClipCache>(config)};
+    } catch (const std::exception& e) {
+        fprintf(stderr, "clip_cache: %s\n", e.what());
+        return nullptr;
+    }
+}
+
+void clip_cache_destroy(clip_cache *cache) {
+    delete cache;
+}
+
+long clip_cache_add(clip_cache *cache, const char *path) {
+    try {
+        return long(cache->cache->add(path));
+    } catch (const std::exception& e) {
+        fprintf(stderr, "clip_cache: %s\n", e.what());
+        return -1;
+    }
+}
+
+size_t clip_cache_count(const clip_cache *cache) {
+    return cache->cache->count();
+}
+
+const int16_t *clip_cache_samples(const clip_cache *cache, size_t clip) {
+    return clip < cache->cache->count() ? cache->cache->samples(clip) : nullptr;
+}
+
+size_t clip_cache_frames(const clip_cache *cache, size_t clip) {
+    return clip < cache->cache->count() ? cache->cache->frames(clip) : 0;
+}
+
+const clip_keyframe *clip_cache_keyframes(const clip_cache *cache, size_t clip, size_t *count) {
+    *count = 0;
+    if (clip >= cache->cache->count()) {
+        return nullptr;
+    }
+    const std::vector<ClipKeyframe>& keys = cache->cache->keyframes(clip);
+    *count = keys.size();
+    return reinterpret_cast<const clip_keyframe*>(keys.data());
+}
+}
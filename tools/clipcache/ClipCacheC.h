@@ -0,0 +1,43 @@
+#ifndef CLIPCACHEC_H
+#define CLIPCACHEC_H
+
+/**
+ * @file ClipCacheC.h
+ * @brief C interface to ClipCache, loaded by the assistant with ctypes
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct clip_cache clip_cache;
+
+/// Layout of ClipKeyframe
+typedef struct clip_keyframe {
+    uint32_t frame;
+    uint8_t mouth;
+    uint8_t mouth_speed;
+    uint16_t mouth_ms;
+} clip_keyframe;
+
+/// NULL after printing the error to stderr
+clip_cache *clip_cache_create(uint32_t output_rate, uint16_t chunk_ms);
+void clip_cache_destroy(clip_cache *cache);
+
+/// Index of the decoded clip, or -1 after printing the error to stderr
+long clip_cache_add(clip_cache *cache, const char *path);
+size_t clip_cache_count(const clip_cache *cache);
+
+/// Interleaved stereo frames, valid until the next clip_cache_add(); NULL for a bad index
+const int16_t *clip_cache_samples(const clip_cache *cache, size_t clip);
+size_t clip_cache_frames(const clip_cache *cache, size_t clip);
+const clip_keyframe *clip_cache_keyframes(const clip_cache *cache, size_t clip, size_t *count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CLIPCACHEC_H
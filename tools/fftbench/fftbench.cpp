@@ -0,0 +1,334 @@
+/**
+ * @file fftbench.cpp
+ * @brief Host benchmark and accuracy check for the ArduinoFFT kernels
+ *
+ * Times compute() for every FFTAlgorithm at N = 64...4096 (powers of two) for
+ * float and double, and compares each result with a long double reference
+ * DFT of the same input. The Simd kernel uses the instruction set the
+ * benchmark is compiled for; add -march=native to get AVX.
+ *
+ * The error is the largest bin error relative to the largest bin magnitude.
+ * Exits with status 1 when a kernel exceeds the tolerance for its type, so it
+ * can double as a regression check.
+ *
+ * A second table covers chunk lengths that are not powers of two (40 and
+ * 50 ms at 24 kHz, and a prime) through the mixed-radix and Bluestein
+ * paths, next to the time of zero-padding the same chunk to a power of two.
+ * Then every kernel transforms N = 65536 against the exact spectrum of
+ * integer-bin tones. Only the Simd kernel is held to the tolerance there: the
+ * twiddle recurrence of the others runs out of float precision at that size.
+ *
+ * A third table runs FFTBatch over a block of 1024-point float frames with
+ * 1, 2, 4... pool threads up to the hardware thread count and reports frames
+ * per second, to show how whole-song analysis scales with cores.
+ *
+ * Usage:
+ * ```
+ * fftbench [--min N] [--max N] [--ms MS] [--frames F]
+ * ```
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "arduinoFFT.h"
+#include "FFTBatch.h"
+#include "FFTMixedRadix.h"
+#include "FFTVector.h"
+
+namespace {
+
+struct Kernel {
+    FFTAlgorithm algorithm;
+    const char* name;
+};
+
+const Kernel KERNELS[] = {
+    {FFTAlgorithm::Radix2, "radix2"},
+    {FFTAlgorithm::Radix4, "radix4"},
+    {FFTAlgorithm::Simd, "simd"},
+};
+
+const uint_fast16_t BATCH_SAMPLES = 1024;
+
+// Past what a 16-bit index holds
+const size_t LARGE_SAMPLES = 65536;
+
+// 40 and 50 ms at 24 kHz, then a prime that needs Bluestein
+const uint32_t CHUNK_SAMPLES[] = {960, 1200, 1201};
+
+// Largest acceptable error relative to the peak bin; the library's twiddle
+// recurrence costs a few bits at large N
+double tolerance(bool isFloat) { return isFloat ? 5e-3 : 1e-9; }
+
+void printUsage() {
+    std::cerr << "Usage: fftbench [--min N] [--max N] [--ms MS] [--frames F]\n"
+              << "  --min N     smallest FFT size (default 64)\n"
+              << "  --max N     largest FFT size (default 4096)\n"
+              << "  --ms MS     time spent per measurement (default 200)\n"
+              << "  --frames F  frames per FFTBatch call, 0 to skip (default 4096)\n";
+}
+
+// Reference forward DFT in long double
+void referenceDft(const std::vector<long double>& input, std::vector<long double>& re,
+                  std::vector<long double>& im) {
+    const size_t n = input.size();
+    const long double pi = std::acos(-1.0L);
+    re.assign(n, 0);
+    im.assign(n, 0);
+    for (size_t k = 0; k < n; k++) {
+        for (size_t t = 0; t < n; t++) {
+            long double angle = -2 * pi * ((k * t) % n) / n;
+            re[k] += input[t] * std::cos(angle);
+            im[k] += input[t] * std::sin(angle);
+        }
+    }
+}
+
+template <typename T>
+double relativeError(const std::vector<T>& re, const std::vector<T>& im,
+                     const std::vector<long double>& refRe, const std::vector<long double>& refIm) {
+    long double worst = 0, peak = 0;
+    for (size_t k = 0; k < re.size(); k++) {
+        long double dr = re[k] - refRe[k], di = im[k] - refIm[k];
+        worst = std::max(worst, std::sqrt(dr * dr + di * di));
+        peak = std::max(peak, std::sqrt(refRe[k] * refRe[k] + refIm[k] * refIm[k]));
+    }
+    return peak > 0 ? double(worst / peak) : double(worst);
+}
+
+// Mean microseconds per forward FFT of input, including the copy into the
+// work arrays that every real caller also pays
+template <typename T>
+double timeKernel(ArduinoFFT<T>& fft, const std::vector<T>& input, int ms) {
+    const size_t n = input.size();
+    std::vector<T> re(n), im(n);
+    auto run = [&]() {
+        std::copy(input.begin(), input.end(), re.begin());
+        std::fill(im.begin(), im.end(), T(0));
+        fft.compute(re.data(), im.data(), uint_fast16_t(n), FFTDirection::Forward);
+    };
+    run();  // warm up caches
+    using Clock = std::chrono::steady_clock;
+    const auto budget = std::chrono::milliseconds(ms);
+    long iterations = 0;
+    auto start = Clock::now();
+    auto now = start;
+    do {
+        for (int i = 0; i < 16; i++) run();
+        iterations += 16;
+        now = Clock::now();
+    } while (now - start < budget);
+    volatile T sink = re[1];
+    (void)sink;
+    return std::chrono::duration<double, std::micro>(now - start).count() / iterations;
+}
+
+template <typename T>
+bool benchType(const char* typeName, size_t minN, size_t maxN, int ms) {
+    bool ok = true;
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<double> noise(-1.0, 1.0);
+    for (size_t n = minN; n <= maxN; n <<= 1) {
+        std::vector<long double> signal(n);
+        for (size_t i = 0; i < n; i++) {
+            signal[i] = std::sin(2 * M_PI * 37.3 * i / n) + 0.25 * noise(rng);
+        }
+        std::vector<long double> refRe, refIm;
+        referenceDft(signal, refRe, refIm);
+        std::vector<T> input(signal.begin(), signal.end());
+
+        double baseline = 0;
+        for (const Kernel& kernel : KERNELS) {
+            ArduinoFFT<T> fft;
+            fft.setAlgorithm(kernel.algorithm);
+
+            std::vector<T> re(input), im(n, T(0));
+            fft.compute(re.data(), im.data(), uint_fast16_t(n), FFTDirection::Forward);
+            double error = relativeError(re, im, refRe, refIm);
+            bool pass = error <= tolerance(sizeof(T) == sizeof(float));
+            ok = ok && pass;
+
+            double us = timeKernel(fft, input, ms);
+            if (baseline == 0) baseline = us;
+            std::cout << std::left << std::setw(8) << typeName << std::right << std::setw(6) << n
+                      << "  " << std::left << std::setw(8) << kernel.name << std::right
+                      << std::fixed << std::setprecision(2) << std::setw(10) << us << " us"
+                      << std::setw(8) << baseline / us << "x" << std::scientific
+                      << std::setprecision(2) << std::setw(12) << error
+                      << (pass ? "" : "  FAIL") << std::defaultfloat << "\n";
+        }
+    }
+    return ok;
+}
+
+// Native-length transforms of chunk-sized frames against zero-padding them
+// to the next power of two for the Simd kernel
+template <typename T>
+bool benchChunks(const char* typeName, int ms) {
+    bool ok = true;
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<double> noise(-1.0, 1.0);
+    std::cout << "\ntype         N  kernel         time    padded   rel.error\n";
+    for (uint32_t n : CHUNK_SAMPLES) {
+        std::vector<long double> signal(n);
+        for (size_t i = 0; i < n; i++) {
+            signal[i] = std::sin(2 * M_PI * 37.3 * i / n) + 0.25 * noise(rng);
+        }
+        std::vector<long double> refRe, refIm;
+        referenceDft(signal, refRe, refIm);
+        std::vector<T> input(signal.begin(), signal.end());
+
+        ArduinoFFT<T> fft;
+        fft.setAlgorithm(FFTAlgorithm::Simd);
+        std::vector<T> re(input), im(n, T(0));
+        fft.compute(re.data(), im.data(), uint_fast16_t(n), FFTDirection::Forward);
+        double error = relativeError(re, im, refRe, refIm);
+        bool pass = error <= tolerance(sizeof(T) == sizeof(float));
+        ok = ok && pass;
+
+        size_t padded = 1;
+        while (padded < n) padded <<= 1;
+        std::vector<T> paddedInput(input);
+        paddedInput.resize(padded, T(0));
+
+        double us = timeKernel(fft, input, ms);
+        double paddedUs = timeKernel(fft, paddedInput, ms);
+        const char* kernel =
+            FFTMixedRadix<T>::cached(n).usesBluestein() ? "bluestein" : "mixed";
+        std::cout << std::left << std::setw(8) << typeName << std::right << std::setw(6) << n
+                  << "  " << std::left << std::setw(9) << kernel << std::right << std::fixed
+                  << std::setprecision(2) << std::setw(9) << us << " us" << std::setw(7)
+                  << paddedUs << " us" << std::scientific << std::setprecision(2)
+                  << std::setw(12) << error << (pass ? "" : "  FAIL") << std::defaultfloat
+                  << "\n";
+    }
+    return ok;
+}
+
+// Every kernel at LARGE_SAMPLES, with only Simd checked against the
+// tolerance. A direct DFT would be too slow here, so the input is two tones
+// on exact bins whose spectrum is known in closed form.
+template <typename T>
+bool benchLarge(const char* typeName, int ms) {
+    const size_t n = LARGE_SAMPLES;
+    const size_t sineBin = 1031, cosineBin = 7919;
+    std::vector<T> input(n);
+    std::vector<long double> refRe(n, 0), refIm(n, 0);
+    const long double pi = std::acos(-1.0L);
+    for (size_t i = 0; i < n; i++) {
+        input[i] = T(std::sin(2 * pi * ((sineBin * i) % n) / n) +
+                     0.5L * std::cos(2 * pi * ((cosineBin * i) % n) / n));
+    }
+    refIm[sineBin] = -0.5L * n;
+    refIm[n - sineBin] = 0.5L * n;
+    refRe[cosineBin] = refRe[n - cosineBin] = 0.25L * n;
+
+    bool ok = true;
+    double baseline = 0;
+    for (const Kernel& kernel : KERNELS) {
+        ArduinoFFT<T> fft;
+        fft.setAlgorithm(kernel.algorithm);
+        std::vector<T> re(input), im(n, T(0));
+        fft.compute(re.data(), im.data(), uint_fast16_t(n), FFTDirection::Forward);
+        double error = relativeError(re, im, refRe, refIm);
+        bool pass = kernel.algorithm != FFTAlgorithm::Simd ||
+                    error <= tolerance(sizeof(T) == sizeof(float));
+        ok = ok && pass;
+
+        double us = timeKernel(fft, input, ms);
+        if (baseline == 0) baseline = us;
+        std::cout << std::left << std::setw(8) << typeName << std::right << std::setw(6) << n
+                  << "  " << std::left << std::setw(8) << kernel.name << std::right
+                  << std::fixed << std::setprecision(2) << std::setw(10) << us << " us"
+                  << std::setw(8) << baseline / us << "x" << std::scientific
+                  << std::setprecision(2) << std::setw(12) << error
+                  << (pass ? "" : "  FAIL") << std::defaultfloat << "\n";
+    }
+    return ok;
+}
+
+// Best frames per second of FFTBatch over frames Hann-windowed magnitude
+// frames, as an STFT of a song would run, for each pool size
+void benchBatch(uint32_t frames, int ms) {
+    const size_t n = BATCH_SAMPLES;
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+    std::vector<float> input(frames * n);
+    for (float& sample : input) sample = noise(rng);
+    std::vector<float> re(frames * n), im(frames * n);
+
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    double single = 0;
+    std::cout << "\ntype         N  frames  threads     frames/s   scaling\n";
+    for (unsigned threads = 1;; threads = std::min(threads * 2, hardware)) {
+        FFTThreadPool pool(threads);
+        FFTBatch<float> batch(uint_fast16_t(n), &pool);
+        batch.setWindow(FFTWindow::Hann);
+        batch.setMagnitudeOutput(true);
+
+        double best = 0;
+        using Clock = std::chrono::steady_clock;
+        auto start = Clock::now();
+        do {
+            std::copy(input.begin(), input.end(), re.begin());
+            std::fill(im.begin(), im.end(), 0.0f);
+            batch.compute(re.data(), im.data(), frames, FFTDirection::Forward);
+            best = std::max(best, batch.framesPerSecond());
+        } while (Clock::now() - start < std::chrono::milliseconds(ms));
+        if (single == 0) single = best;
+
+        std::cout << std::left << std::setw(8) << "float" << std::right << std::setw(6) << n
+                  << std::setw(8) << frames << std::setw(9) << threads
+                  << std::fixed << std::setprecision(0) << std::setw(13) << best
+                  << std::setprecision(2) << std::setw(9) << best / single << "x"
+                  << std::defaultfloat << "\n";
+        if (threads == hardware) break;
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t minN = 64, maxN = 4096;
+    int ms = 200;
+    uint32_t frames = 4096;
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && std::strcmp(argv[i], "--min") == 0) {
+            minN = std::strtoul(argv[++i], nullptr, 10);
+        } else if (i + 1 < argc && std::strcmp(argv[i], "--max") == 0) {
+            maxN = std::strtoul(argv[++i], nullptr, 10);
+        } else if (i + 1 < argc && std::strcmp(argv[i], "--ms") == 0) {
+            ms = std::atoi(argv[++i]);
+        } else if (i + 1 < argc && std::strcmp(argv[i], "--frames") == 0) {
+            frames = std::strtoul(argv[++i], nullptr, 10);
+        } else {
+            printUsage();
+            return 2;
+        }
+    }
+    if (minN < 4 || (minN & (minN - 1)) || maxN > 32768 || ms <= 0) {
+        std::cerr << "fftbench: sizes must be powers of two from 4 to 32768\n";
+        return 2;
+    }
+
+    std::cout << "simd backend: " << FFT_VECTOR_NAME << "\n";
+    std::cout << "type         N  kernel         time   speedup   rel.error\n";
+    bool ok = benchType<float>("float", minN, maxN, ms);
+    ok = benchType<double>("double", minN, maxN, ms) && ok;
+    ok = benchChunks<float>("float", ms) && ok;
+    ok = benchChunks<double>("double", ms) && ok;
+    std::cout << "\ntype         N  kernel         time   speedup   rel.error\n";
+    ok = benchLarge<float>("float", ms) && ok;
+    ok = benchLarge<double>("double", ms) && ok;
+    if (frames > 0) benchBatch(frames, ms);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+#include "MicFrontEnd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include "Base64.h"
+
+namespace {
+
+// As json.dumps() writes it in send_mic_audio()
+const char PREFIX[] = "{\"type\": \"input_audio_buffer.append\", \"audio\": \"";
+const char SUFFIX[] = "\"}";
+const size_t PREFIX_LENGTH = sizeof(PREFIX) - 1;
+const size_t SUFFIX_LENGTH = sizeof(SUFFIX) - 1;
+
+} // namespace
+
+MicFrontEnd::MicFrontEnd(const MicFrontEndConfig& config)
+    : _config(config), _resampler(config.inputRate, config.outputRate) {
+    if (!_config.channels) {
+        throw std::runtime_error("a capture stream needs at least one channel");
+    }
+    _message.assign(PREFIX, PREFIX + PREFIX_LENGTH);
+}
+
+const MicPacket& MicFrontEnd::process(const int16_t* block, size_t frames) {
+    if (_mono.size() < frames) {
+        _mono.resize(frames);
+    }
+
+    // DC removal and the sum of squares in one pass over the capture buffer
+    const size_t channels = _config.channels;
+    const float pole = _config.dcPole;
+    float dcIn = _dcIn;
+    float dcOut = _dcOut;
+    double sumSquares = 0.0;
+    for (size_t i = 0; i < frames; i++) {
+        float x = block[i * channels];
+        dcOut = x - dcIn + pole * dcOut;
+        dcIn = x;
+        _mono[i] = dcOut;
+        sumSquares += double(dcOut) * dcOut;
+    }
+    _dcIn = dcIn;
+    _dcOut = dcOut;
+
+    _packet.rms = frames ? float(std::sqrt(sumSquares / frames)) : 0.0f;
+    if (_packet.rms > _config.threshold) {
+        _hangover = size_t(_config.hangoverMs) * _config.inputRate / 1000;
+        _packet.voice = true;
+    } else {
+        _packet.voice = _hangover > 0;
+        _hangover -= std::min(_hangover, frames);
+    }
+
+    // Resample, then round to the 16-bit little-endian PCM the API expects
+    size_t capacity = _resampler.maxOutput(frames);
+    if (_resampled.size() < capacity) {
+        _resampled.resize(capacity);
+        _pcm.resize(capacity);
+    }
+    size_t samples = _resampler.process(_mono.data(), frames, _resampled.data());
+    for (size_t i = 0; i < samples; i++) {
+        float y = std::nearbyint(_resampled[i]);
+        _pcm[i] = int16_t(std::min(32767.0f, std::max(-32768.0f, y)));
+    }
+
+    // Encode after the envelope that stays at the start of _message
+    size_t bytes = samples * sizeof(int16_t);
+    size_t length = PREFIX_LENGTH + base64EncodedSize(bytes) + SUFFIX_LENGTH;
+    if (_message.size() < length) {
+        _message.resize(length);
+    }
+    char* audio = _message.data() + PREFIX_LENGTH;
+    audio += base64Encode(reinterpret_cast<const uint8_t*>(_pcm.data()), bytes, audio);
+    std::memcpy(audio, SUFFIX, SUFFIX_LENGTH);
+
+    _packet.samples = samples;
+    _packet.message = _message.data();
+    _packet.length = length;
+    return _packet;
+}
+
+void MicFrontEnd::reset() {
+    _resampler.reset();
+    _dcIn = 0.0f;
+    _dcOut = 0.0f;
+    _hangover = 0;
+}
@@ -0,0 +1,74 @@
+#ifndef MICFRONTEND_H
+#define MICFRONTEND_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "PolyphaseResampler.h"
+
+/**
+ * @file MicFrontEnd.h
+ * @brief Microphone blocks to ready-to-send realtime API messages
+ */
+
+/**
+ * @brief How the capture stream is turned into packets
+ */
+struct MicFrontEndConfig {
+    uint32_t inputRate = 48000;     ///< Capture rate (MIC_RATE)
+    uint32_t outputRate = 24000;    ///< Rate the realtime API expects
+    uint16_t channels = 1;          ///< Interleaved channels per frame; channel 0 is used
+    uint16_t threshold = 2000;      ///< RMS above which a block is voice (SILENCE_THRESHOLD)
+    uint16_t hangoverMs = 300;      ///< Voice is held this long after the last loud block
+    float dcPole = 0.995f;          ///< DC blocker pole, about 40 Hz at 48 kHz
+};
+
+/**
+ * @brief Result of one block, valid until the next process()
+ */
+struct MicPacket {
+    float rms = 0.0f;               ///< Level of the block after DC removal
+    bool voice = false;             ///< Above threshold, or within the hangover
+    size_t samples = 0;             ///< 16-bit samples in the message
+    const char* message = nullptr;  ///< `input_audio_buffer.append` JSON, not terminated
+    size_t length = 0;
+};
+
+/**
+ * @brief The whole microphone path of a session, run in the capture callback
+ *
+ * Per block, one loop over the capture buffer removes DC (a one-pole
+ * high-pass) and sums the squares for the RMS. The streaming polyphase
+ * resampler then brings the block to the output rate, keeping its filter
+ * state across blocks. The output is rounded to int16 and base64-encoded
+ * straight into a message buffer that already holds the JSON envelope.
+ * Every buffer is sized on the first block and reused, so steady-state
+ * blocks allocate nothing.
+ */
+class MicFrontEnd {
+public:
+    explicit MicFrontEnd(const MicFrontEndConfig& config = MicFrontEndConfig());
+
+    const MicFrontEndConfig& config() const { return _config; }
+
+    /// Process frames of interleaved int16 from the capture stream
+    const MicPacket& process(const int16_t* block, size_t frames);
+
+    /// Forget the DC, hangover and filter state before a new stream
+    void reset();
+
+private:
+    MicFrontEndConfig _config;
+    PolyphaseResampler<float> _resampler;
+    std::vector<float> _mono;
+    std::vector<float> _resampled;
+    std::vector<int16_t> _pcm;
+    std::vector<char> _message;
+    float _dcIn = 0.0f;
+    float _dcOut = 0.0f;
+    size_t _hangover = 0;           ///< Input frames of voice still held
+    MicPacket _packet;
+};
+
+#endif // MICFRONTEND_H
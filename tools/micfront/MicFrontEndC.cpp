@@ -0,0 +1,52 @@
+#include "MicFrontEndC.h"
+#include "MicFrontEnd.h"
+
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+
+struct mic_front {
+    std::unique_ptr<MicFrontEnd> front;
+};
+
+extern "C" {
+
+mic_front *mic_front_create(uint32_t input_rate, uint32_t output_rate, uint16_t channels,
+                            uint16_t threshold, uint16_t hangover_ms) {
+    try {
+        MicFrontEndConfig config;
+        config.inputRate = input_rate;
+        config.outputRate = output_rate;
+        config.channels = channels;
+        config.threshold = threshold;
+        config.hangoverMs = hangover_ms;
+        return new mic_front{std::make_unique<MicFrontEnd>(config)};
+    } catch (const std::exception& e) {
+        fprintf(stderr, "mic_front: %s\n", e.what());
+        return nullptr;
+    }
+}
+
+void mic_front_destroy(mic_front *front) {
+    delete front;
+}
+
+int mic_front_process(mic_front *front, const int16_t *block, size_t frames, mic_packet *packet) {
+    try {
+        const MicPacket& result = front->front->process(block, frames);
+        packet->rms = result.rms;
+        packet->voice = result.voice;
+        packet->samples = result.samples;
+        packet->message = result.message;
+        packet->length = result.length;
+        return 0;
+    } catch (const std::exception& e) {
+        fprintf(stderr, "mic_front: %s\n", e.what());
+        return -1;
+    }
+}
+
+void mic_front_reset(mic_front *front) {
+    front->front->reset();
+}
+}
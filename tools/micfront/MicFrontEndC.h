@@ -0,0 +1,40 @@
+#ifndef MICFRONTENDC_H
+#define MICFRONTENDC_H
+
+/**
+ * @file MicFrontEndC.h
+ * @brief C interface to MicFrontEnd, loaded by the assistant with ctypes
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct mic_front mic_front;
+
+/// One processed block; message stays valid until the next mic_front_process()
+typedef struct mic_packet {
+    float rms;
+    uint8_t voice;
+    size_t samples;
+    const char *message;
+    size_t length;
+} mic_packet;
+
+/// NULL after printing the error to stderr
+mic_front *mic_front_create(uint32_t input_rate, uint32_t output_rate, uint16_t channels,
+                            uint16_t threshold, uint16_t hangover_ms);
+void mic_front_destroy(mic_front *front);
+
+/// frames of interleaved int16; 0 on success, -1 after printing the error to stderr
+int mic_front_process(mic_front *front, const int16_t *block, size_t frames, mic_packet *packet);
+void mic_front_reset(mic_front *front);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MICFRONTENDC_H
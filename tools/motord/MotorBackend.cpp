@@ -0,0 +1,130 @@
+#include "MotorBackend.h"
+
+#include <stdexcept>
+#include <time.h>
+
+#ifdef MOTORD_LGPIO
+#include <lgpio.h>
+#endif
+
+static uint64_t monotonicUs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000u + uint64_t(ts.tv_nsec) / 1000u;
+}
+
+static const char* const MOTOR_NAMES[MOTOR_COUNT] = {"mouth", "head", "tail"};
+
+TraceBackend::TraceBackend(const std::string& path, bool tailOnHead)
+    : _file(path == "-" ? stdout : fopen(path.c_str(), "w")), _startUs(monotonicUs()),
+      _tailOnHead(tailOnHead) {
+    if (!_file) {
+        throw std::runtime_error("Cannot create trace file " + path);
+    }
+}
+
+TraceBackend::~TraceBackend() {
+    if (_file == stdout) {
+        fflush(_file);
+    } else {
+        fclose(_file);
+    }
+}
+
+uint8_t TraceBackend::route(uint8_t motor, int& speed) const {
+    if (motor == MOTOR_TAIL && _tailOnHead) {
+        speed = -speed;
+        return MOTOR_HEAD;
+    }
+    return motor;
+}
+
+void TraceBackend::drive(uint8_t motor, int speed) {
+    motor = route(motor, speed);
+    fprintf(_file, "%llu %s %d\n", (unsigned long long)(monotonicUs() - _startUs),
+            motor < MOTOR_COUNT ? MOTOR_NAMES[motor] : "?", speed);
+}
+
+#ifdef MOTORD_LGPIO
+
+GpioBackend::GpioBackend(int chip, const MotorPins (&pins)[MOTOR_COUNT], uint32_t pwmHz)
+    : _pwmHz(float(pwmHz)) {
+    _handle = lgGpiochipOpen(chip);
+    if (_handle < 0) {
+        throw std::runtime_error(std::string("Cannot open gpiochip: ") + lguErrorText(_handle));
+    }
+    for (int m = 0; m < MOTOR_COUNT; m++) {
+        _pins[m] = pins[m];
+        for (int pin : {pins[m].in1, pins[m].in2}) {
+            if (pin < 0) {
+                continue;
+            }
+            int status = lgGpioClaimOutput(_handle, 0, pin, 0);
+            if (status < 0) {
+                lgGpiochipClose(_handle);
+                throw std::runtime_error("Cannot claim GPIO " + std::to_string(pin) + ": " +
+                                         lguErrorText(status));
+            }
+        }
+    }
+}
+
+GpioBackend::~GpioBackend() {
+    for (const MotorPins& pins : _pins) {
+        if (pins.in1 >= 0) {
+            brake(pins);
+        }
+    }
+    lgGpiochipClose(_handle);
+}
+
+uint8_t GpioBackend::route(uint8_t motor, int& speed) const {
+    if (motor == MOTOR_TAIL && _pins[MOTOR_TAIL].in1 < 0) {
+        speed = -speed;         // Two-motor fish: the tail is the head motor reversed
+        return MOTOR_HEAD;
+    }
+    return motor;
+}
+
+void GpioBackend::drive(uint8_t motor, int speed) {
+    if (motor >= MOTOR_COUNT) {
+        return;
+    }
+    motor = route(motor, speed);
+    const MotorPins& pins = _pins[motor];
+    if (pins.in1 < 0) {
+        return;
+    }
+    if (speed == 0) {
+        brake(pins);
+        return;
+    }
+    int pwmPin = speed > 0 ? pins.in1 : pins.in2;
+    int lowPin = speed > 0 ? pins.in2 : pins.in1;
+    lgTxPwm(_handle, lowPin, _pwmHz, 0, 0, 0);
+    lgGpioWrite(_handle, lowPin, 0);
+    lgTxPwm(_handle, pwmPin, _pwmHz, float(speed > 0 ? speed : -speed), 0, 0);
+}
+
+void GpioBackend::brake(const MotorPins& pins) {
+    lgTxPwm(_handle, pins.in1, _pwmHz, 0, 0, 0);
+    lgTxPwm(_handle, pins.in2, _pwmHz, 0, 0, 0);
+    lgGpioWrite(_handle, pins.in1, 0);
+    lgGpioWrite(_handle, pins.in2, 0);
+}
+
+#else
+
+GpioBackend::GpioBackend(int, const MotorPins (&)[MOTOR_COUNT], uint32_t) : _pwmHz(0) {
+    throw std::runtime_error("motord was built without lgpio (MOTORD_LGPIO)");
+}
+
+GpioBackend::~GpioBackend() = default;
+
+void GpioBackend::drive(uint8_t, int) {}
+
+uint8_t GpioBackend::route(uint8_t motor, int&) const { return motor; }
+
+void GpioBackend::brake(const MotorPins&) {}
+
+#endif
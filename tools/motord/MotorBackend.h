@@ -0,0 +1,120 @@
+#ifndef MOTORBACKEND_H
+#define MOTORBACKEND_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+/**
+ * @file MotorBackend.h
+ * @brief Outputs of the motor daemon: Pi GPIO, or a trace file for testing
+ */
+
+/// Logical motors, in the order of the assistant's pin map
+enum MotorId : uint8_t {
+    MOTOR_MOUTH = 0,
+    MOTOR_HEAD = 1,
+    MOTOR_TAIL = 2,
+    MOTOR_COUNT = 3,
+    MOTOR_ALL = 255     ///< Command addressed to every motor
+};
+
+/**
+ * @brief Where the daemon's control thread sends motor speeds
+ *
+ * drive() is only called from the control thread, once per change.
+ */
+class MotorBackend {
+public:
+    virtual ~MotorBackend() = default;
+
+    /**
+     * @brief Set one motor
+     *
+     * @param motor MotorId
+     * @param speed Signed duty cycle in percent (-100..100); 0 brakes
+     */
+    virtual void drive(uint8_t motor, int speed) = 0;
+
+    /**
+     * @brief Motor that actually moves when motor is driven
+     *
+     * The daemon keeps one speed per physical motor, so two logical motors
+     * wired to the same H-bridge never disagree about what it is doing.
+     *
+     * @param motor MotorId
+     * @param speed Speed for motor; turned into the speed of the returned motor
+     * @return MotorId to pass to drive()
+     */
+    virtual uint8_t route(uint8_t motor, int& speed) const {
+        (void)speed;
+        return motor;
+    }
+};
+
+/**
+ * @brief Writes every change as `<us> <motor> <speed>` to a file
+ *
+ * Times count from construction on CLOCK_MONOTONIC. Lets the daemon's
+ * timing be checked on any Linux box, without motors.
+ */
+class TraceBackend : public MotorBackend {
+public:
+    /**
+     * @param path       File to create; "-" writes to stdout
+     * @param tailOnHead Route the tail onto the head motor reversed, as
+     *                   GpioBackend does on a two-motor fish
+     * @throws std::runtime_error if the file cannot be created
+     */
+    explicit TraceBackend(const std::string& path, bool tailOnHead = false);
+    ~TraceBackend() override;
+
+    void drive(uint8_t motor, int speed) override;
+    uint8_t route(uint8_t motor, int& speed) const override;
+
+private:
+    FILE* _file;
+    uint64_t _startUs;
+    bool _tailOnHead;
+};
+
+/// H-bridge inputs of one motor; in1 is driven for positive speeds
+struct MotorPins {
+    int in1 = -1;
+    int in2 = -1;
+};
+
+/**
+ * @brief Drives MX1508/L298-style H-bridges through lgpio
+ *
+ * Same wiring and PWM as `core/movements.py`: the input for the
+ * direction is PWM'd at pwmHz and the other held low; braking drops both.
+ * A fish without a tail motor (`pins[MOTOR_TAIL].in1 < 0`) flaps the tail
+ * by running the head motor backwards.
+ *
+ * Needs lgpio: build with -DMOTORD_LGPIO and link -llgpio.
+ */
+class GpioBackend : public MotorBackend {
+public:
+    /**
+     * @param chip  gpiochip number (core/movements.py opens 0)
+     * @param pins  Pins of MOTOR_MOUTH, MOTOR_HEAD and MOTOR_TAIL
+     * @param pwmHz PWM frequency
+     * @throws std::runtime_error if the chip or a pin cannot be claimed, or
+     *         the daemon was built without MOTORD_LGPIO
+     */
+    GpioBackend(int chip, const MotorPins (&pins)[MOTOR_COUNT], uint32_t pwmHz);
+    ~GpioBackend() override;
+
+    void drive(uint8_t motor, int speed) override;
+    uint8_t route(uint8_t motor, int& speed) const override;
+
+private:
+    void brake(const MotorPins& pins);
+
+    int _handle = -1;
+    MotorPins _pins[MOTOR_COUNT];
+    float _pwmHz;
+};
+
+#endif // MOTORBACKEND_H
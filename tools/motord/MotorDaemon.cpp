@@ -0,0 +1,217 @@
+#include "MotorDaemon.h"
+
+#include <algorithm>
+#include <initializer_list>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+MotorDaemon::MotorDaemon(MotorBackend& backend, uint32_t tickUs, uint32_t idleTimeoutMs)
+    : _backend(backend), _tickUs(tickUs ? tickUs : 1000),
+      _idleTimeoutUs(uint64_t(idleTimeoutMs) * 1000u) {}
+
+MotorDaemon::~MotorDaemon() {
+    stop();
+}
+
+bool MotorDaemon::start(int priority) {
+    if (_running.exchange(true)) {
+        return false;
+    }
+    _thread = std::thread(&MotorDaemon::run, this);
+    if (priority > 0) {
+        sched_param param{};
+        param.sched_priority = priority;
+        _realtime = pthread_setschedparam(_thread.native_handle(), SCHED_FIFO, &param) == 0;
+    }
+    return true;
+}
+
+void MotorDaemon::stop() {
+    if (!_running.exchange(false)) {
+        return;
+    }
+    _thread.join();
+    for (uint8_t m = 0; m < MOTOR_COUNT; m++) {
+        set(m, 0);
+    }
+}
+
+bool MotorDaemon::push(const MotorCommand& command) {
+    if (_ring.push(command)) {
+        return true;
+    }
+    _dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void MotorDaemon::setLatencyUs(uint8_t motor, uint32_t latencyUs) {
+    if (motor < MOTOR_COUNT) {
+        _latencyUs[motor].store(latencyUs, std::memory_order_relaxed);
+    }
+}
+
+uint64_t MotorDaemon::nowUs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000u + uint64_t(ts.tv_nsec) / 1000u;
+}
+
+bool MotorDaemon::later(const Parked& a, const Parked& b) {
+    if (a.due != b.due) {
+        return a.due > b.due;
+    }
+    return a.sequence > b.sequence;
+}
+
+void MotorDaemon::run() {
+    timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    while (_running.load(std::memory_order_relaxed)) {
+        deadline.tv_nsec += long(_tickUs) * 1000;
+        while (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_nsec -= 1000000000L;
+            deadline.tv_sec++;
+        }
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) != 0) {
+        }
+
+        uint64_t now = nowUs();
+        uint64_t due = uint64_t(deadline.tv_sec) * 1000000u + uint64_t(deadline.tv_nsec) / 1000u;
+        uint64_t late = now > due ? now - due : 0;
+        if (late > _maxLateUs.load(std::memory_order_relaxed)) {
+            _maxLateUs.store(uint32_t(std::min<uint64_t>(late, UINT32_MAX)),
+                             std::memory_order_relaxed);
+        }
+        if (late > _tickUs) {
+            // Overslept (suspend, debugger): restart the grid rather than catch up
+            deadline.tv_sec = time_t(now / 1000000u);
+            deadline.tv_nsec = long(now % 1000000u) * 1000;
+        }
+        tick(now);
+    }
+}
+
+void MotorDaemon::tick(uint64_t now) {
+    SampleClock* clock = _clock.load(std::memory_order_acquire);
+    int64_t frame = clock ? clock->position(now) : -1;
+
+    MotorCommand command;
+    while (_ring.pop(command)) {
+        if (!(command.flags & MOTOR_FLAG_SAMPLES)) {
+            if (command.atUs <= now) {
+                apply(command, now);
+            } else {
+                park(_parked, command, command.atUs);
+            }
+            continue;
+        }
+        if (!clock) {
+            apply(command, now);
+            continue;
+        }
+        // Latency is folded in on arrival, so one heap serves every motor
+        uint64_t latencyUs = command.motor < MOTOR_COUNT
+                                 ? _latencyUs[command.motor].load(std::memory_order_relaxed)
+                                 : 0;
+        uint64_t early = latencyUs * clock->sampleRate() / 1000000u;
+        uint64_t due = command.atUs > early ? command.atUs - early : 0;
+        if (frame >= 0 && due <= uint64_t(frame)) {
+            apply(command, now);
+        } else {
+            park(_sampled, command, due);
+        }
+    }
+
+    applyDue(_parked, now, now);
+    if (frame >= 0) {
+        applyDue(_sampled, uint64_t(frame), now);
+    }
+
+    for (uint8_t m = 0; m < MOTOR_COUNT; m++) {
+        MotorState& motor = _motors[m];
+        if (motor.untilUs && now >= motor.untilUs) {
+            motor.untilUs = 0;
+            set(m, motor.thenSpeed);
+        }
+        // Watchdog: nobody has touched this running motor for too long
+        if (motor.speed && _idleTimeoutUs && now - motor.lastCommandUs > _idleTimeoutUs) {
+            motor.untilUs = 0;
+            set(m, 0);
+            _watchdogTrips.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void MotorDaemon::park(Heap& heap, const MotorCommand& command, uint64_t due) {
+    if (heap.count == QUEUE_SIZE) {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    heap.items[heap.count++] = Parked{command, due, _sequence++};
+    std::push_heap(heap.items, heap.items + heap.count, later);
+}
+
+void MotorDaemon::applyDue(Heap& heap, uint64_t due, uint64_t now) {
+    while (heap.count && heap.items[0].due <= due) {
+        std::pop_heap(heap.items, heap.items + heap.count, later);
+        --heap.count;
+        apply(heap.items[heap.count].command, now);
+    }
+}
+
+void MotorDaemon::apply(const MotorCommand& command, uint64_t now) {
+    if (command.flags & MOTOR_FLAG_CANCEL) {
+        cancel(command.motor);
+    }
+    if (command.motor == MOTOR_ALL) {
+        for (uint8_t m = 0; m < MOTOR_COUNT; m++) {
+            applyTo(m, command, now);
+        }
+    } else if (command.motor < MOTOR_COUNT) {
+        applyTo(command.motor, command, now);
+    }
+}
+
+void MotorDaemon::applyTo(uint8_t motor, const MotorCommand& command, uint64_t now) {
+    MotorState& state = _motors[motor];
+    state.lastCommandUs = now;
+    state.thenSpeed = command.thenSpeed;
+    state.untilUs = command.durationUs ? now + command.durationUs : 0;
+    set(motor, command.speed);
+}
+
+void MotorDaemon::cancel(uint8_t motor) {
+    for (Heap* heap : {&_parked, &_sampled}) {
+        size_t kept = 0;
+        for (size_t i = 0; i < heap->count; i++) {
+            if (motor != MOTOR_ALL && heap->items[i].command.motor != motor) {
+                heap->items[kept++] = heap->items[i];
+            }
+        }
+        heap->count = kept;
+        std::make_heap(heap->items, heap->items + heap->count, later);
+    }
+}
+
+void MotorDaemon::set(uint8_t motor, int speed) {
+    speed = std::max(-100, std::min(100, speed));
+    if (_motors[motor].speed == speed) {
+        return;
+    }
+    // Every logical motor on the same physical one takes the new state, so a
+    // later command to any of them is compared with what the motor really
+    // does. Their watchdog and pending then-speed follow the last writer.
+    int physicalSpeed = speed;
+    uint8_t physical = _backend.route(motor, physicalSpeed);
+    _motors[motor].speed = speed;
+    for (uint8_t m = 0; m < MOTOR_COUNT; m++) {
+        int sign = 1;
+        if (m != motor && _backend.route(m, sign) == physical) {
+            _motors[m].speed = physicalSpeed * sign;
+            _motors[m].lastCommandUs = _motors[motor].lastCommandUs;
+            _motors[m].untilUs = 0;
+        }
+    }
+    _backend.drive(motor, speed);
+}
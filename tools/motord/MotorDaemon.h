@@ -0,0 +1,166 @@
+#ifndef MOTORDAEMON_H
+#define MOTORDAEMON_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "MotorBackend.h"
+#include "SampleClock.h"
+#include "SpscRing.h"
+
+/**
+ * @file MotorDaemon.h
+ * @brief Real-time motor control thread fed through a lock-free ring
+ */
+
+/// MotorCommand::flags
+enum MotorCommandFlags : uint8_t {
+    MOTOR_FLAG_CANCEL = 1,  ///< Drop the motor's (MOTOR_ALL: all) commands still waiting for their time
+    MOTOR_FLAG_SAMPLES = 2  ///< atUs is a frame position on the daemon's SampleClock
+};
+
+/**
+ * @brief One timestamped motor change
+ *
+ * The motor runs at speed from atUs on; after durationUs it switches to
+ * thenSpeed (a flap: speed then 0; the head: ramp speed then hold).
+ */
+struct MotorCommand {
+    uint64_t atUs = 0;          ///< CLOCK_MONOTONIC time to apply it (or frame, see flags); 0 = next tick
+    uint32_t durationUs = 0;    ///< Time at speed before thenSpeed; 0 = until the next command
+    int16_t speed = 0;          ///< Signed duty cycle in percent; 0 brakes
+    int16_t thenSpeed = 0;      ///< Speed once durationUs has passed
+    uint8_t motor = 0;          ///< MotorId or MOTOR_ALL
+    uint8_t flags = 0;          ///< MotorCommandFlags
+};
+
+/**
+ * @brief Owns the motors from one high-priority thread
+ *
+ * Callers push() commands into a wait-free SPSC ring and return at once;
+ * nothing they do (sleeping, garbage collection, the GIL) delays a motor.
+ * Every tickUs the control thread wakes on an absolute CLOCK_MONOTONIC
+ * deadline and:
+ * 1. drains the ring, parking commands that are not due yet in a fixed
+ *    min-heap ordered by time (then by arrival); commands timed in audio
+ *    frames go to a second heap ordered by frame,
+ * 2. applies the commands that are due and ends expired durations,
+ * 3. runs the watchdog: a motor left running without a new command for
+ *    idleTimeoutMs is braked.
+ *
+ * A command flagged MOTOR_FLAG_SAMPLES is due when the SampleClock set
+ * with setClock() reaches its frame, less the motor's latency: a motor
+ * that takes 40 ms to move visibly is driven 40 ms of audio early, so the
+ * movement lands on the sound. Without a clock such commands apply at once.
+ *
+ * The thread asks for SCHED_FIFO; without the privilege it runs at normal
+ * priority and realtime() says so. Nothing on the control path allocates.
+ *
+ * push() is single-producer: callers on several threads must serialise it.
+ */
+class MotorDaemon {
+public:
+    static constexpr size_t QUEUE_SIZE = 256;   ///< Ring slots and parked commands
+
+    /**
+     * @param backend       Motor outputs; must outlive the daemon
+     * @param tickUs        Control period
+     * @param idleTimeoutMs Watchdog limit for a motor left running
+     */
+    explicit MotorDaemon(MotorBackend& backend, uint32_t tickUs = 1000,
+                         uint32_t idleTimeoutMs = 60000);
+    ~MotorDaemon();
+
+    MotorDaemon(const MotorDaemon&) = delete;
+    MotorDaemon& operator=(const MotorDaemon&) = delete;
+
+    /**
+     * @brief Start the control thread
+     *
+     * @param priority SCHED_FIFO priority (1..99); 0 keeps normal scheduling
+     * @return false if it is already running
+     */
+    bool start(int priority = 50);
+
+    /// Stop the thread and brake every motor
+    void stop();
+
+    /**
+     * @brief Queue a command (single producer)
+     * @return false if the ring is full; the command is dropped
+     */
+    bool push(const MotorCommand& command);
+
+    /**
+     * @brief Clock of MOTOR_FLAG_SAMPLES commands
+     *
+     * @param clock Must outlive the daemon (or the next setClock()); nullptr
+     *              applies frame-timed commands at once
+     */
+    void setClock(SampleClock* clock) { _clock.store(clock, std::memory_order_release); }
+
+    /// Time from driving a motor to seeing it move; frame-timed commands start that early
+    void setLatencyUs(uint8_t motor, uint32_t latencyUs);
+
+    /// The control thread got SCHED_FIFO
+    bool realtime() const { return _realtime.load(std::memory_order_relaxed); }
+    /// Worst wake-up lateness of a tick so far
+    uint32_t maxLateUs() const { return _maxLateUs.load(std::memory_order_relaxed); }
+    /// Motors braked by the watchdog so far
+    uint32_t watchdogTrips() const { return _watchdogTrips.load(std::memory_order_relaxed); }
+    /// Commands dropped because the ring or the parking heap was full
+    uint32_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+    /// Current CLOCK_MONOTONIC time, the clock of MotorCommand::atUs
+    static uint64_t nowUs();
+
+private:
+    struct Parked {
+        MotorCommand command;
+        uint64_t due;           ///< Time (or frame) it applies at
+        uint64_t sequence;      ///< Arrival order among equal times
+    };
+
+    /// Fixed min-heap of parked commands
+    struct Heap {
+        Parked items[QUEUE_SIZE];
+        size_t count = 0;
+    };
+
+    struct MotorState {
+        int speed = 0;
+        int thenSpeed = 0;
+        uint64_t untilUs = 0;           ///< End of the running duration; 0 = none
+        uint64_t lastCommandUs = 0;     ///< For the watchdog
+    };
+
+    static bool later(const Parked& a, const Parked& b);
+    void run();
+    void tick(uint64_t now);
+    void park(Heap& heap, const MotorCommand& command, uint64_t due);
+    void applyDue(Heap& heap, uint64_t due, uint64_t now);
+    void apply(const MotorCommand& command, uint64_t now);
+    void applyTo(uint8_t motor, const MotorCommand& command, uint64_t now);
+    void cancel(uint8_t motor);
+    void set(uint8_t motor, int speed);
+
+    MotorBackend& _backend;
+    uint32_t _tickUs;
+    uint64_t _idleTimeoutUs;
+    SpscRing<MotorCommand, QUEUE_SIZE> _ring;
+    Heap _parked;                       ///< Commands not due yet, by time
+    Heap _sampled;                      ///< Frame-timed commands not due yet, by frame
+    uint64_t _sequence = 0;
+    std::atomic<SampleClock*> _clock{nullptr};
+    std::atomic<uint32_t> _latencyUs[MOTOR_COUNT] = {};
+    MotorState _motors[MOTOR_COUNT];
+    std::thread _thread;
+    std::atomic<bool> _running{false};
+    std::atomic<bool> _realtime{false};
+    std::atomic<uint32_t> _maxLateUs{0};
+    std::atomic<uint32_t> _watchdogTrips{0};
+    std::atomic<uint32_t> _dropped{0};
+};
+
+#endif // MOTORDAEMON_H
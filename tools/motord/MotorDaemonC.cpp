@@ -0,0 +1,134 @@
+#include "MotorDaemonC.h"
+#include "MotorDaemon.h"
+
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+
+struct motord {
+    std::unique_ptr<MotorBackend> backend;
+    std::unique_ptr<MotorDaemon> daemon;
+
+    motord(MotorBackend* output, uint32_t tickUs, uint32_t idleTimeoutMs)
+        : backend(output), daemon(new MotorDaemon(*output, tickUs, idleTimeoutMs)) {}
+
+    ~motord() {
+        daemon.reset();     // Stop the thread before its backend goes away
+    }
+};
+
+struct motord_clock {
+    std::unique_ptr<SampleClock> clock;
+    StreamClock* stream = nullptr;      ///< clock, when anchored by a writer
+    ManualClock* manual = nullptr;      ///< clock, when set by hand
+};
+
+extern "C" {
+
+motord *motord_create_trace(const char *path, uint32_t tick_us, uint32_t idle_timeout_ms,
+                            int tail_on_head) {
+    try {
+        return new motord(new TraceBackend(path, tail_on_head != 0), tick_us, idle_timeout_ms);
+    } catch (const std::exception& e) {
+        fprintf(stderr, "motord: %s\n", e.what());
+        return nullptr;
+    }
+}
+
+motord *motord_create_gpio(int chip, const int *pins, uint32_t pwm_hz, uint32_t tick_us,
+                           uint32_t idle_timeout_ms) {
+    MotorPins map[MOTOR_COUNT];
+    for (int m = 0; m < MOTOR_COUNT; m++) {
+        map[m].in1 = pins[2 * m];
+        map[m].in2 = pins[2 * m + 1];
+    }
+    try {
+        return new motord(new GpioBackend(chip, map, pwm_hz), tick_us, idle_timeout_ms);
+    } catch (const std::exception& e) {
+        fprintf(stderr, "motord: %s\n", e.what());
+        return nullptr;
+    }
+}
+
+void motord_destroy(motord *daemon) {
+    delete daemon;
+}
+
+int motord_start(motord *daemon, int priority) {
+    return daemon->daemon->start(priority) ? 1 : 0;
+}
+
+int motord_realtime(const motord *daemon) {
+    return daemon->daemon->realtime() ? 1 : 0;
+}
+
+int motord_push(motord *daemon, uint64_t at_us, uint8_t motor, int16_t speed,
+                uint32_t duration_us, int16_t then_speed, uint8_t flags) {
+    MotorCommand command;
+    command.atUs = at_us;
+    command.motor = motor;
+    command.speed = speed;
+    command.durationUs = duration_us;
+    command.thenSpeed = then_speed;
+    command.flags = flags;
+    return daemon->daemon->push(command) ? 1 : 0;
+}
+
+uint64_t motord_now_us(void) {
+    return MotorDaemon::nowUs();
+}
+
+void motord_set_clock(motord *daemon, motord_clock *clock) {
+    daemon->daemon->setClock(clock ? clock->clock.get() : nullptr);
+}
+
+void motord_set_latency_us(motord *daemon, uint8_t motor, uint32_t latency_us) {
+    daemon->daemon->setLatencyUs(motor, latency_us);
+}
+
+motord_clock *motord_clock_create_stream(uint32_t sample_rate) {
+    motord_clock *clock = new motord_clock;
+    clock->stream = new StreamClock(sample_rate);
+    clock->clock.reset(clock->stream);
+    return clock;
+}
+
+motord_clock *motord_clock_create_manual(uint32_t sample_rate) {
+    motord_clock *clock = new motord_clock;
+    clock->manual = new ManualClock(sample_rate);
+    clock->clock.reset(clock->manual);
+    return clock;
+}
+
+void motord_clock_destroy(motord_clock *clock) {
+    delete clock;
+}
+
+void motord_clock_anchor(motord_clock *clock, uint64_t written, uint32_t queued) {
+    if (clock->stream) {
+        clock->stream->anchor(written, queued, MotorDaemon::nowUs());
+    }
+}
+
+void motord_clock_set(motord_clock *clock, int64_t position) {
+    if (clock->manual) {
+        clock->manual->set(position);
+    }
+}
+
+int64_t motord_clock_position(const motord_clock *clock) {
+    return clock->clock->position(MotorDaemon::nowUs());
+}
+
+uint32_t motord_max_late_us(const motord *daemon) {
+    return daemon->daemon->maxLateUs();
+}
+
+uint32_t motord_watchdog_trips(const motord *daemon) {
+    return daemon->daemon->watchdogTrips();
+}
+
+uint32_t motord_dropped(const motord *daemon) {
+    return daemon->daemon->dropped();
+}
+}
@@ -0,0 +1,88 @@
+#ifndef MOTORDAEMONC_H
+#define MOTORDAEMONC_H
+
+/**
+ * @file MotorDaemonC.h
+ * @brief C interface to MotorDaemon, loaded by the assistant with ctypes
+ *
+ * A motord owns its backend and control thread. Create functions return
+ * NULL when the backend cannot be opened. motord_push() is the ring's
+ * single producer: callers on several threads must serialise it.
+ *
+ * A motord_clock is a SampleClock: a stream clock anchored by the audio
+ * writer, or a manual one for tests. It must outlive every daemon it is
+ * set on.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct motord motord;
+typedef struct motord_clock motord_clock;
+
+#define MOTORD_FLAG_CANCEL 1
+#define MOTORD_FLAG_SAMPLES 2
+
+/**
+ * @brief Daemon that writes motor changes to a trace file ("-" = stdout)
+ *
+ * A nonzero tail_on_head traces the tail on the head motor reversed, as on
+ * a two-motor fish.
+ */
+motord *motord_create_trace(const char *path, uint32_t tick_us, uint32_t idle_timeout_ms,
+                            int tail_on_head);
+
+/**
+ * @brief Daemon on the Pi's GPIO through lgpio
+ *
+ * @param pins in1, in2 of the mouth, head and tail motors (6 values);
+ *             tail -1 on a two-motor fish
+ */
+motord *motord_create_gpio(int chip, const int *pins, uint32_t pwm_hz, uint32_t tick_us,
+                           uint32_t idle_timeout_ms);
+
+/** Stops the thread, brakes the motors and frees the daemon */
+void motord_destroy(motord *daemon);
+
+/** Returns 1 once the control thread runs; priority 0 skips SCHED_FIFO */
+int motord_start(motord *daemon, int priority);
+int motord_realtime(const motord *daemon);
+
+/**
+ * @brief Queue a command; see MotorCommand. Returns 0 if the ring is full.
+ */
+int motord_push(motord *daemon, uint64_t at_us, uint8_t motor, int16_t speed,
+                uint32_t duration_us, int16_t then_speed, uint8_t flags);
+
+/** CLOCK_MONOTONIC in microseconds, the clock of at_us */
+uint64_t motord_now_us(void);
+
+/** Clock of MOTORD_FLAG_SAMPLES commands; NULL applies them at once */
+void motord_set_clock(motord *daemon, motord_clock *clock);
+void motord_set_latency_us(motord *daemon, uint8_t motor, uint32_t latency_us);
+
+/** Clock moved by motord_clock_anchor() from the audio writing thread */
+motord_clock *motord_clock_create_stream(uint32_t sample_rate);
+/** Clock moved by motord_clock_set(), standing in for the audio device */
+motord_clock *motord_clock_create_manual(uint32_t sample_rate);
+void motord_clock_destroy(motord_clock *clock);
+
+/** After a write: frames written in total, of which queued are still in the device */
+void motord_clock_anchor(motord_clock *clock, uint64_t written, uint32_t queued);
+void motord_clock_set(motord_clock *clock, int64_t position);
+/** Frame at the speaker now; -1 before the first */
+int64_t motord_clock_position(const motord_clock *clock);
+
+uint32_t motord_max_late_us(const motord *daemon);
+uint32_t motord_watchdog_trips(const motord *daemon);
+uint32_t motord_dropped(const motord *daemon);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MOTORDAEMONC_H
@@ -0,0 +1,30 @@
+#include "SampleClock.h"
+
+void StreamClock::anchor(uint64_t written, uint32_t queued, uint64_t atUs) {
+    uint32_t sequence = _sequence.load(std::memory_order_relaxed);
+    _sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _written.store(written, std::memory_order_relaxed);
+    _queued.store(queued, std::memory_order_relaxed);
+    _atUs.store(atUs, std::memory_order_relaxed);
+    _sequence.store(sequence + 2, std::memory_order_release);
+}
+
+int64_t StreamClock::position(uint64_t nowUs) const {
+    uint64_t written, queued, atUs;
+    uint32_t sequence;
+    do {
+        sequence = _sequence.load(std::memory_order_acquire);
+        written = _written.load(std::memory_order_relaxed);
+        queued = _queued.load(std::memory_order_relaxed);
+        atUs = _atUs.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((sequence & 1) || sequence != _sequence.load(std::memory_order_relaxed));
+
+    if (!sequence) {
+        return -1;      // Never anchored
+    }
+    uint64_t elapsed = nowUs > atUs ? (nowUs - atUs) * sampleRate() / 1000000u : 0;
+    int64_t position = int64_t(written) - int64_t(queued) + int64_t(elapsed);
+    return position < int64_t(written) ? position : int64_t(written);
+}
@@ -0,0 +1,79 @@
+#ifndef SAMPLECLOCK_H
+#define SAMPLECLOCK_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @file SampleClock.h
+ * @brief Audio sample positions as a clock for motor commands
+ */
+
+/**
+ * @brief Which audio frame is at the speaker at a given time
+ *
+ * Commands flagged MOTOR_FLAG_SAMPLES are due when the clock reaches
+ * their position, so motion follows the audio output itself rather than
+ * the wall clock of whoever computed it.
+ */
+class SampleClock {
+public:
+    explicit SampleClock(uint32_t sampleRate) : _sampleRate(sampleRate ? sampleRate : 1) {}
+    virtual ~SampleClock() = default;
+
+    uint32_t sampleRate() const { return _sampleRate; }
+
+    /**
+     * @brief Frame playing at CLOCK_MONOTONIC time nowUs
+     * @return The position, or -1 before the first frame has been played
+     */
+    virtual int64_t position(uint64_t nowUs) const = 0;
+
+private:
+    uint32_t _sampleRate;
+};
+
+/**
+ * @brief Follows an audio output stream from the thread that writes to it
+ *
+ * After each write, the writer calls anchor() with the total number of
+ * frames written so far and the number still queued in the device (its
+ * output latency): the frame at the speaker is then written - queued.
+ * Between anchors the position advances at the sample rate, but never
+ * past the frames written, so an underrun stops the clock instead of
+ * letting motion run ahead of silence. Anchoring again corrects any
+ * drift between the sound card's crystal and CLOCK_MONOTONIC.
+ *
+ * anchor() has a single writer; position() is lock-free for any reader
+ * (a seqlock over the three anchor values).
+ */
+class StreamClock : public SampleClock {
+public:
+    explicit StreamClock(uint32_t sampleRate) : SampleClock(sampleRate) {}
+
+    /// Single writer: frames written in total, of which queued are not yet heard
+    void anchor(uint64_t written, uint32_t queued, uint64_t atUs);
+    int64_t position(uint64_t nowUs) const override;
+
+private:
+    std::atomic<uint32_t> _sequence{0};     ///< Odd while anchor() is writing
+    std::atomic<uint64_t> _written{0};
+    std::atomic<uint64_t> _queued{0};
+    std::atomic<uint64_t> _atUs{0};
+};
+
+/**
+ * @brief A clock set by hand, standing in for the audio device in tests
+ */
+class ManualClock : public SampleClock {
+public:
+    explicit ManualClock(uint32_t sampleRate) : SampleClock(sampleRate) {}
+
+    void set(int64_t position) { _position.store(position, std::memory_order_release); }
+    int64_t position(uint64_t) const override { return _position.load(std::memory_order_acquire); }
+
+private:
+    std::atomic<int64_t> _position{-1};
+};
+
+#endif // SAMPLECLOCK_H
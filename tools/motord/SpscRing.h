@@ -0,0 +1,75 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @file SpscRing.h
+ * @brief Fixed-capacity lock-free ring for one producer and one consumer
+ */
+
+/**
+ * @brief Wait-free single-producer/single-consumer queue
+ *
+ * Storage is inline, so neither side allocates. The producer only writes
+ * `_head` and the consumer only writes `_tail`; each publishes with a
+ * release store and reads the other's index with an acquire load, which
+ * also orders the slot contents. The two indices sit on separate cache
+ * lines so the threads do not bounce one line between cores.
+ *
+ * @tparam T        Trivially copyable element
+ * @tparam Capacity Slot count, a power of two
+ */
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscRing capacity must be a power of two");
+
+public:
+    /**
+     * @brief Append one element (producer thread only)
+     * @return false if the ring is full; the element is not queued
+     */
+    bool push(const T& value) {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tailCache == Capacity) {
+            _tailCache = _tail.load(std::memory_order_acquire);
+            if (head - _tailCache == Capacity) {
+                return false;
+            }
+        }
+        _slots[head & (Capacity - 1)] = value;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Take the oldest element (consumer thread only)
+     * @return false if the ring is empty
+     */
+    bool pop(T& value) {
+        const size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _headCache) {
+            _headCache = _head.load(std::memory_order_acquire);
+            if (tail == _headCache) {
+                return false;
+            }
+        }
+        value = _slots[tail & (Capacity - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Number of slots
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    alignas(64) std::atomic<size_t> _head{0};  ///< Next slot to write
+    size_t _tailCache = 0;                     ///< Producer's last view of _tail
+    alignas(64) std::atomic<size_t> _tail{0};  ///< Next slot to read
+    size_t _headCache = 0;                     ///< Consumer's last view of _head
+    alignas(64) T _slots[Capacity];
+};
+
+#endif // SPSCRING_H
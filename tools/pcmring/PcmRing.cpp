@@ -0,0 +1,200 @@
+#include "PcmRing.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "PcmRing positions must be lock-free to be shared between processes");
+
+static size_t mappingSize(uint32_t channels, uint32_t capacity) {
+    return sizeof(PcmRingHeader) + size_t(channels) * capacity * sizeof(int16_t);
+}
+
+static std::runtime_error systemError(const std::string& what, const std::string& name) {
+    return std::runtime_error(what + " " + name + ": " + strerror(errno));
+}
+
+PcmRing::PcmRing(PcmRingHeader* header, size_t bytes, const std::string& name, bool owner)
+    : _header(header),
+      _samples(reinterpret_cast<int16_t*>(header + 1)),
+      _bytes(bytes),
+      _name(name),
+      _owner(owner) {}
+
+PcmRing::~PcmRing() {
+    munmap(_header, _bytes);
+    if (_owner) {
+        shm_unlink(_name.c_str());
+    }
+}
+
+std::unique_ptr<PcmRing> PcmRing::create(const std::string& name, uint32_t channels,
+                                         uint32_t capacity, uint32_t sampleRate) {
+    if (!channels || !capacity || capacity > (1u << 30)) {
+        throw std::runtime_error("PcmRing needs at least one channel and one frame");
+    }
+    uint32_t frames = 1;
+    while (frames < capacity) {
+        frames <<= 1;
+    }
+
+    shm_unlink(name.c_str());   // A ring left behind by a crashed run
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        throw systemError("Cannot create shared memory", name);
+    }
+    size_t bytes = mappingSize(channels, frames);
+    void* memory = MAP_FAILED;
+    if (ftruncate(fd, off_t(bytes)) == 0) {
+        memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (memory == MAP_FAILED) {
+        std::runtime_error error = systemError("Cannot map shared memory", name);
+        shm_unlink(name.c_str());
+        throw error;
+    }
+
+    PcmRingHeader* header = new (memory) PcmRingHeader();
+    header->channels = channels;
+    header->capacity = frames;
+    header->sampleRate = sampleRate;
+    header->history = frames / 4;
+    for (PcmRingHeader::Reader& reader : header->readers) {
+        reader.used.store(0, std::memory_order_relaxed);
+        reader.position.store(0, std::memory_order_relaxed);
+        reader.lapped.store(0, std::memory_order_relaxed);
+    }
+    header->written.store(0, std::memory_order_relaxed);
+    header->played.store(0, std::memory_order_relaxed);
+    header->flags.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = PcmRingHeader::MAGIC;
+    return std::unique_ptr<PcmRing>(new PcmRing(header, bytes, name, true));
+}
+
+std::unique_ptr<PcmRing> PcmRing::open(const std::string& name) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        throw systemError("Cannot open shared memory", name);
+    }
+    struct stat info;
+    void* memory = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && size_t(info.st_size) >= sizeof(PcmRingHeader)) {
+        memory = mmap(nullptr, size_t(info.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (memory == MAP_FAILED) {
+        throw systemError("Cannot map shared memory", name);
+    }
+
+    PcmRingHeader* header = static_cast<PcmRingHeader*>(memory);
+    if (header->magic != PcmRingHeader::MAGIC ||
+        mappingSize(header->channels, header->capacity) > size_t(info.st_size)) {
+        munmap(memory, size_t(info.st_size));
+        throw std::runtime_error("Not a PcmRing: " + name);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return std::unique_ptr<PcmRing>(new PcmRing(header, size_t(info.st_size), name, false));
+}
+
+uint64_t PcmRing::written() const {
+    return _header->written.load(std::memory_order_acquire);
+}
+
+size_t PcmRing::writable() const {
+    uint64_t unplayed = _header->written.load(std::memory_order_relaxed) -
+                        _header->played.load(std::memory_order_acquire);
+    size_t kept = size_t(unplayed) + _header->history;
+    return kept < capacity() ? capacity() - kept : 0;
+}
+
+void PcmRing::commit(size_t frames) {
+    uint64_t end = _header->written.load(std::memory_order_relaxed) + frames;
+    _header->written.store(end, std::memory_order_release);
+}
+
+void PcmRing::setFlags(uint32_t flags) {
+    _header->flags.fetch_or(flags, std::memory_order_release);
+}
+
+uint32_t PcmRing::flags() const {
+    return _header->flags.load(std::memory_order_acquire);
+}
+
+uint64_t PcmRing::played() const {
+    return _header->played.load(std::memory_order_acquire);
+}
+
+size_t PcmRing::playable() const {
+    return size_t(_header->written.load(std::memory_order_acquire) -
+                  _header->played.load(std::memory_order_relaxed));
+}
+
+void PcmRing::release(size_t frames) {
+    uint64_t end = _header->played.load(std::memory_order_relaxed) + frames;
+    _header->played.store(end, std::memory_order_release);
+}
+
+int PcmRing::attach() {
+    for (uint32_t i = 0; i < PcmRingHeader::MAX_READERS; i++) {
+        PcmRingHeader::Reader& reader = _header->readers[i];
+        uint32_t unused = 0;
+        if (reader.used.compare_exchange_strong(unused, 1, std::memory_order_acq_rel)) {
+            reader.lapped.store(0, std::memory_order_relaxed);
+            reader.position.store(played(), std::memory_order_release);
+            return int(i);
+        }
+    }
+    return -1;
+}
+
+void PcmRing::detach(int reader) {
+    _header->readers[reader].used.store(0, std::memory_order_release);
+}
+
+size_t PcmRing::available(int reader, uint64_t* position) {
+    PcmRingHeader::Reader& cursor = _header->readers[reader];
+    uint64_t at = cursor.position.load(std::memory_order_relaxed);
+    uint64_t written = _header->written.load(std::memory_order_acquire);
+    uint64_t oldest = written > capacity() ? written - capacity() : 0;
+    if (at < oldest) {
+        cursor.lapped.fetch_add(oldest - at, std::memory_order_relaxed);
+        at = oldest;
+        cursor.position.store(at, std::memory_order_release);
+    }
+    uint64_t played = this->played();
+    *position = at;
+    return played > at ? size_t(played - at) : 0;
+}
+
+void PcmRing::consume(int reader, size_t frames) {
+    PcmRingHeader::Reader& cursor = _header->readers[reader];
+    uint64_t at = cursor.position.load(std::memory_order_relaxed);
+    cursor.position.store(at + frames, std::memory_order_release);
+}
+
+bool PcmRing::intact(uint64_t position) const {
+    std::atomic_thread_fence(std::memory_order_acquire);  // Order the reads just made
+    return _header->written.load(std::memory_order_relaxed) <= position + capacity();
+}
+
+uint64_t PcmRing::lapped(int reader) const {
+    return _header->readers[reader].lapped.load(std::memory_order_relaxed);
+}
+
+void PcmRing::reset() {
+    _header->written.store(0, std::memory_order_relaxed);
+    _header->played.store(0, std::memory_order_relaxed);
+    for (PcmRingHeader::Reader& reader : _header->readers) {
+        reader.position.store(0, std::memory_order_relaxed);
+        reader.lapped.store(0, std::memory_order_relaxed);
+    }
+    _header->flags.store(0, std::memory_order_release);
+}
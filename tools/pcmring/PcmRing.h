@@ -0,0 +1,145 @@
+#ifndef PCMRING_H
+#define PCMRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * @file PcmRing.h
+ * @brief Shared-memory PCM ring: one producer, one audio reader, many analysers
+ */
+
+/**
+ * @brief Layout at the start of the shared memory object
+ *
+ * Positions count frames since the stream began, so they double as
+ * sample-accurate timestamps: frame n plays n / sampleRate seconds in.
+ * Channel c's samples follow the header as one planar block of capacity
+ * int16 values; frame n of it is at index n % capacity.
+ */
+struct PcmRingHeader {
+    static constexpr uint32_t MAGIC = 0x50434d52;  ///< "PCMR"
+    static constexpr uint32_t MAX_READERS = 8;
+
+    /// Cursor of one analysis reader, visible to every process for telemetry
+    struct Reader {
+        std::atomic<uint32_t> used;
+        std::atomic<uint64_t> position;     ///< Next frame it reads
+        std::atomic<uint64_t> lapped;       ///< Frames it lost to the producer
+    };
+
+    uint32_t magic;
+    uint32_t channels;
+    uint32_t capacity;                      ///< Frames per channel, a power of two
+    uint32_t sampleRate;
+    uint32_t history;                       ///< Played frames kept for analysis readers
+    alignas(64) std::atomic<uint64_t> written;  ///< Frames published by the producer
+    alignas(64) std::atomic<uint64_t> played;   ///< Frames taken by the audio reader
+    alignas(64) std::atomic<uint32_t> flags;    ///< PcmRing::END / CANCEL
+    Reader readers[MAX_READERS];
+};
+
+/**
+ * @brief Zero-copy PCM ring in POSIX shared memory
+ *
+ * The producer (song decoder) writes planar frames straight into the
+ * mapping and publishes them with commit(). The audio reader reads them in
+ * place and hands them on with release(); the producer never overwrites a
+ * frame the audio reader has not released, so audio is never lost, and
+ * only the producer ever waits. It also leaves the newest quarter of the
+ * ring's played frames (`history`) alone, so analysis readers have that
+ * long to catch up before frames they have not seen are reused.
+ *
+ * Analysis readers (mouth, tail, telemetry) attach() a cursor and read the
+ * same frames in place, up to the audio reader's position, so they follow
+ * what is actually being played and never run ahead of it. They never
+ * hold anything up: a reader that falls further behind than the history
+ * skips forward and counts the loss in its `lapped` counter.
+ *
+ * Each side publishes its position with a release store and reads the
+ * others' with an acquire load, which also orders the samples. Positions
+ * are address-free lock-free atomics, so any process that open()s the
+ * same name may take part.
+ */
+class PcmRing {
+public:
+    static constexpr uint32_t END = 1;      ///< Producer has written its last frame
+    static constexpr uint32_t CANCEL = 2;   ///< Stop now, e.g. playback was interrupted
+
+    /**
+     * @brief Create (or replace) the shared memory object
+     *
+     * @param name     POSIX shm name, e.g. "/billy-pcm"
+     * @param channels Planar channels per frame
+     * @param capacity Frames per channel, rounded up to a power of two
+     * @throws std::runtime_error if it cannot be created or mapped
+     */
+    static std::unique_ptr<PcmRing> create(const std::string& name, uint32_t channels,
+                                           uint32_t capacity, uint32_t sampleRate);
+
+    /**
+     * @brief Map an existing ring
+     * @throws std::runtime_error if it does not exist or is not a PcmRing
+     */
+    static std::unique_ptr<PcmRing> open(const std::string& name);
+
+    /// Unmaps; the creator also unlinks the name
+    ~PcmRing();
+
+    PcmRing(const PcmRing&) = delete;
+    PcmRing& operator=(const PcmRing&) = delete;
+
+    uint32_t channels() const { return _header->channels; }
+    uint32_t capacity() const { return _header->capacity; }
+    uint32_t sampleRate() const { return _header->sampleRate; }
+    /// Planar samples of one channel (capacity values)
+    int16_t* channel(uint32_t index) const { return _samples + size_t(index) * capacity(); }
+
+    // ===== Producer =====
+    uint64_t written() const;
+    /// Frames that can be written without overwriting unplayed audio or history
+    size_t writable() const;
+    /// Publish frames written at written() .. written() + frames
+    void commit(size_t frames);
+    void setFlags(uint32_t flags);
+    uint32_t flags() const;
+
+    // ===== Audio reader =====
+    uint64_t played() const;
+    /// Frames written but not yet played
+    size_t playable() const;
+    void release(size_t frames);
+
+    // ===== Analysis readers =====
+    /// Claim a cursor at the current audio position; -1 if all are taken
+    int attach();
+    void detach(int reader);
+    /**
+     * @brief Frames the reader may read, from *position up to played()
+     *
+     * Skips the reader past frames the producer has overwritten.
+     */
+    size_t available(int reader, uint64_t* position);
+    void consume(int reader, size_t frames);
+    /// The frames at position.. are still intact (checked after reading them)
+    bool intact(uint64_t position) const;
+    /// Frames the reader has lost to the producer so far
+    uint64_t lapped(int reader) const;
+
+    /// Rewind every position for a new stream
+    void reset();
+
+private:
+    PcmRing(PcmRingHeader* header, size_t bytes, const std::string& name, bool owner);
+
+    PcmRingHeader* _header;
+    int16_t* _samples;
+    size_t _bytes;
+    std::string _name;
+    bool _owner;
+};
+
+#endif // PCMRING_H
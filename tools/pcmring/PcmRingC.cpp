@@ -0,0 +1,114 @@
+#include "PcmRingC.h"
+#include "PcmRing.h"
+
+#include <cstdio>
+#include <stdexcept>
+
+struct pcm_ring {
+    std::unique_ptr<PcmRing> ring;
+};
+
+static_assert(PCM_RING_END == PcmRing::END && PCM_RING_CANCEL == PcmRing::CANCEL,
+              "PCM_RING_* flags must match PcmRing");
+
+extern "C" {
+
+pcm_ring *pcm_ring_create(const char *name, uint32_t channels, uint32_t capacity,
+                          uint32_t sample_rate) {
+    try {
+        return new pcm_ring{PcmRing::create(name, channels, capacity, sample_rate)};
+    } catch (const std::exception& e) {
+        fprintf(stderr, "pcm_ring: %s\n", e.what());
+        return nullptr;
+    }
+}
+
+pcm_ring *pcm_ring_open(const char *name) {
+    try {
+        return new pcm_ring{PcmRing::open(name)};
+    } catch (const std::exception& e) {
+        fprintf(stderr, "pcm_ring: %s\n", e.what());
+        return nullptr;
+    }
+}
+
+void pcm_ring_close(pcm_ring *ring) {
+    delete ring;
+}
+
+uint32_t pcm_ring_channels(const pcm_ring *ring) {
+    return ring->ring->channels();
+}
+
+uint32_t pcm_ring_capacity(const pcm_ring *ring) {
+    return ring->ring->capacity();
+}
+
+uint32_t pcm_ring_sample_rate(const pcm_ring *ring) {
+    return ring->ring->sampleRate();
+}
+
+int16_t *pcm_ring_channel(const pcm_ring *ring, uint32_t index) {
+    return index < ring->ring->channels() ? ring->ring->channel(index) : nullptr;
+}
+
+uint64_t pcm_ring_written(const pcm_ring *ring) {
+    return ring->ring->written();
+}
+
+size_t pcm_ring_writable(const pcm_ring *ring) {
+    return ring->ring->writable();
+}
+
+void pcm_ring_commit(pcm_ring *ring, size_t frames) {
+    ring->ring->commit(frames);
+}
+
+void pcm_ring_set_flags(pcm_ring *ring, uint32_t flags) {
+    ring->ring->setFlags(flags);
+}
+
+uint32_t pcm_ring_flags(const pcm_ring *ring) {
+    return ring->ring->flags();
+}
+
+uint64_t pcm_ring_played(const pcm_ring *ring) {
+    return ring->ring->played();
+}
+
+size_t pcm_ring_playable(const pcm_ring *ring) {
+    return ring->ring->playable();
+}
+
+void pcm_ring_release(pcm_ring *ring, size_t frames) {
+    ring->ring->release(frames);
+}
+
+int pcm_ring_attach(pcm_ring *ring) {
+    return ring->ring->attach();
+}
+
+void pcm_ring_detach(pcm_ring *ring, int reader) {
+    ring->ring->detach(reader);
+}
+
+size_t pcm_ring_available(pcm_ring *ring, int reader, uint64_t *position) {
+    return ring->ring->available(reader, position);
+}
+
+void pcm_ring_consume(pcm_ring *ring, int reader, size_t frames) {
+    ring->ring->consume(reader, frames);
+}
+
+int pcm_ring_intact(const pcm_ring *ring, uint64_t position) {
+    return ring->ring->intact(position) ? 1 : 0;
+}
+
+uint64_t pcm_ring_lapped(const pcm_ring *ring, int reader) {
+    return ring->ring->lapped(reader);
+}
+
+void pcm_ring_reset(pcm_ring *ring) {
+    ring->ring->reset();
+}
+}
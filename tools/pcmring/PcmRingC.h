@@ -0,0 +1,58 @@
+#ifndef PCMRINGC_H
+#define PCMRINGC_H
+
+/**
+ * @file PcmRingC.h
+ * @brief C interface to PcmRing, loaded by the assistant with ctypes
+ *
+ * Samples are read and written in place through pcm_ring_channel(); these
+ * functions only move the positions (see PcmRing.h for who may call what).
+ * Create and open return NULL on failure.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct pcm_ring pcm_ring;
+
+#define PCM_RING_END 1
+#define PCM_RING_CANCEL 2
+
+pcm_ring *pcm_ring_create(const char *name, uint32_t channels, uint32_t capacity,
+                          uint32_t sample_rate);
+pcm_ring *pcm_ring_open(const char *name);
+void pcm_ring_close(pcm_ring *ring);
+
+uint32_t pcm_ring_channels(const pcm_ring *ring);
+uint32_t pcm_ring_capacity(const pcm_ring *ring);
+uint32_t pcm_ring_sample_rate(const pcm_ring *ring);
+int16_t *pcm_ring_channel(const pcm_ring *ring, uint32_t index);
+
+uint64_t pcm_ring_written(const pcm_ring *ring);
+size_t pcm_ring_writable(const pcm_ring *ring);
+void pcm_ring_commit(pcm_ring *ring, size_t frames);
+void pcm_ring_set_flags(pcm_ring *ring, uint32_t flags);
+uint32_t pcm_ring_flags(const pcm_ring *ring);
+
+uint64_t pcm_ring_played(const pcm_ring *ring);
+size_t pcm_ring_playable(const pcm_ring *ring);
+void pcm_ring_release(pcm_ring *ring, size_t frames);
+
+int pcm_ring_attach(pcm_ring *ring);
+void pcm_ring_detach(pcm_ring *ring, int reader);
+size_t pcm_ring_available(pcm_ring *ring, int reader, uint64_t *position);
+void pcm_ring_consume(pcm_ring *ring, int reader, size_t frames);
+int pcm_ring_intact(const pcm_ring *ring, uint64_t position);
+uint64_t pcm_ring_lapped(const pcm_ring *ring, int reader);
+
+void pcm_ring_reset(pcm_ring *ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PCMRINGC_H
@@ -0,0 +1,130 @@
+#include "StemIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+
+namespace {
+
+const int GAIN_SHIFT = 8;       // Gain in Q8: up to 127x without overflowing int32
+
+struct Level {
+    uint16_t rms;
+    uint16_t peak;
+};
+
+/*
+  RMS and peak of count frames from first, averaged over channels, scaled
+  by gainQ and clipped to int16. Kept branch-free per sample so the loops
+  vectorise.
+*/
+template <int Channels>
+Level measure(const int16_t* samples, size_t count, int32_t gainQ, int channels) {
+    const int shift = GAIN_SHIFT + (Channels == 2 ? 1 : 0);
+    int64_t sumSquares = 0;
+    int32_t peak = 0;
+    for (size_t i = 0; i < count; i++) {
+        int32_t sum;
+        if (Channels == 1) {
+            sum = samples[i];
+        } else if (Channels == 2) {
+            sum = int32_t(samples[2 * i]) + samples[2 * i + 1];
+        } else {
+            sum = 0;
+            for (int c = 0; c < channels; c++) sum += samples[i * channels + c];
+            sum /= channels;
+        }
+        int32_t s = (sum * gainQ) >> shift;
+        s = std::min(32767, std::max(-32768, s));
+        sumSquares += int64_t(s * s);
+        peak = std::max(peak, s < 0 ? -s : s);
+    }
+    Level level;
+    level.rms = count ? uint16_t(std::lround(std::sqrt(double(sumSquares) / count))) : 0;
+    level.peak = uint16_t(std::min(peak, 32767));
+    return level;
+}
+
+Level measureChunk(const MappedWav& wav, size_t chunk, size_t chunkFrames, int32_t gainQ) {
+    size_t first = chunk * chunkFrames;
+    if (first >= wav.frames()) {
+        return Level{0, 0};
+    }
+    size_t count = std::min(chunkFrames, wav.frames() - first);
+    const int16_t* samples = wav.data() + first * wav.channels();
+    switch (wav.channels()) {
+    case 1: return measure<1>(samples, count, gainQ, 1);
+    case 2: return measure<2>(samples, count, gainQ, 2);
+    default: return measure<0>(samples, count, gainQ, wav.channels());
+    }
+}
+
+size_t framesPerChunk(const MappedWav& wav, uint32_t chunkMs) {
+    return std::max<size_t>(1, size_t(wav.sampleRate()) * chunkMs / 1000);
+}
+
+} // namespace
+
+std::vector<StemLevels> analyzeStems(const MappedWav& vocals, const MappedWav& drums,
+                                     uint32_t chunkMs, float gain, const StemOnsetRule& onsets) {
+    if (!chunkMs) {
+        throw std::runtime_error("chunk length must be at least 1 ms");
+    }
+    const int32_t gainQ = int32_t(std::lround(std::clamp(gain, 0.0f, 127.0f) * (1 << GAIN_SHIFT)));
+    const size_t vocalFrames = framesPerChunk(vocals, chunkMs);
+    const size_t drumFrames = framesPerChunk(drums, chunkMs);
+    const size_t chunks = std::max((vocals.frames() + vocalFrames - 1) / vocalFrames,
+                                   (drums.frames() + drumFrames - 1) / drumFrames);
+
+    std::vector<StemLevels> levels(chunks);
+    uint32_t envelope = 0;      // Q8, as in LipSync
+    uint64_t lastOnsetMs = 0;
+    bool onsetSeen = false;
+    for (size_t i = 0; i < chunks; i++) {
+        Level voice = measureChunk(vocals, i, vocalFrames, gainQ);
+        Level drum = measureChunk(drums, i, drumFrames, gainQ);
+
+        StemLevels& level = levels[i];
+        level.vocalRms = voice.rms;
+        level.vocalPeak = voice.peak;
+        level.drumRms = drum.rms;
+
+        uint64_t nowMs = uint64_t(i) * chunkMs;
+        uint32_t drumLevel = uint32_t(drum.rms) << 8;
+        if (drum.rms > onsets.threshold &&
+            (uint64_t(drumLevel) << 4) > uint64_t(envelope) * onsets.ratio &&
+            (!onsetSeen || nowMs - lastOnsetMs >= onsets.gapMs)) {
+            level.flags |= STEM_DRUM_ONSET;
+            lastOnsetMs = nowMs;
+            onsetSeen = true;
+        }
+        if (drumLevel > envelope) {
+            envelope += (drumLevel - envelope) >> onsets.envelopeShift;
+        } else {
+            envelope -= (envelope - drumLevel) >> onsets.envelopeShift;
+        }
+    }
+    return levels;
+}
+
+void writeStemIndex(const std::string& path, uint32_t chunkMs, float gain,
+                    const std::vector<StemLevels>& levels) {
+    StemIndexHeader header;
+    header.chunkMs = uint16_t(chunkMs);
+    header.chunks = uint32_t(levels.size());
+    header.gain = gain;
+
+    // A reader never sees a half-written index
+    std::string temporary = path + ".tmp";
+    FILE* out = fopen(temporary.c_str(), "wb");
+    if (!out) {
+        throw std::runtime_error("cannot write " + temporary);
+    }
+    bool written = fwrite(&header, sizeof(header), 1, out) == 1 &&
+                   fwrite(levels.data(), sizeof(StemLevels), levels.size(), out) == levels.size();
+    if (fclose(out) != 0 || !written || rename(temporary.c_str(), path.c_str()) != 0) {
+        remove(temporary.c_str());
+        throw std::runtime_error("cannot write " + path);
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef STEMINDEX_H
+#define STEMINDEX_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MappedWav.h"
+
+/**
+ * @file StemIndex.h
+ * @brief Per-chunk levels of a song's vocal and drum stems, cached on disk
+ */
+
+/// StemLevels::flags
+enum StemLevelFlags : uint8_t {
+    STEM_DRUM_ONSET = 1     ///< The drums jump above their recent level in this chunk
+};
+
+/**
+ * @brief What song motion needs from one chunk of the stems
+ *
+ * Levels are in int16 units after the song's gain and clipping, as the
+ * live analysis in `play_song()` computes them.
+ */
+struct StemLevels {
+    uint16_t vocalRms = 0;
+    uint16_t vocalPeak = 0;
+    uint16_t drumRms = 0;
+    uint8_t flags = 0;      ///< StemLevelFlags
+    uint8_t reserved = 0;
+};
+static_assert(sizeof(StemLevels) == 8, "StemLevels is a file record");
+
+/**
+ * @brief Start of a `stems.idx` file, followed by `chunks` StemLevels
+ *
+ * Written in host byte order, little-endian on every target (Pi, x86).
+ * The assistant rebuilds the index when chunkMs or gain differ from its
+ * own, or when a stem or metadata.txt is newer than the file.
+ */
+struct StemIndexHeader {
+    static constexpr uint16_t VERSION = 1;
+
+    char magic[4] = {'B', 'S', 'I', 'X'};
+    uint16_t version = VERSION;
+    uint16_t chunkMs = 0;
+    uint32_t chunks = 0;
+    float gain = 1.0f;
+};
+static_assert(sizeof(StemIndexHeader) == 16, "StemIndexHeader is a file header");
+
+/**
+ * @brief Drum onset rule, LipSync's tail rule: a chunk above threshold and
+ *        ratio / 16 times the slow envelope of the chunks before it, at
+ *        most once per gap
+ */
+struct StemOnsetRule {
+    uint16_t threshold = 1500;      ///< Quietest drum RMS that can be an onset
+    uint8_t ratio = 32;             ///< RMS over envelope, in sixteenths
+    uint8_t envelopeShift = 3;      ///< Envelope moves 1 / 2^shift of the way per chunk
+    uint16_t gapMs = 250;           ///< Shortest time between two onsets
+};
+
+/**
+ * @brief Analyse both stems in one pass over their mappings
+ *
+ * Each chunk covers chunkMs of a stem at its own rate. Channels are
+ * averaged, the gain applied and the result clipped to int16 before the
+ * RMS and peak are taken; all of it is integer arithmetic the compiler
+ * vectorises. The shorter stem reads as silence past its end.
+ *
+ * @throws std::runtime_error if chunkMs is 0
+ */
+std::vector<StemLevels> analyzeStems(const MappedWav& vocals, const MappedWav& drums,
+                                     uint32_t chunkMs, float gain,
+                                     const StemOnsetRule& onsets = StemOnsetRule());
+
+/**
+ * @brief Write an index; replaces path atomically (write, then rename)
+ * @throws std::runtime_error if it cannot be written
+ */
+void writeStemIndex(const std::string& path, uint32_t chunkMs, float gain,
+                    const std::vector<StemLevels>& levels);
+
+#endif // STEMINDEX_H
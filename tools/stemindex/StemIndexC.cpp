@@ -0,0 +1,23 @@
+#include "StemIndexC.h"
+#include "StemIndex.h"
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+extern "C" {
+
+long stem_index_build(const char *song_dir, uint32_t chunk_ms, float gain) {
+    try {
+        std::string dir(song_dir);
+        MappedWav vocals(dir + "/vocals.wav");
+        MappedWav drums(dir + "/drums.wav");
+        std::vector<StemLevels> levels = analyzeStems(vocals, drums, chunk_ms, gain);
+        writeStemIndex(dir + "/stems.idx", chunk_ms, gain, levels);
+        return long(levels.size());
+    } catch (const std::exception& e) {
+        fprintf(stderr, "stemindex: %s\n", e.what());
+        return -1;
+    }
+}
+}
@@ -0,0 +1,29 @@
+#ifndef STEMINDEXC_H
+#define STEMINDEXC_H
+
+/**
+ * @file StemIndexC.h
+ * @brief C interface to the stem analyzer, loaded by the assistant with ctypes
+ *
+ * The assistant only builds indexes through this; it reads `stems.idx`
+ * itself (see StemIndexHeader and StemLevels for the layout).
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Analyse song_dir/vocals.wav and drums.wav into song_dir/stems.idx
+ *
+ * @return Chunks written, or -1 after printing the error to stderr
+ */
+long stem_index_build(const char *song_dir, uint32_t chunk_ms, float gain);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STEMINDEXC_H
@@ -0,0 +1,114 @@
+#include "MappedWav.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+uint32_t readU32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (uint32_t(p[3]) << 24);
+}
+
+uint16_t readU16(const uint8_t* p) {
+    return p[0] | (p[1] << 8);
+}
+
+} // namespace
+
+MappedWav::MappedWav(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("cannot open " + path + ": " + strerror(errno));
+    }
+    struct stat info;
+    bool stated = fstat(fd, &info) == 0;
+    if (stated && info.st_size == 0) {
+        close(fd);
+        throw std::runtime_error(path + ": empty file");   // mmap() cannot map 0 bytes
+    }
+    if (stated) {
+        _size = size_t(info.st_size);
+        _mapping = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    int error = errno;
+    close(fd);
+    if (!_mapping || _mapping == MAP_FAILED) {
+        _mapping = nullptr;
+        throw std::runtime_error("cannot map " + path + ": " + strerror(error));
+    }
+
+    try {
+        const uint8_t* file = static_cast<const uint8_t*>(_mapping);
+        if (_size < 12 || std::memcmp(file, "RIFF", 4) || std::memcmp(file + 8, "WAVE", 4)) {
+            throw std::runtime_error(path + ": not a RIFF/WAVE file");
+        }
+
+        // Walk the chunk list until the data chunk; fmt must come first
+        size_t at = 12;
+        while (at + 8 <= _size) {
+            const uint8_t* chunk = file + at;
+            size_t size = readU32(chunk + 4);
+            at += 8;
+
+            if (!std::memcmp(chunk, "fmt ", 4)) {
+                if (size < 16 || at + size > _size) {
+                    throw std::runtime_error(path + ": truncated fmt chunk");
+                }
+                uint16_t format = readU16(file + at);
+                _channels = readU16(file + at + 2);
+                _sampleRate = readU32(file + at + 4);
+                uint16_t bitsPerSample = readU16(file + at + 14);
+                if ((format != 1 && format != 0xFFFE) || bitsPerSample != 16 || _channels == 0) {
+                    throw std::runtime_error(path + ": only 16-bit PCM is supported");
+                }
+            } else if (!std::memcmp(chunk, "data", 4)) {
+                if (!_channels) throw std::runtime_error(path + ": data before fmt chunk");
+                if (at % alignof(int16_t)) throw std::runtime_error(path + ": misaligned data chunk");
+                size = std::min(size, _size - at);
+                _data = reinterpret_cast<const int16_t*>(file + at);
+                _frames = size / (sizeof(int16_t) * _channels);
+                madvise(_mapping, _size, MADV_SEQUENTIAL);
+                return;
+            }
+            at += size + (size & 1);
+        }
+        throw std::runtime_error(path + ": no data chunk");
+    } catch (...) {
+        munmap(_mapping, _size);
+        throw;
+    }
+}
+
+MappedWav::~MappedWav() {
+    munmap(_mapping, _size);
+}
+
+WavView MappedWav::chunk(size_t first, size_t frames) const {
+    WavView view;
+    view.channels = _channels;
+    view.sampleRate = _sampleRate;
+    if (first < _frames) {
+        view.samples = _data + first * _channels;
+        view.frames = std::min(frames, _frames - first);
+    }
+    return view;
+}
+
+void MappedWav::prefetch(size_t first, size_t frames) const {
+    WavView view = chunk(first, frames);
+    if (!view.frames) {
+        return;
+    }
+    // madvise() wants a page-aligned start
+    static const uintptr_t page = uintptr_t(sysconf(_SC_PAGESIZE));
+    uintptr_t begin = reinterpret_cast<uintptr_t>(view.samples);
+    uintptr_t end = begin + view.frames * _channels * sizeof(int16_t);
+    begin &= ~(page - 1);
+    madvise(reinterpret_cast<void*>(begin), end - begin, MADV_WILLNEED);
+}
@@ -0,0 +1,73 @@
+#ifndef MAPPEDWAV_H
+#define MAPPEDWAV_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @file MappedWav.h
+ * @brief 16-bit PCM WAV file mapped read-only into memory
+ */
+
+/**
+ * @brief Read-only window onto consecutive frames of a MappedWav
+ *
+ * Points into the mapping, so it stays valid only while the MappedWav does.
+ */
+struct WavView {
+    const int16_t* samples = nullptr;   ///< Interleaved, channels per frame
+    size_t frames = 0;
+    uint16_t channels = 0;
+    uint32_t sampleRate = 0;
+};
+
+/**
+ * @brief A WAV file whose samples are read straight from the page cache
+ *
+ * The RIFF header is validated once when the file is opened; after that the
+ * interleaved int16 samples are a plain pointer into the mapping, so reading
+ * a stem costs no copies and no allocations, and the kernel loads pages as
+ * they are touched. Only 16-bit PCM (WAVE_FORMAT_PCM or EXTENSIBLE) is
+ * accepted; a data chunk cut short by the end of the file is trimmed to the
+ * whole frames present.
+ *
+ * The mapping is advised as sequential, so the kernel reads ahead
+ * aggressively and drops pages behind the reader; prefetch() asks for a
+ * range before it is needed, for example the next second of a song.
+ */
+class MappedWav {
+public:
+    /**
+     * @param path File to map
+     * @throws std::runtime_error if it cannot be mapped or is not 16-bit PCM
+     */
+    explicit MappedWav(const std::string& path);
+    ~MappedWav();
+
+    MappedWav(const MappedWav&) = delete;
+    MappedWav& operator=(const MappedWav&) = delete;
+
+    uint32_t sampleRate() const { return _sampleRate; }
+    uint16_t channels() const { return _channels; }
+    /// Frames of channels() interleaved samples each
+    size_t frames() const { return _frames; }
+    /// First sample of frame 0; frame n starts at data() + n * channels()
+    const int16_t* data() const { return _data; }
+
+    /// Up to frames frames from first, fewer at the end of the file; no copy
+    WavView chunk(size_t first, size_t frames) const;
+
+    /// Start reading a range of frames into the page cache without waiting
+    void prefetch(size_t first, size_t frames) const;
+
+private:
+    void* _mapping = nullptr;
+    size_t _size = 0;
+    const int16_t* _data = nullptr;
+    size_t _frames = 0;
+    uint32_t _sampleRate = 0;
+    uint16_t _channels = 0;
+};
+
+#endif // MAPPEDWAV_H
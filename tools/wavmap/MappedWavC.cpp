@@ -0,0 +1,46 @@
+#include "MappedWavC.h"
+#include "MappedWav.h"
+
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+
+struct wavmap {
+    std::unique_ptr<MappedWav> wav;
+};
+
+extern "C" {
+
+wavmap *wavmap_open(const char *path) {
+    try {
+        return new wavmap{std::make_unique<MappedWav>(path)};
+    } catch (const std::exception& e) {
+        fprintf(stderr, "wavmap: %s\n", e.what());
+        return nullptr;
+    }
+}
+
+void wavmap_close(wavmap *map) {
+    delete map;
+}
+
+uint32_t wavmap_sample_rate(const wavmap *map) {
+    return map->wav->sampleRate();
+}
+
+uint16_t wavmap_channels(const wavmap *map) {
+    return map->wav->channels();
+}
+
+uint64_t wavmap_frames(const wavmap *map) {
+    return map->wav->frames();
+}
+
+const int16_t *wavmap_data(const wavmap *map) {
+    return map->wav->data();
+}
+
+void wavmap_prefetch(const wavmap *map, uint64_t first, uint64_t frames) {
+    map->wav->prefetch(size_t(first), size_t(frames));
+}
+}
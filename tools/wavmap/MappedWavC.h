@@ -0,0 +1,38 @@
+#ifndef MAPPEDWAVC_H
+#define MAPPEDWAVC_H
+
+/**
+ * @file MappedWavC.h
+ * @brief C interface to MappedWav, loaded by the assistant with ctypes
+ *
+ * The samples are exposed as one read-only pointer for the whole file;
+ * callers take chunk views of it themselves (numpy slices in Python).
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct wavmap wavmap;
+
+/// NULL after printing the error to stderr
+wavmap *wavmap_open(const char *path);
+void wavmap_close(wavmap *map);
+
+uint32_t wavmap_sample_rate(const wavmap *map);
+uint16_t wavmap_channels(const wavmap *map);
+uint64_t wavmap_frames(const wavmap *map);
+/// Interleaved samples of every frame; valid until wavmap_close()
+const int16_t *wavmap_data(const wavmap *map);
+
+/// Start reading frames [first, first + frames) into the page cache
+void wavmap_prefetch(const wavmap *map, uint64_t first, uint64_t frames);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MAPPEDWAVC_H